@@ -0,0 +1,209 @@
+#include "ns3/boids-checkpoint.h"
+#include "ns3/boids-fire-registry.h"
+#include "ns3/boids-mobility-model.h"
+#include "ns3/node-container.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+namespace
+{
+
+const uint32_t N_BOIDS = 24;
+const uint32_t N_LEADERS = 3;
+
+// Estado comparado al final de cada ejecución
+struct FlockSnapshot
+{
+    std::vector<Vector> positions; // Por nodo
+    std::vector<bool> leaders;
+    std::vector<uint32_t> fireIds; // En el orden del registro
+    std::vector<Vector> firePositions;
+    uint32_t extinguished = 0;
+};
+
+// Los uid de los eventos pendientes solo ordenan los del mismo instante y cambian
+// de una ejecución a otra: se sustituyen por su posición en ese orden
+std::vector<char>
+ReadCheckpoint(const std::string& path)
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    std::vector<char> bytes{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    if (bytes.size() < sizeof(BoidsCheckpointHeader))
+    {
+        return bytes;
+    }
+    BoidsCheckpointHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    std::vector<BoidsCheckpointEvent*> events = {&header.tick,
+                                                 &header.fire,
+                                                 &header.checkFire,
+                                                 &header.assign};
+    std::vector<uint32_t> uids;
+    for (const BoidsCheckpointEvent* event : events)
+    {
+        uids.push_back(event->uid);
+    }
+    std::sort(uids.begin(), uids.end());
+    for (BoidsCheckpointEvent* event : events)
+    {
+        event->uid = std::lower_bound(uids.begin(), uids.end(), event->uid) - uids.begin();
+    }
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    return bytes;
+}
+
+} // namespace
+
+/**
+ * Una ejecución guarda un checkpoint a los 4 s y sigue hasta los 10 s; otra crea
+ * los mismos nodos, restaura ese checkpoint y sigue hasta el mismo instante. El
+ * checkpoint que ambas guardan a los 9 s, después de la segunda tanda de fuegos,
+ * debe ser idéntico byte a byte salvo los uid de los eventos (estado de cada boid,
+ * clusters, fuegos y valores sorteados por cada generador), y al final deben
+ * coincidir las posiciones, los líderes y los fuegos con sus ids.
+ */
+class BoidsCheckpointRoundTripTestCase : public TestCase
+{
+  public:
+    BoidsCheckpointRoundTripTestCase();
+
+  private:
+    void DoRun() override;
+    // Sin restoreFrom arranca los fuegos desde cero
+    void RunFlock(const std::string& restoreFrom,
+                  const std::vector<std::pair<Time, std::string>>& saves,
+                  FlockSnapshot& snapshot);
+};
+
+BoidsCheckpointRoundTripTestCase::BoidsCheckpointRoundTripTestCase()
+    : TestCase("Continuar desde un checkpoint repite la ejecución sin interrumpir")
+{
+}
+
+void
+BoidsCheckpointRoundTripTestCase::RunFlock(const std::string& restoreFrom,
+                                           const std::vector<std::pair<Time, std::string>>& saves,
+                                           FlockSnapshot& snapshot)
+{
+    // Mismos nodos (NodeId), posiciones y streams en las dos ejecuciones: tres
+    // grupos de ocho boids con un líder cada uno
+    NodeContainer nodes;
+    NodeContainer leaders;
+    nodes.Create(N_BOIDS);
+    for (uint32_t i = 0; i < N_BOIDS; ++i)
+    {
+        Ptr<BoidsMobilityModel> model = CreateObject<BoidsMobilityModel>();
+        nodes.Get(i)->AggregateObject(model);
+        uint32_t group = i % N_LEADERS;
+        uint32_t k = i / N_LEADERS;
+        model->SetPosition(Vector(200.0 + 300.0 * group + 12.0 * (k % 3),
+                                  300.0 + 150.0 * group + 12.0 * (k / 3),
+                                  0.0));
+        model->AssignStreams(10 + 2 * i);
+        if (i < N_LEADERS)
+        {
+            model->SetIsLeader(true);
+            leaders.Add(nodes.Get(i));
+        }
+    }
+    BoidsMobilityModel::AssignFireStreams(1000);
+    BoidsMobilityModel::SetClusters(leaders, std::vector<NodeContainer>(leaders.GetN()));
+
+    if (restoreFrom.empty())
+    {
+        BoidsMobilityModel::AddRandomFire();
+        BoidsMobilityModel::CheckFireProximity();
+        Simulator::ScheduleNow(&BoidsMobilityModel::AssignFiresToLeaders);
+    }
+    else
+    {
+        NS_TEST_ASSERT_MSG_EQ(BoidsCheckpoint::Restore(restoreFrom), true, "restaurar");
+    }
+    for (const auto& [at, path] : saves)
+    {
+        BoidsCheckpoint::Schedule(at, path);
+    }
+    Simulator::Stop(Seconds(10));
+    Simulator::Run();
+
+    for (uint32_t i = 0; i < N_BOIDS; ++i)
+    {
+        Ptr<BoidsMobilityModel> model = nodes.Get(i)->GetObject<BoidsMobilityModel>();
+        snapshot.positions.push_back(model->GetPosition());
+        snapshot.leaders.push_back(model->IsLeader());
+    }
+    for (const BoidsFire& fire : BoidsMobilityModel::GetFireRegistry())
+    {
+        snapshot.fireIds.push_back(fire.id);
+        snapshot.firePositions.push_back(fire.position);
+    }
+    snapshot.extinguished = BoidsMobilityModel::s_totalFiresExtinguished;
+
+    Simulator::Destroy();
+    BoidsMobilityModel::ResetSharedState();
+}
+
+void
+BoidsCheckpointRoundTripTestCase::DoRun()
+{
+    std::string warm = CreateTempDirFilename("boids-checkpoint-warm.bin");
+    std::string original = CreateTempDirFilename("boids-checkpoint-original.bin");
+    std::string restored = CreateTempDirFilename("boids-checkpoint-restored.bin");
+
+    // A los 4 s coinciden un tick y una asignación: los eventos restaurados deben
+    // ejecutarse en el mismo orden
+    FlockSnapshot a;
+    RunFlock("", {{Seconds(4), warm}, {Seconds(9), original}}, a);
+    FlockSnapshot b;
+    RunFlock(warm, {{Seconds(9), restored}}, b);
+
+    std::vector<char> originalBytes = ReadCheckpoint(original);
+    std::vector<char> restoredBytes = ReadCheckpoint(restored);
+    NS_TEST_ASSERT_MSG_GT(originalBytes.size(), 0, "checkpoint de la ejecución original");
+    NS_TEST_ASSERT_MSG_EQ(restoredBytes.size(), originalBytes.size(), "tamaño del checkpoint");
+    NS_TEST_ASSERT_MSG_EQ((restoredBytes == originalBytes),
+                          true,
+                          "checkpoint a los 9 s idéntico al de la ejecución sin interrumpir");
+
+    NS_TEST_ASSERT_MSG_GT(a.fireIds.size() + a.extinguished, 0, "la ejecución tiene fuegos");
+    for (uint32_t i = 0; i < N_BOIDS; ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(b.positions[i].x, a.positions[i].x, "x del boid " << i);
+        NS_TEST_ASSERT_MSG_EQ(b.positions[i].y, a.positions[i].y, "y del boid " << i);
+        NS_TEST_ASSERT_MSG_EQ(b.leaders[i], a.leaders[i], "liderazgo del boid " << i);
+    }
+    NS_TEST_ASSERT_MSG_EQ(b.fireIds.size(), a.fireIds.size(), "fuegos activos");
+    for (uint32_t f = 0; f < a.fireIds.size() && f < b.fireIds.size(); ++f)
+    {
+        NS_TEST_ASSERT_MSG_EQ(b.fireIds[f], a.fireIds[f], "id del fuego " << f);
+        NS_TEST_ASSERT_MSG_EQ(b.firePositions[f].x, a.firePositions[f].x, "x del fuego " << f);
+        NS_TEST_ASSERT_MSG_EQ(b.firePositions[f].y, a.firePositions[f].y, "y del fuego " << f);
+    }
+    NS_TEST_ASSERT_MSG_EQ(b.extinguished, a.extinguished, "fuegos apagados");
+}
+
+/**
+ * Pruebas de BoidsCheckpoint.
+ */
+class BoidsCheckpointTestSuite : public TestSuite
+{
+  public:
+    BoidsCheckpointTestSuite();
+};
+
+BoidsCheckpointTestSuite::BoidsCheckpointTestSuite()
+    : TestSuite("boids-checkpoint", Type::UNIT)
+{
+    AddTestCase(new BoidsCheckpointRoundTripTestCase, TestCase::Duration::QUICK);
+}
+
+static BoidsCheckpointTestSuite g_boidsCheckpointTestSuite;
@@ -0,0 +1,446 @@
+#include "boids-checkpoint.h"
+
+#include "boids-flock-controller.h"
+#include "boids-mobility-model.h"
+
+#include "ns3/log.h"
+#include "ns3/node-list.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+NS_LOG_COMPONENT_DEFINE("BoidsCheckpoint");
+
+namespace ns3
+{
+
+BoidsCheckpointHeader BoidsCheckpoint::s_header;
+std::vector<BoidsCheckpointBoid> BoidsCheckpoint::s_boids;
+std::vector<uint32_t> BoidsCheckpoint::s_clusterWords;
+std::vector<BoidsCheckpointFire> BoidsCheckpoint::s_fires;
+
+namespace
+{
+
+BoidsCheckpointEvent
+SavePending(const EventId& event)
+{
+    BoidsCheckpointEvent saved;
+    saved.delayNs = event.IsPending() ? Simulator::GetDelayLeft(event).GetNanoSeconds() : -1;
+    saved.uid = event.GetUid();
+    saved.reserved = 0;
+    return saved;
+}
+
+template <typename T>
+BoidsCheckpointRng
+SaveRng(const BoidsCountedRng<T>& rng)
+{
+    BoidsCheckpointRng saved;
+    saved.stream = rng.GetStream();
+    saved.draws = rng.GetDraws();
+    return saved;
+}
+
+template <typename T>
+void
+RestoreRng(BoidsCountedRng<T>& rng, const BoidsCheckpointRng& saved)
+{
+    if (saved.stream >= 0)
+    {
+        rng.Seek(saved.stream, saved.draws);
+    }
+}
+
+Ptr<BoidsMobilityModel>
+GetBoidsModel(uint32_t nodeId)
+{
+    if (nodeId >= NodeList::GetNNodes())
+    {
+        return nullptr;
+    }
+    return NodeList::GetNode(nodeId)->GetObject<BoidsMobilityModel>();
+}
+
+} // namespace
+
+void
+BoidsCheckpoint::SaveBoid(const BoidsMobilityModel* boid, BoidsCheckpointBoid& r)
+{
+    const BoidsFlockState& state = boid->m_controller->GetState();
+    const uint32_t i = boid->m_boidIndex;
+    std::memset(&r, 0, sizeof(r));
+    r.nodeId = boid->GetBoidsNode()->GetId();
+    r.isLeader = state.leader[i];
+    r.stateCluster = state.cluster[i];
+    r.x = state.x[i];
+    r.y = state.y[i];
+    r.vx = state.vx[i];
+    r.vy = state.vy[i];
+    r.targetX = boid->m_target.x;
+    r.targetY = boid->m_target.y;
+    r.lastX = boid->m_lastPosition.x;
+    r.lastY = boid->m_lastPosition.y;
+    r.energy = boid->m_energy;
+    r.degree = boid->m_degree;
+    r.distanceToTargets = boid->m_distanceToTargets;
+    r.mobility = boid->m_mobility;
+    r.wcaScore = boid->m_wcaScore;
+    r.separationRadius = boid->m_separationRadius;
+    r.alignmentRadius = boid->m_alignmentRadius;
+    r.cohesionRadius = boid->m_cohesionRadius;
+    r.leaderInfluenceRadius = boid->m_leaderInfluenceRadius;
+    r.maxSpeed = boid->m_maxSpeed;
+    r.lastMetricsTick = boid->m_lastMetricsTick;
+    r.rng = SaveRng(boid->m_rng);
+    r.energyRng = SaveRng(boid->m_energyRng);
+}
+
+void
+BoidsCheckpoint::ApplyBoid(BoidsMobilityModel* boid, const BoidsCheckpointBoid& r, bool restoreRngs)
+{
+    Ptr<BoidsFlockController> flock = boid->m_controller;
+    BoidsFlockState& state = flock->GetState();
+    const uint32_t i = boid->m_boidIndex;
+    state.leader[i] = r.isLeader;
+    state.cluster[i] = r.stateCluster;
+    state.x[i] = r.x;
+    state.y[i] = r.y;
+    state.vx[i] = r.vx;
+    state.vy[i] = r.vy;
+    flock->NotifyPositionChanged(i, Vector(r.x, r.y, 0));
+    flock->InvalidateFireContact(i);
+    boid->m_target = Vector(r.targetX, r.targetY, 0);
+    boid->m_assignedFire = BoidsFireRegistry::INVALID; // Se repone desde los fuegos
+    boid->m_lastPosition = Vector(r.lastX, r.lastY, 0);
+    boid->m_energy = r.energy;
+    boid->m_degree = r.degree;
+    boid->m_distanceToTargets = r.distanceToTargets;
+    boid->m_mobility = r.mobility;
+    boid->m_wcaScore = r.wcaScore;
+    boid->m_separationRadius = r.separationRadius;
+    boid->m_alignmentRadius = r.alignmentRadius;
+    boid->m_cohesionRadius = r.cohesionRadius;
+    boid->m_leaderInfluenceRadius = r.leaderInfluenceRadius;
+    boid->m_maxSpeed = r.maxSpeed;
+    boid->m_lastMetricsTick = r.lastMetricsTick;
+    if (restoreRngs)
+    {
+        RestoreRng(boid->m_rng, r.rng);
+        RestoreRng(boid->m_energyRng, r.energyRng);
+    }
+}
+
+bool
+BoidsCheckpoint::Save(const std::string& path)
+{
+    Ptr<BoidsFlockController> flock = BoidsFlockController::Get();
+    NS_ASSERT_MSG(!flock->m_inTick, "No se puede guardar un checkpoint en mitad de un tick");
+    if (flock->GetPartition())
+    {
+        // Cada rango solo tiene su franja
+        NS_LOG_WARN("Checkpoint no disponible con la bandada repartida entre rangos");
+        return false;
+    }
+    BoidsCheckpointHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, BOIDS_CHECKPOINT_MAGIC, sizeof(header.magic));
+    header.version = BOIDS_CHECKPOINT_VERSION;
+    header.nBoids = flock->GetNBoids();
+    header.timeNs = Simulator::Now().GetNanoSeconds();
+    header.tickCount = flock->m_tickCount;
+    header.electionCount = flock->m_electionCount;
+    header.tick = SavePending(flock->m_tickEvent);
+    header.fire = SavePending(BoidsMobilityModel::s_fireEvent);
+    header.checkFire = SavePending(BoidsMobilityModel::s_checkFireEvent);
+    header.assign = SavePending(BoidsMobilityModel::s_assignEvent);
+    header.fireRng = SaveRng(BoidsMobilityModel::s_fireRng);
+    header.fireOffsetRng = SaveRng(BoidsMobilityModel::s_fireOffsetRng);
+    header.totalExtinguished = BoidsMobilityModel::s_totalFiresExtinguished;
+    header.fireTimelineCursor = BoidsMobilityModel::s_fireTimelineCursor;
+    header.totalExtinctionNs = BoidsMobilityModel::s_totalExtinctionTime.GetNanoSeconds();
+
+    std::vector<BoidsCheckpointBoid> boids(header.nBoids);
+    for (uint32_t i = 0; i < header.nBoids; ++i)
+    {
+        SaveBoid(flock->GetBoid(i), boids[i]);
+    }
+
+    const BoidsClusterTable& table = BoidsMobilityModel::s_clusterTable;
+    std::vector<uint32_t> clusterWords;
+    header.nClusters = table.GetNClusters();
+    for (uint32_t c = 0; c < header.nClusters; ++c)
+    {
+        clusterWords.push_back(table.GetHead(c)->GetId());
+        clusterWords.push_back(table.GetClusterSize(c));
+        for (const Ptr<Node>& member : table.GetMembers(c))
+        {
+            clusterWords.push_back(member->GetId());
+        }
+    }
+    header.nClusterWords = clusterWords.size();
+
+    // En el orden denso del registro, para que las búsquedas desempaten igual
+    const BoidsFireRegistry& registry = BoidsMobilityModel::s_fireRegistry;
+    std::vector<BoidsCheckpointFire> fires;
+    for (const BoidsFire& fire : registry)
+    {
+        BoidsCheckpointFire r;
+        r.id = fire.id;
+        r.assignedLeader = fire.assignedLeader;
+        r.x = fire.position.x;
+        r.y = fire.position.y;
+        r.startNs = fire.startTime.GetNanoSeconds();
+        fires.push_back(r);
+    }
+    header.nFires = fires.size();
+    header.nextFireId = registry.GetNextId();
+
+    std::ofstream file(path, std::ios::out | std::ios::binary);
+    if (!file.is_open())
+    {
+        NS_LOG_WARN("No se pudo abrir " << path);
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(boids.data()),
+               boids.size() * sizeof(BoidsCheckpointBoid));
+    file.write(reinterpret_cast<const char*>(clusterWords.data()),
+               clusterWords.size() * sizeof(uint32_t));
+    file.write(reinterpret_cast<const char*>(fires.data()),
+               fires.size() * sizeof(BoidsCheckpointFire));
+    file.close();
+    if (file.fail())
+    {
+        NS_LOG_WARN("Error al escribir " << path);
+        return false;
+    }
+    NS_LOG_INFO("Checkpoint en " << Simulator::Now().GetSeconds() << " s: " << header.nBoids
+                                 << " boids, " << header.nFires << " fuegos -> " << path);
+    return true;
+}
+
+void
+BoidsCheckpoint::SaveEvent(std::string path)
+{
+    if (!Save(path))
+    {
+        NS_LOG_WARN("Checkpoint no guardado en " << Simulator::Now().GetSeconds() << " s");
+    }
+}
+
+void
+BoidsCheckpoint::Schedule(Time at, const std::string& path)
+{
+    Simulator::Schedule(at - Simulator::Now(), &BoidsCheckpoint::SaveEvent, path);
+}
+
+bool
+BoidsCheckpoint::Restore(const std::string& path)
+{
+    if (BoidsFlockController::Get()->GetPartition())
+    {
+        NS_LOG_WARN("Checkpoint no disponible con la bandada repartida entre rangos");
+        return false;
+    }
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file.is_open())
+    {
+        NS_LOG_WARN("No se pudo abrir " << path);
+        return false;
+    }
+    BoidsCheckpointHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || std::memcmp(header.magic, BOIDS_CHECKPOINT_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != BOIDS_CHECKPOINT_VERSION)
+    {
+        NS_LOG_WARN(path << " no es un checkpoint de boids (versión " << BOIDS_CHECKPOINT_VERSION
+                         << ")");
+        return false;
+    }
+
+    std::vector<BoidsCheckpointBoid> boids(header.nBoids);
+    std::vector<uint32_t> clusterWords(header.nClusterWords);
+    std::vector<BoidsCheckpointFire> fires(header.nFires);
+    file.read(reinterpret_cast<char*>(boids.data()), boids.size() * sizeof(BoidsCheckpointBoid));
+    file.read(reinterpret_cast<char*>(clusterWords.data()),
+              clusterWords.size() * sizeof(uint32_t));
+    file.read(reinterpret_cast<char*>(fires.data()), fires.size() * sizeof(BoidsCheckpointFire));
+    if (!file)
+    {
+        NS_LOG_WARN(path << " está truncado");
+        return false;
+    }
+
+    Ptr<BoidsFlockController> flock = BoidsFlockController::Get();
+    if (flock->GetNBoids() != header.nBoids)
+    {
+        NS_LOG_WARN("El checkpoint tiene " << header.nBoids << " boids y la simulación "
+                                           << flock->GetNBoids());
+        return false;
+    }
+    bool fixedStreams = header.fireRng.stream >= 0 || header.fireRng.draws == 0;
+    for (const BoidsCheckpointBoid& r : boids)
+    {
+        if (!GetBoidsModel(r.nodeId))
+        {
+            NS_LOG_WARN("El nodo " << r.nodeId << " no tiene BoidsMobilityModel");
+            return false;
+        }
+        fixedStreams = fixedStreams && r.rng.stream >= 0 && r.energyRng.stream >= 0;
+    }
+    for (uint32_t w = 0, c = 0; c < header.nClusters; ++c)
+    {
+        if (w + 2 > clusterWords.size() || w + 2 + clusterWords[w + 1] > clusterWords.size() ||
+            !GetBoidsModel(clusterWords[w]))
+        {
+            NS_LOG_WARN(path << ": sección de clusters inválida");
+            return false;
+        }
+        w += 2 + clusterWords[w + 1];
+    }
+    if (!fixedStreams)
+    {
+        NS_LOG_WARN("Hay generadores sin stream fijo (AssignStreams): la continuación no "
+                    "repetirá la ejecución original");
+    }
+
+    s_header = header;
+    s_boids = std::move(boids);
+    s_clusterWords = std::move(clusterWords);
+    s_fires = std::move(fires);
+
+    // Nada avanza hasta el instante guardado
+    flock->DeferStart();
+    Simulator::Schedule(NanoSeconds(header.timeNs) - Simulator::Now(), &BoidsCheckpoint::Apply);
+    return true;
+}
+
+Time
+BoidsCheckpoint::GetRestoredTime()
+{
+    return NanoSeconds(s_header.timeNs);
+}
+
+void
+BoidsCheckpoint::Apply()
+{
+    Ptr<BoidsFlockController> flock = BoidsFlockController::Get();
+    flock->m_tickCount = s_header.tickCount;
+    flock->m_stepCount = s_header.tickCount;
+    flock->m_electionCount = s_header.electionCount;
+
+    for (const BoidsCheckpointBoid& r : s_boids)
+    {
+        ApplyBoid(PeekPointer(GetBoidsModel(r.nodeId)), r, true);
+    }
+
+    BoidsClusterTable& table = BoidsMobilityModel::s_clusterTable;
+    NodeContainer heads;
+    for (uint32_t w = 0, c = 0; c < s_header.nClusters; ++c)
+    {
+        heads.Add(NodeList::GetNode(s_clusterWords[w]));
+        w += 2 + s_clusterWords[w + 1];
+    }
+    table.Clear();
+    if (s_header.nClusters > 0)
+    {
+        table.SetClusterHeads(heads);
+    }
+    for (uint32_t w = 0, c = 0; c < s_header.nClusters; ++c)
+    {
+        uint32_t size = s_clusterWords[w + 1];
+        for (uint32_t m = 0; m < size; ++m)
+        {
+            table.Assign(NodeList::GetNode(s_clusterWords[w + 2 + m]), c);
+        }
+        w += 2 + size;
+    }
+
+    BoidsFireRegistry& registry = BoidsMobilityModel::s_fireRegistry;
+    registry.Clear();
+    for (const BoidsCheckpointFire& r : s_fires)
+    {
+        BoidsFire fire;
+        fire.id = r.id;
+        fire.position = Vector(r.x, r.y, 0);
+        fire.startTime = NanoSeconds(r.startNs);
+        fire.assignedLeader = r.assignedLeader;
+        registry.Insert(fire);
+        if (Ptr<BoidsMobilityModel> leader = GetBoidsModel(fire.assignedLeader))
+        {
+            leader->m_assignedFire = fire.id;
+        }
+    }
+    registry.SetNextId(s_header.nextFireId);
+    BoidsMobilityModel::s_fireAssigner.Invalidate();
+    BoidsMobilityModel::s_totalFiresExtinguished = s_header.totalExtinguished;
+    BoidsMobilityModel::s_fireTimelineCursor = s_header.fireTimelineCursor;
+    if (s_header.fireTimelineCursor > 0 &&
+        (!BoidsMobilityModel::s_fireTimeline ||
+         BoidsMobilityModel::s_fireTimeline->GetSize() < s_header.fireTimelineCursor))
+    {
+        NS_LOG_WARN("El checkpoint repetía una línea temporal de fuegos distinta de la actual");
+    }
+    BoidsMobilityModel::s_totalExtinctionTime = NanoSeconds(s_header.totalExtinctionNs);
+    BoidsMobilityModel::CreateFireRngs();
+    RestoreRng(BoidsMobilityModel::s_fireRng, s_header.fireRng);
+    RestoreRng(BoidsMobilityModel::s_fireOffsetRng, s_header.fireOffsetRng);
+
+    // Reprogramar los eventos pendientes en su orden original (instante y uid)
+    enum Kind
+    {
+        TICK,
+        FIRE,
+        CHECK_FIRE,
+        ASSIGN
+    };
+
+    std::vector<std::pair<BoidsCheckpointEvent, Kind>> events = {{s_header.tick, TICK},
+                                                                 {s_header.fire, FIRE},
+                                                                 {s_header.checkFire, CHECK_FIRE},
+                                                                 {s_header.assign, ASSIGN}};
+    std::sort(events.begin(), events.end(), [](const auto& a, const auto& b) {
+        return a.first.delayNs != b.first.delayNs ? a.first.delayNs < b.first.delayNs
+                                                  : a.first.uid < b.first.uid;
+    });
+    flock->m_startDeferred = false;
+    for (const auto& [event, kind] : events)
+    {
+        if (event.delayNs < 0)
+        {
+            continue;
+        }
+        Time delay = NanoSeconds(event.delayNs);
+        switch (kind)
+        {
+        case TICK:
+            flock->StartAt(delay);
+            break;
+        case FIRE:
+            BoidsMobilityModel::s_fireEvent =
+                Simulator::Schedule(delay, &BoidsMobilityModel::AddRandomFire);
+            break;
+        case CHECK_FIRE:
+            BoidsMobilityModel::s_checkFireEvent =
+                Simulator::Schedule(delay, &BoidsMobilityModel::CheckFireProximity);
+            break;
+        case ASSIGN:
+            BoidsMobilityModel::s_assignEvent =
+                Simulator::Schedule(delay, &BoidsMobilityModel::AssignFiresToLeaders);
+            break;
+        }
+    }
+
+    NS_LOG_INFO("Checkpoint restaurado en " << Simulator::Now().GetSeconds() << " s: "
+                                            << s_boids.size() << " boids, " << s_fires.size()
+                                            << " fuegos");
+    s_boids.clear();
+    s_clusterWords.clear();
+    s_fires.clear();
+}
+
+} // namespace ns3
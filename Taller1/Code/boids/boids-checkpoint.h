@@ -0,0 +1,173 @@
+#ifndef BOIDS_CHECKPOINT_H
+#define BOIDS_CHECKPOINT_H
+
+#include "ns3/nstime.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+class BoidsMobilityModel;
+
+/**
+ * Formato binario de un checkpoint (little-endian).
+ *
+ *   cabecera | registro por boid | clusters | registro por fuego
+ *
+ * Los clusters se guardan como enteros de 32 bits: por cluster el NodeId del
+ * Cluster-Head, el número de miembros y sus NodeId en orden.
+ */
+static const char BOIDS_CHECKPOINT_MAGIC[8] = {'B', 'O', 'I', 'D', 'S', 'C', 'K', '1'};
+static const uint32_t BOIDS_CHECKPOINT_VERSION = 2;
+
+// Evento periódico pendiente: retardo desde el instante del checkpoint (-1 si no hay)
+struct BoidsCheckpointEvent
+{
+    int64_t delayNs;
+    uint32_t uid; // Orden de ejecución entre eventos del mismo instante
+    uint32_t reserved;
+};
+
+// Posición de un generador aleatorio: stream fijo y valores ya sorteados
+struct BoidsCheckpointRng
+{
+    int64_t stream; // -1 si el stream lo asignó ns-3 (no se puede restaurar)
+    uint64_t draws;
+};
+
+struct BoidsCheckpointHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t nBoids;
+    int64_t timeNs;
+    uint64_t tickCount;
+    uint64_t electionCount;
+    BoidsCheckpointEvent tick;
+    BoidsCheckpointEvent fire;
+    BoidsCheckpointEvent checkFire;
+    BoidsCheckpointEvent assign;
+    uint32_t nClusters;
+    uint32_t nClusterWords; // Enteros de la sección de clusters
+    uint32_t nFires;
+    uint32_t nextFireId;
+    uint32_t totalExtinguished;
+    uint32_t fireTimelineCursor; // Fuegos de la línea temporal ya añadidos
+    int64_t totalExtinctionNs;
+    BoidsCheckpointRng fireRng;
+    BoidsCheckpointRng fireOffsetRng;
+};
+
+struct BoidsCheckpointBoid
+{
+    uint32_t nodeId;
+    uint8_t isLeader;
+    uint8_t reserved[3];
+    int32_t stateCluster; // Cluster en el almacén del controlador
+    uint32_t reserved2;
+    double x;
+    double y;
+    double vx;
+    double vy;
+    double targetX;
+    double targetY;
+    double lastX;
+    double lastY;
+    double energy;
+    double degree;
+    double distanceToTargets;
+    double mobility;
+    double wcaScore;
+    double separationRadius;
+    double alignmentRadius;
+    double cohesionRadius;
+    double leaderInfluenceRadius;
+    double maxSpeed;
+    uint64_t lastMetricsTick;
+    BoidsCheckpointRng rng;
+    BoidsCheckpointRng energyRng;
+};
+
+struct BoidsCheckpointFire
+{
+    uint32_t id;
+    uint32_t assignedLeader;
+    double x;
+    double y;
+    int64_t startNs;
+};
+
+static_assert(sizeof(BoidsCheckpointEvent) == 16, "evento de 16 bytes");
+static_assert(sizeof(BoidsCheckpointRng) == 16, "generador de 16 bytes");
+static_assert(sizeof(BoidsCheckpointHeader) == 168, "cabecera de 168 bytes");
+static_assert(sizeof(BoidsCheckpointBoid) == 200, "registro de boid de 200 bytes");
+static_assert(sizeof(BoidsCheckpointFire) == 32, "registro de fuego de 32 bytes");
+
+/**
+ * Guarda y restaura el estado completo de la bandada: almacén SoA, métricas WCA,
+ * clusters, fuegos activos, totales de extinción, posición de los generadores
+ * aleatorios y eventos periódicos pendientes.
+ *
+ * La restauración no recorre la simulación hasta el instante guardado: Restore()
+ * retiene el arranque del controlador y programa la carga del estado en ese
+ * instante, de modo que la ejecución salta directamente a él. El programa que
+ * restaura debe crear los mismos nodos (mismos NodeId) con BoidsMobilityModel y
+ * no arrancar los fuegos por su cuenta. Si la ejecución original repetía una línea
+ * temporal de fuegos, la que restaura debe fijar la misma (el checkpoint solo
+ * guarda hasta dónde se había repetido).
+ *
+ * ns-3 no expone el estado de RngStream, así que cada generador se guarda como
+ * (stream, valores sorteados) y se recupera repitiendo los sorteos. Solo es exacto
+ * con streams fijados por AssignStreams y la misma semilla y run; con otro --run
+ * la continuación es una variante distinta a partir del mismo estado. El coste de
+ * repetirlos no crece con el instante guardado: un boid sortea su consumo de
+ * energía una vez por tick solo hasta agotarla (unos 200 ticks) y destinos de
+ * paseo de vez en cuando, y los fuegos unos pocos valores por intervalo. Con
+ * VerletSkin=0 las reglas recorren la rejilla en un orden que depende de la
+ * historia de cada celda, y la continuación coincide solo hasta el redondeo.
+ *
+ * No se guardan la red ni lo que cuelga de las fuentes de traza: BoidsTraceCounters,
+ * BoidsStreamingMetrics y las trazas de eventos empiezan vacíos en el instante
+ * restaurado, así que sus resúmenes cubren solo la continuación y no coinciden con
+ * los de la ejecución sin interrumpir. Los totales de extinción del modelo
+ * (fuegos apagados y tiempo acumulado) sí se guardan.
+ */
+class BoidsCheckpoint
+{
+  public:
+    // Escribe el estado actual; llamar entre eventos (ver Schedule)
+    static bool Save(const std::string& path);
+
+    // Programa Save(path) en el instante 'at'
+    static void Schedule(Time at, const std::string& path);
+
+    // Lee y valida el checkpoint y programa su carga en el instante guardado
+    static bool Restore(const std::string& path);
+
+    // Instante guardado en el último checkpoint restaurado
+    static Time GetRestoredTime();
+
+    // Registro de un boid registrado en el controlador (también es el mensaje con
+    // que BoidsFlockPartition migra un boid a otro rango)
+    static void SaveBoid(const BoidsMobilityModel* boid, BoidsCheckpointBoid& r);
+
+    // Carga el registro en un boid registrado; sin restoreRngs el boid conserva
+    // sus propios generadores
+    static void ApplyBoid(BoidsMobilityModel* boid, const BoidsCheckpointBoid& r, bool restoreRngs);
+
+  private:
+    static void SaveEvent(std::string path);
+    static void Apply();
+
+    static BoidsCheckpointHeader s_header;
+    static std::vector<BoidsCheckpointBoid> s_boids;
+    static std::vector<uint32_t> s_clusterWords;
+    static std::vector<BoidsCheckpointFire> s_fires;
+};
+
+} // namespace ns3
+
+#endif /* BOIDS_CHECKPOINT_H */
@@ -0,0 +1,187 @@
+#include "ns3/boids-cluster-table.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace ns3;
+
+namespace
+{
+
+const uint32_t N_CLUSTERS = 4;
+const uint32_t N_FOLLOWERS = 30;
+
+// NodeId de los nodos, ordenados
+std::vector<uint32_t>
+SortedIds(const std::vector<Ptr<Node>>& nodes)
+{
+    std::vector<uint32_t> ids;
+    for (const Ptr<Node>& node : nodes)
+    {
+        ids.push_back(node->GetId());
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+} // namespace
+
+/**
+ * Una secuencia aleatoria de movimientos entre clusters, salidas (NONE o un
+ * cluster inexistente) y Remove debe dejar la tabla igual que un arreglo
+ * nodo -> cluster llevado aparte: cada nodo en su cluster, cada cluster con sus
+ * miembros y sin duplicados. Export debe volcar los miembros de cada cluster en
+ * el orden de GetMembers, e Import de lo exportado reconstruir la misma tabla.
+ */
+class BoidsClusterTableMoveTestCase : public TestCase
+{
+  public:
+    BoidsClusterTableMoveTestCase();
+
+  private:
+    void DoRun() override;
+    void CheckTable(const BoidsClusterTable& table,
+                    const NodeContainer& followers,
+                    const std::vector<int32_t>& expected);
+};
+
+BoidsClusterTableMoveTestCase::BoidsClusterTableMoveTestCase()
+    : TestCase("Movimientos entre clusters y exportación a NodeContainer")
+{
+}
+
+void
+BoidsClusterTableMoveTestCase::CheckTable(const BoidsClusterTable& table,
+                                          const NodeContainer& followers,
+                                          const std::vector<int32_t>& expected)
+{
+    NS_TEST_ASSERT_MSG_EQ(table.GetNClusters(), N_CLUSTERS, "número de clusters");
+    std::vector<std::vector<uint32_t>> expectedMembers(N_CLUSTERS);
+    for (uint32_t i = 0; i < followers.GetN(); ++i)
+    {
+        uint32_t id = followers.Get(i)->GetId();
+        NS_TEST_ASSERT_MSG_EQ(table.GetCluster(id), expected[i], "cluster del nodo " << id);
+        if (expected[i] != BoidsClusterTable::NONE)
+        {
+            expectedMembers[expected[i]].push_back(id);
+        }
+    }
+    for (uint32_t c = 0; c < N_CLUSTERS; ++c)
+    {
+        std::sort(expectedMembers[c].begin(), expectedMembers[c].end());
+        NS_TEST_ASSERT_MSG_EQ(table.GetClusterSize(c),
+                              expectedMembers[c].size(),
+                              "tamaño del cluster " << c);
+        NS_TEST_ASSERT_MSG_EQ((SortedIds(table.GetMembers(c)) == expectedMembers[c]),
+                              true,
+                              "miembros del cluster " << c);
+    }
+}
+
+void
+BoidsClusterTableMoveTestCase::DoRun()
+{
+    NodeContainer heads;
+    NodeContainer followers;
+    heads.Create(N_CLUSTERS);
+    followers.Create(N_FOLLOWERS);
+
+    // Reparto inicial por turnos, con el último nodo sin cluster
+    std::vector<NodeContainer> clusters(N_CLUSTERS);
+    std::vector<int32_t> expected(N_FOLLOWERS, BoidsClusterTable::NONE);
+    for (uint32_t i = 0; i + 1 < N_FOLLOWERS; ++i)
+    {
+        clusters[i % N_CLUSTERS].Add(followers.Get(i));
+        expected[i] = i % N_CLUSTERS;
+    }
+    BoidsClusterTable table;
+    NS_TEST_ASSERT_MSG_EQ(table.IsConfigured(), false, "tabla sin Cluster-Heads");
+    table.Import(heads, clusters);
+    NS_TEST_ASSERT_MSG_EQ(table.IsConfigured(), true, "tabla con Cluster-Heads");
+    CheckTable(table, followers, expected);
+    for (uint32_t c = 0; c < N_CLUSTERS; ++c)
+    {
+        NS_TEST_ASSERT_MSG_EQ(table.GetHead(c)->GetId(),
+                              heads.Get(c)->GetId(),
+                              "Cluster-Head " << c);
+        NS_TEST_ASSERT_MSG_EQ(table.GetHeadCluster(heads.Get(c)->GetId()),
+                              static_cast<int32_t>(c),
+                              "cluster que encabeza el nodo " << heads.Get(c)->GetId());
+    }
+    NS_TEST_ASSERT_MSG_EQ(table.GetHeadCluster(followers.Get(0)->GetId()),
+                          BoidsClusterTable::NONE,
+                          "un seguidor no encabeza ningún cluster");
+
+    // Cada operación saca al nodo de su hueco: el último miembro pasa a ocuparlo
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<uint32_t> pickNode(0, N_FOLLOWERS - 1);
+    std::uniform_int_distribution<int32_t> pickCluster(-1, N_CLUSTERS);
+    for (uint32_t step = 0; step < 300; ++step)
+    {
+        uint32_t i = pickNode(rng);
+        int32_t cluster = pickCluster(rng);
+        if (step % 7 == 0)
+        {
+            table.Remove(followers.Get(i)->GetId());
+            expected[i] = BoidsClusterTable::NONE;
+        }
+        else
+        {
+            table.Assign(followers.Get(i), cluster);
+            bool valid = cluster >= 0 && cluster < static_cast<int32_t>(N_CLUSTERS);
+            expected[i] = valid ? cluster : BoidsClusterTable::NONE;
+        }
+        CheckTable(table, followers, expected);
+    }
+
+    std::vector<NodeContainer> exported;
+    table.Export(exported);
+    NS_TEST_ASSERT_MSG_EQ(exported.size(), N_CLUSTERS, "clusters exportados");
+    for (uint32_t c = 0; c < exported.size(); ++c)
+    {
+        const std::vector<Ptr<Node>>& members = table.GetMembers(c);
+        NS_TEST_ASSERT_MSG_EQ(exported[c].GetN(), members.size(), "exportados del cluster " << c);
+        for (uint32_t k = 0; k < exported[c].GetN() && k < members.size(); ++k)
+        {
+            NS_TEST_ASSERT_MSG_EQ(exported[c].Get(k)->GetId(),
+                                  members[k]->GetId(),
+                                  "orden del cluster " << c);
+        }
+    }
+
+    BoidsClusterTable imported;
+    imported.Import(heads, exported);
+    CheckTable(imported, followers, expected);
+    for (uint32_t c = 0; c < N_CLUSTERS; ++c)
+    {
+        NS_TEST_ASSERT_MSG_EQ((imported.GetMembers(c) == table.GetMembers(c)),
+                              true,
+                              "orden tras importar el cluster " << c);
+    }
+
+    // SetClusterHeads vacía los clusters
+    table.SetClusterHeads(heads);
+    CheckTable(table, followers, std::vector<int32_t>(N_FOLLOWERS, BoidsClusterTable::NONE));
+
+    Simulator::Destroy();
+}
+
+/**
+ * Pruebas de BoidsClusterTable.
+ */
+class BoidsClusterTableTestSuite : public TestSuite
+{
+  public:
+    BoidsClusterTableTestSuite();
+};
+
+BoidsClusterTableTestSuite::BoidsClusterTableTestSuite()
+    : TestSuite("boids-cluster-table", Type::UNIT)
+{
+    AddTestCase(new BoidsClusterTableMoveTestCase, TestCase::Duration::QUICK);
+}
+
+static BoidsClusterTableTestSuite g_boidsClusterTableTestSuite;
@@ -0,0 +1,123 @@
+#include "boids-cluster-table.h"
+
+namespace ns3
+{
+
+const int32_t BoidsClusterTable::NONE;
+
+BoidsClusterTable::BoidsClusterTable()
+{
+}
+
+void
+BoidsClusterTable::SetClusterHeads(const NodeContainer& heads)
+{
+    Clear();
+    m_heads.reserve(heads.GetN());
+    m_members.resize(heads.GetN());
+    for (uint32_t i = 0; i < heads.GetN(); ++i)
+    {
+        Ptr<Node> head = heads.Get(i);
+        uint32_t id = head->GetId();
+        if (id >= m_headOf.size())
+        {
+            m_headOf.resize(id + 1, NONE);
+        }
+        m_headOf[id] = i;
+        m_heads.push_back(head);
+    }
+}
+
+void
+BoidsClusterTable::Import(const NodeContainer& heads, const std::vector<NodeContainer>& clusters)
+{
+    SetClusterHeads(heads);
+    for (uint32_t c = 0; c < clusters.size() && c < m_members.size(); ++c)
+    {
+        for (uint32_t i = 0; i < clusters[c].GetN(); ++i)
+        {
+            Assign(clusters[c].Get(i), c);
+        }
+    }
+}
+
+void
+BoidsClusterTable::Export(std::vector<NodeContainer>& clusters) const
+{
+    clusters.assign(m_members.size(), NodeContainer());
+    for (uint32_t c = 0; c < m_members.size(); ++c)
+    {
+        for (const Ptr<Node>& node : m_members[c])
+        {
+            clusters[c].Add(node);
+        }
+    }
+}
+
+void
+BoidsClusterTable::Grow(uint32_t nodeId)
+{
+    if (nodeId >= m_clusterOf.size())
+    {
+        m_clusterOf.resize(nodeId + 1, NONE);
+        m_slotOf.resize(nodeId + 1, 0);
+    }
+}
+
+void
+BoidsClusterTable::Assign(Ptr<Node> node, int32_t cluster)
+{
+    uint32_t id = node->GetId();
+    if (cluster < 0 || static_cast<uint32_t>(cluster) >= m_members.size())
+    {
+        cluster = NONE;
+    }
+    if (GetCluster(id) == cluster)
+    {
+        return;
+    }
+
+    Remove(id);
+    if (cluster == NONE)
+    {
+        return;
+    }
+    Grow(id);
+    std::vector<Ptr<Node>>& members = m_members[cluster];
+    m_clusterOf[id] = cluster;
+    m_slotOf[id] = members.size();
+    members.push_back(node);
+}
+
+void
+BoidsClusterTable::Remove(uint32_t nodeId)
+{
+    int32_t cluster = GetCluster(nodeId);
+    if (cluster == NONE)
+    {
+        return;
+    }
+
+    // Eliminación O(1): el último miembro ocupa el hueco
+    std::vector<Ptr<Node>>& members = m_members[cluster];
+    uint32_t slot = m_slotOf[nodeId];
+    if (slot != members.size() - 1)
+    {
+        members[slot] = members.back();
+        m_slotOf[members[slot]->GetId()] = slot;
+    }
+    members.pop_back();
+    m_clusterOf[nodeId] = NONE;
+}
+
+void
+BoidsClusterTable::Clear()
+{
+    m_heads.clear();
+    m_headOf.clear();
+    m_members.clear();
+    m_clusterOf.clear();
+    m_slotOf.clear();
+}
+
+} // namespace ns3
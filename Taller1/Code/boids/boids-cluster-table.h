@@ -0,0 +1,92 @@
+#ifndef BOIDS_CLUSTER_TABLE_H
+#define BOIDS_CLUSTER_TABLE_H
+
+#include "ns3/node-container.h"
+#include "ns3/node.h"
+#include "ns3/ptr.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Tabla de pertenencia a clusters indexada por NodeId.
+ *
+ * Un arreglo denso nodo -> cluster y, por cluster, un vector de miembros con
+ * eliminación O(1) intercambiando con el último. Cambiar un nodo de cluster cuesta
+ * O(1) en lugar de recorrer y reconstruir los NodeContainer de todos los clusters.
+ * El cluster i es el del i-ésimo Cluster-Head, que también se indexa por NodeId.
+ */
+class BoidsClusterTable
+{
+  public:
+    static const int32_t NONE = -1;
+
+    BoidsClusterTable();
+
+    // Fija los Cluster-Heads (uno por cluster) y vacía todos los clusters
+    void SetClusterHeads(const NodeContainer& heads);
+
+    // Carga la distribución inicial (clusters[i] pertenece al líder heads.Get(i))
+    void Import(const NodeContainer& heads, const std::vector<NodeContainer>& clusters);
+
+    // Vuelca la tabla al formato de boids.cc: un NodeContainer por cluster
+    void Export(std::vector<NodeContainer>& clusters) const;
+
+    // Mueve el nodo al cluster indicado (NONE lo deja sin cluster)
+    void Assign(Ptr<Node> node, int32_t cluster);
+    void Remove(uint32_t nodeId);
+    void Clear();
+
+    bool IsConfigured() const
+    {
+        return !m_heads.empty();
+    }
+
+    uint32_t GetNClusters() const
+    {
+        return m_members.size();
+    }
+
+    // Cluster del nodo o NONE
+    int32_t GetCluster(uint32_t nodeId) const
+    {
+        return nodeId < m_clusterOf.size() ? m_clusterOf[nodeId] : NONE;
+    }
+
+    // Cluster que encabeza el nodo o NONE si no es Cluster-Head
+    int32_t GetHeadCluster(uint32_t nodeId) const
+    {
+        return nodeId < m_headOf.size() ? m_headOf[nodeId] : NONE;
+    }
+
+    Ptr<Node> GetHead(uint32_t cluster) const
+    {
+        return m_heads[cluster];
+    }
+
+    const std::vector<Ptr<Node>>& GetMembers(uint32_t cluster) const
+    {
+        return m_members[cluster];
+    }
+
+    uint32_t GetClusterSize(uint32_t cluster) const
+    {
+        return m_members[cluster].size();
+    }
+
+  private:
+    void Grow(uint32_t nodeId);
+
+    std::vector<Ptr<Node>> m_heads;                // Cluster -> Cluster-Head
+    std::vector<int32_t> m_headOf;                 // NodeId -> cluster que encabeza
+    std::vector<std::vector<Ptr<Node>>> m_members; // Cluster -> miembros
+    std::vector<int32_t> m_clusterOf;              // NodeId -> cluster
+    std::vector<uint32_t> m_slotOf;                // NodeId -> posición en m_members
+};
+
+} // namespace ns3
+
+#endif /* BOIDS_CLUSTER_TABLE_H */
@@ -0,0 +1,106 @@
+#ifndef BOIDS_COUNTED_RNG_H
+#define BOIDS_COUNTED_RNG_H
+
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+
+#include <cstdint>
+
+namespace ns3
+{
+
+/**
+ * Generador aleatorio de ns-3 que cuenta los valores sorteados.
+ *
+ * ns-3 no expone el estado interno de RngStream, así que la posición de un
+ * generador se guarda como (stream, número de valores sorteados) y Seek la
+ * recupera repitiendo los sorteos. Cada GetValue/GetInteger de Uniform y
+ * Exponential consume un sorteo; el de Normal también queda igual al repetirlo
+ * porque guarda el segundo valor del par sin escalar.
+ */
+template <typename T>
+class BoidsCountedRng
+{
+  public:
+    BoidsCountedRng()
+        : m_stream(-1),
+          m_draws(0)
+    {
+    }
+
+    void Create()
+    {
+        m_rng = CreateObject<T>();
+        m_stream = -1;
+        m_draws = 0;
+    }
+
+    void Reset()
+    {
+        m_rng = nullptr;
+        m_stream = -1;
+        m_draws = 0;
+    }
+
+    explicit operator bool() const
+    {
+        return m_rng != nullptr;
+    }
+
+    // Para configurar atributos; los sorteos hechos por aquí no se cuentan
+    Ptr<T> Get() const
+    {
+        return m_rng;
+    }
+
+    template <typename... Args>
+    double GetValue(Args... args)
+    {
+        ++m_draws;
+        return m_rng->GetValue(args...);
+    }
+
+    uint32_t GetInteger(uint32_t min, uint32_t max)
+    {
+        ++m_draws;
+        return m_rng->GetInteger(min, max);
+    }
+
+    void SetStream(int64_t stream)
+    {
+        m_rng->SetStream(stream);
+        m_stream = stream;
+        m_draws = 0;
+    }
+
+    // -1 si el stream lo asignó ns-3 automáticamente (no se puede recuperar)
+    int64_t GetStream() const
+    {
+        return m_stream;
+    }
+
+    uint64_t GetDraws() const
+    {
+        return m_draws;
+    }
+
+    // Sitúa el generador tras 'draws' valores de 'stream' (con la semilla y run vigentes)
+    void Seek(int64_t stream, uint64_t draws)
+    {
+        SetStream(stream);
+        for (uint64_t i = 0; i < draws; ++i)
+        {
+            m_rng->GetValue();
+        }
+        m_draws = draws;
+    }
+
+  private:
+    Ptr<T> m_rng;
+    int64_t m_stream;
+    uint64_t m_draws;
+};
+
+} // namespace ns3
+
+#endif /* BOIDS_COUNTED_RNG_H */
@@ -0,0 +1,307 @@
+#include "ns3/boids-fire-assignment.h"
+#include "ns3/boids-spatial-grid.h"
+#include "ns3/test.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace ns3;
+
+namespace
+{
+
+const double WORLD = 1000.0;
+
+// Problema de asignación: líderes con ids crecientes y fuegos con ids desordenados
+struct AssignmentProblem
+{
+    std::vector<uint32_t> leaderIds;
+    std::vector<Vector> leaderPositions;
+    std::vector<uint32_t> fireIds;
+    std::vector<Vector> firePositions;
+};
+
+double
+WrappedDistance(const Vector& a, const Vector& b)
+{
+    double dx = BoidsSpatialGrid::WrapDelta(a.x - b.x, WORLD);
+    double dy = BoidsSpatialGrid::WrapDelta(a.y - b.y, WORLD);
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+AssignmentProblem
+RandomProblem(std::mt19937& rng, uint32_t nLeaders, uint32_t nFires)
+{
+    std::uniform_real_distribution<double> coord(0.0, WORLD);
+    AssignmentProblem p;
+    for (uint32_t l = 0; l < nLeaders; ++l)
+    {
+        p.leaderIds.push_back(3 * l + 1);
+        p.leaderPositions.push_back(Vector(coord(rng), coord(rng), 0));
+    }
+    for (uint32_t f = 0; f < nFires; ++f)
+    {
+        p.fireIds.push_back(100 + 7 * f);
+        p.firePositions.push_back(Vector(coord(rng), coord(rng), 0));
+    }
+    std::vector<uint32_t> order(nFires);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), rng);
+    AssignmentProblem shuffled = p;
+    for (uint32_t f = 0; f < nFires; ++f)
+    {
+        shuffled.fireIds[f] = p.fireIds[order[f]];
+        shuffled.firePositions[f] = p.firePositions[order[f]];
+    }
+    return shuffled;
+}
+
+// Costo mínimo probando todas las asignaciones del lado menor al mayor
+double
+BruteForceCost(const AssignmentProblem& p)
+{
+    const uint32_t nLeaders = p.leaderIds.size();
+    const uint32_t nFires = p.fireIds.size();
+    const bool leadersAreRows = nLeaders <= nFires;
+    const uint32_t nRows = leadersAreRows ? nLeaders : nFires;
+    const uint32_t nCols = leadersAreRows ? nFires : nLeaders;
+    std::vector<uint32_t> cols(nCols);
+    std::iota(cols.begin(), cols.end(), 0);
+    double best = std::numeric_limits<double>::infinity();
+    do
+    {
+        double cost = 0.0;
+        for (uint32_t r = 0; r < nRows; ++r)
+        {
+            const uint32_t l = leadersAreRows ? r : cols[r];
+            const uint32_t f = leadersAreRows ? cols[r] : r;
+            cost += WrappedDistance(p.leaderPositions[l], p.firePositions[f]);
+        }
+        best = std::min(best, cost);
+    } while (std::next_permutation(cols.begin(), cols.end()));
+    return best;
+}
+
+/**
+ * Distancia total de una asignación, o -1 si no es válida: un fuego repetido, un
+ * id desconocido o menos parejas que el lado menor.
+ */
+double
+AssignmentCost(const AssignmentProblem& p, const std::vector<uint32_t>& result)
+{
+    if (result.size() != p.leaderIds.size())
+    {
+        return -1.0;
+    }
+    std::vector<bool> used(p.fireIds.size(), false);
+    uint32_t pairs = 0;
+    double cost = 0.0;
+    for (uint32_t l = 0; l < result.size(); ++l)
+    {
+        if (result[l] == BoidsFireAssigner::INVALID)
+        {
+            continue;
+        }
+        auto it = std::find(p.fireIds.begin(), p.fireIds.end(), result[l]);
+        if (it == p.fireIds.end() || used[it - p.fireIds.begin()])
+        {
+            return -1.0;
+        }
+        used[it - p.fireIds.begin()] = true;
+        cost += WrappedDistance(p.leaderPositions[l], p.firePositions[it - p.fireIds.begin()]);
+        pairs++;
+    }
+    if (pairs != std::min(p.leaderIds.size(), p.fireIds.size()))
+    {
+        return -1.0;
+    }
+    return cost;
+}
+
+} // namespace
+
+/**
+ * Problemas pequeños rectangulares en las dos orientaciones (más fuegos que
+ * líderes y al revés) comparados con el óptimo por fuerza bruta: el húngaro debe
+ * ser exacto y la subasta quedar a menos de 1 m del óptimo.
+ */
+class BoidsFireAssignmentOptimalTestCase : public TestCase
+{
+  public:
+    BoidsFireAssignmentOptimalTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+BoidsFireAssignmentOptimalTestCase::BoidsFireAssignmentOptimalTestCase()
+    : TestCase("Húngaro óptimo y subasta a menos de 1 m en problemas rectangulares")
+{
+}
+
+void
+BoidsFireAssignmentOptimalTestCase::DoRun()
+{
+    const uint32_t shapes[][2] = {{1, 5}, {5, 1}, {3, 6}, {6, 3}, {4, 4}, {2, 7}, {7, 2}};
+    std::mt19937 rng(1);
+    for (const auto& shape : shapes)
+    {
+        for (uint32_t trial = 0; trial < 20; ++trial)
+        {
+            AssignmentProblem p = RandomProblem(rng, shape[0], shape[1]);
+            const double optimum = BruteForceCost(p);
+
+            BoidsFireAssigner hungarian;
+            hungarian.SetAlgorithm(BoidsFireAssigner::HUNGARIAN);
+            double cost = AssignmentCost(
+                p,
+                hungarian.Assign(p.leaderIds, p.leaderPositions, p.fireIds, p.firePositions));
+            NS_TEST_ASSERT_MSG_GT_OR_EQ(cost, 0.0, "asignación húngara válida");
+            NS_TEST_ASSERT_MSG_EQ_TOL(cost, optimum, 1e-6, "el húngaro alcanza el óptimo");
+            NS_TEST_ASSERT_MSG_EQ_TOL(hungarian.GetLastCost(), cost, 1e-6, "GetLastCost");
+
+            BoidsFireAssigner auction;
+            auction.SetAlgorithm(BoidsFireAssigner::AUCTION);
+            cost = AssignmentCost(
+                p,
+                auction.Assign(p.leaderIds, p.leaderPositions, p.fireIds, p.firePositions));
+            NS_TEST_ASSERT_MSG_GT_OR_EQ(cost, 0.0, "asignación de la subasta válida");
+            NS_TEST_ASSERT_MSG_LT(cost, optimum + 1.0, "la subasta queda a menos de 1 m");
+
+            BoidsFireAssigner greedy;
+            greedy.SetAlgorithm(BoidsFireAssigner::GREEDY);
+            cost = AssignmentCost(
+                p,
+                greedy.Assign(p.leaderIds, p.leaderPositions, p.fireIds, p.firePositions));
+            NS_TEST_ASSERT_MSG_GT_OR_EQ(cost, optimum - 1e-6, "voraz válida y no bajo el óptimo");
+        }
+    }
+}
+
+/**
+ * Reutilización y arranque en caliente: con los mismos ids no se vuelve a
+ * resolver aunque cambien las posiciones o el orden de los fuegos; tras Invalidate
+ * o un cambio de fuegos o líderes se resuelve con los precios anteriores y sigue a
+ * menos de 1 m del óptimo, también cuando cambia el lado que puja.
+ */
+class BoidsFireAssignmentReuseTestCase : public TestCase
+{
+  public:
+    BoidsFireAssignmentReuseTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+BoidsFireAssignmentReuseTestCase::BoidsFireAssignmentReuseTestCase()
+    : TestCase("Reutilización y precios en caliente de la subasta")
+{
+}
+
+void
+BoidsFireAssignmentReuseTestCase::DoRun()
+{
+    std::mt19937 rng(2);
+    BoidsFireAssigner assigner;
+    assigner.SetAlgorithm(BoidsFireAssigner::AUCTION);
+
+    AssignmentProblem p = RandomProblem(rng, 4, 6);
+    const std::vector<uint32_t> first =
+        assigner.Assign(p.leaderIds, p.leaderPositions, p.fireIds, p.firePositions);
+    NS_TEST_ASSERT_MSG_EQ(assigner.GetSolveCount(), 1, "primera resolución");
+    NS_TEST_ASSERT_MSG_EQ(assigner.GetReuseCount(), 0, "nada que reutilizar");
+    double cost = AssignmentCost(p, first);
+    NS_TEST_ASSERT_MSG_GT_OR_EQ(cost, 0.0, "asignación en frío válida");
+    NS_TEST_ASSERT_MSG_LT(cost, BruteForceCost(p) + 1.0, "en frío");
+
+    // Mismos fuegos en otro orden: se reutiliza y el resultado no cambia
+    AssignmentProblem reordered = p;
+    std::reverse(reordered.fireIds.begin(), reordered.fireIds.end());
+    std::reverse(reordered.firePositions.begin(), reordered.firePositions.end());
+    bool same = assigner.Assign(reordered.leaderIds,
+                                reordered.leaderPositions,
+                                reordered.fireIds,
+                                reordered.firePositions) == first;
+    NS_TEST_ASSERT_MSG_EQ(same, true, "el orden de los fuegos no cambia el resultado");
+    NS_TEST_ASSERT_MSG_EQ(assigner.GetReuseCount(), 1, "mismos ids: se reutiliza");
+
+    // Líderes desplazados con los mismos ids: también se reutiliza
+    for (Vector& position : p.leaderPositions)
+    {
+        position.x = std::fmod(position.x + 150.0, WORLD);
+    }
+    same = assigner.Assign(p.leaderIds, p.leaderPositions, p.fireIds, p.firePositions) == first;
+    NS_TEST_ASSERT_MSG_EQ(same, true, "las posiciones solas no fuerzan otra resolución");
+    NS_TEST_ASSERT_MSG_EQ(assigner.GetReuseCount(), 2, "segunda reutilización");
+    NS_TEST_ASSERT_MSG_EQ(assigner.GetSolveCount(), 1, "sin nuevas resoluciones");
+
+    // Invalidate: se resuelve en caliente para las posiciones nuevas
+    assigner.Invalidate();
+    cost = AssignmentCost(
+        p,
+        assigner.Assign(p.leaderIds, p.leaderPositions, p.fireIds, p.firePositions));
+    NS_TEST_ASSERT_MSG_EQ(assigner.GetSolveCount(), 2, "Invalidate fuerza la resolución");
+    NS_TEST_ASSERT_MSG_GT_OR_EQ(cost, 0.0, "asignación en caliente válida");
+    NS_TEST_ASSERT_MSG_LT(cost, BruteForceCost(p) + 1.0, "en caliente tras mover los líderes");
+
+    // Un fuego menos: cambia el conjunto de ids
+    p.fireIds.pop_back();
+    p.firePositions.pop_back();
+    cost = AssignmentCost(
+        p,
+        assigner.Assign(p.leaderIds, p.leaderPositions, p.fireIds, p.firePositions));
+    NS_TEST_ASSERT_MSG_EQ(assigner.GetSolveCount(), 3, "un fuego apagado fuerza la resolución");
+    NS_TEST_ASSERT_MSG_LT(cost, BruteForceCost(p) + 1.0, "en caliente tras apagar un fuego");
+
+    // Más líderes que fuegos: pujan los fuegos y los precios pasan a ser de los líderes
+    AssignmentProblem extra = RandomProblem(rng, 4, 0);
+    for (uint32_t l = 0; l < extra.leaderIds.size(); ++l)
+    {
+        p.leaderIds.push_back(1000 + l);
+        p.leaderPositions.push_back(extra.leaderPositions[l]);
+    }
+    for (uint32_t round = 0; round < 3; ++round)
+    {
+        cost = AssignmentCost(
+            p,
+            assigner.Assign(p.leaderIds, p.leaderPositions, p.fireIds, p.firePositions));
+        NS_TEST_ASSERT_MSG_GT_OR_EQ(cost, 0.0, "asignación con más líderes que fuegos válida");
+        NS_TEST_ASSERT_MSG_LT(cost, BruteForceCost(p) + 1.0, "en caliente con más líderes");
+        for (Vector& position : p.firePositions)
+        {
+            position.y = std::fmod(position.y + 40.0, WORLD);
+        }
+        assigner.Invalidate();
+    }
+    NS_TEST_ASSERT_MSG_EQ(assigner.GetSolveCount(), 6, "una resolución por ronda");
+
+    // Cambiar el algoritmo invalida el resultado guardado
+    assigner.SetAlgorithm(BoidsFireAssigner::HUNGARIAN);
+    cost = AssignmentCost(
+        p,
+        assigner.Assign(p.leaderIds, p.leaderPositions, p.fireIds, p.firePositions));
+    NS_TEST_ASSERT_MSG_EQ(assigner.GetSolveCount(), 7, "SetAlgorithm fuerza la resolución");
+    NS_TEST_ASSERT_MSG_EQ_TOL(cost, BruteForceCost(p), 1e-6, "húngaro tras la subasta");
+}
+
+/**
+ * Pruebas del motor de asignación de fuegos a líderes.
+ */
+class BoidsFireAssignmentTestSuite : public TestSuite
+{
+  public:
+    BoidsFireAssignmentTestSuite();
+};
+
+BoidsFireAssignmentTestSuite::BoidsFireAssignmentTestSuite()
+    : TestSuite("boids-fire-assignment", Type::UNIT)
+{
+    AddTestCase(new BoidsFireAssignmentOptimalTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new BoidsFireAssignmentReuseTestCase, TestCase::Duration::QUICK);
+}
+
+static BoidsFireAssignmentTestSuite g_boidsFireAssignmentTestSuite;
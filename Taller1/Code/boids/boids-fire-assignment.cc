@@ -0,0 +1,427 @@
+#include "boids-fire-assignment.h"
+
+#include "boids-spatial-grid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <numeric>
+
+namespace ns3
+{
+
+const uint32_t BoidsFireAssigner::INVALID;
+
+BoidsFireAssigner::BoidsFireAssigner()
+    : m_algorithm(AUTO),
+      m_autoThreshold(400),
+      m_width(1000.0),
+      m_height(1000.0),
+      m_valid(false),
+      m_solves(0),
+      m_reuses(0),
+      m_lastCost(0.0)
+{
+}
+
+void
+BoidsFireAssigner::SetAlgorithm(Algorithm algorithm)
+{
+    m_algorithm = algorithm;
+    m_valid = false;
+}
+
+bool
+BoidsFireAssigner::SetAlgorithm(const std::string& name)
+{
+    if (name == "greedy")
+    {
+        SetAlgorithm(GREEDY);
+    }
+    else if (name == "hungarian")
+    {
+        SetAlgorithm(HUNGARIAN);
+    }
+    else if (name == "auction")
+    {
+        SetAlgorithm(AUCTION);
+    }
+    else if (name == "auto")
+    {
+        SetAlgorithm(AUTO);
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+void
+BoidsFireAssigner::SetWorldSize(double width, double height)
+{
+    m_width = width;
+    m_height = height;
+    m_valid = false;
+}
+
+double
+BoidsFireAssigner::Cost(const Vector& a, const Vector& b) const
+{
+    double dx = BoidsSpatialGrid::WrapDelta(a.x - b.x, m_width);
+    double dy = BoidsSpatialGrid::WrapDelta(a.y - b.y, m_height);
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+const std::vector<uint32_t>&
+BoidsFireAssigner::Assign(const std::vector<uint32_t>& leaderIds,
+                          const std::vector<Vector>& leaderPositions,
+                          const std::vector<uint32_t>& fireIds,
+                          const std::vector<Vector>& firePositions)
+{
+    // Fuegos en orden de id: el resultado no depende del orden del registro
+    std::vector<uint32_t> order(fireIds.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return fireIds[a] < fireIds[b];
+    });
+    std::vector<uint32_t> sortedFires(order.size());
+    for (uint32_t k = 0; k < order.size(); ++k)
+    {
+        sortedFires[k] = fireIds[order[k]];
+    }
+
+    if (m_valid && leaderIds == m_lastLeaders && sortedFires == m_lastFires)
+    {
+        m_reuses++;
+        return m_result;
+    }
+
+    const uint32_t nLeaders = leaderIds.size();
+    const uint32_t nFires = sortedFires.size();
+    m_result.assign(nLeaders, INVALID);
+    m_lastCost = 0.0;
+
+    if (nLeaders > 0 && nFires > 0)
+    {
+        // Las filas son el lado más pequeño
+        const bool leadersAreRows = nLeaders <= nFires;
+        const uint32_t nRows = leadersAreRows ? nLeaders : nFires;
+        const uint32_t nCols = leadersAreRows ? nFires : nLeaders;
+        std::vector<double> cost(static_cast<size_t>(nRows) * nCols);
+        for (uint32_t l = 0; l < nLeaders; ++l)
+        {
+            for (uint32_t f = 0; f < nFires; ++f)
+            {
+                double c = Cost(leaderPositions[l], firePositions[order[f]]);
+                cost[leadersAreRows ? l * nCols + f : f * nCols + l] = c;
+            }
+        }
+
+        Algorithm algorithm = m_algorithm;
+        if (algorithm == AUTO)
+        {
+            // El húngaro cuesta O(nRows^2 * nCols): con pocos líderes y muchos fuegos
+            // (o al revés) sigue siendo barato aunque el lado grande pase del umbral
+            const double threshold = m_autoThreshold;
+            const double work = static_cast<double>(nRows) * nRows * nCols;
+            algorithm = work <= threshold * threshold * threshold ? HUNGARIAN : AUCTION;
+        }
+
+        std::vector<uint32_t> rowTo;
+        switch (algorithm)
+        {
+        case GREEDY:
+            rowTo = SolveGreedy(cost, nRows, nCols);
+            break;
+        case HUNGARIAN:
+            rowTo = SolveHungarian(cost, nRows, nCols);
+            break;
+        default:
+            rowTo = leadersAreRows
+                        ? SolveAuction(cost, nRows, nCols, sortedFires, m_firePrices)
+                        : SolveAuction(cost, nRows, nCols, leaderIds, m_leaderPrices);
+            break;
+        }
+
+        for (uint32_t r = 0; r < nRows; ++r)
+        {
+            uint32_t c = rowTo[r];
+            if (c == INVALID)
+            {
+                continue;
+            }
+            m_lastCost += cost[r * nCols + c];
+            if (leadersAreRows)
+            {
+                m_result[r] = sortedFires[c];
+            }
+            else
+            {
+                m_result[c] = sortedFires[r];
+            }
+        }
+    }
+
+    m_lastLeaders = leaderIds;
+    m_lastFires = sortedFires;
+    m_valid = true;
+    m_solves++;
+    return m_result;
+}
+
+std::vector<uint32_t>
+BoidsFireAssigner::SolveGreedy(const std::vector<double>& cost,
+                               uint32_t nRows,
+                               uint32_t nCols) const
+{
+    std::vector<uint32_t> rowTo(nRows, INVALID);
+    std::vector<bool> taken(nCols, false);
+    for (uint32_t r = 0; r < nRows; ++r)
+    {
+        double best = std::numeric_limits<double>::infinity();
+        for (uint32_t c = 0; c < nCols; ++c)
+        {
+            if (!taken[c] && cost[r * nCols + c] < best)
+            {
+                best = cost[r * nCols + c];
+                rowTo[r] = c;
+            }
+        }
+        taken[rowTo[r]] = true;
+    }
+    return rowTo;
+}
+
+std::vector<uint32_t>
+BoidsFireAssigner::SolveHungarian(const std::vector<double>& cost,
+                                  uint32_t nRows,
+                                  uint32_t nCols) const
+{
+    // Método húngaro con potenciales (índices desde 1; la columna 0 es ficticia)
+    const double inf = std::numeric_limits<double>::infinity();
+    std::vector<double> u(nRows + 1, 0.0);
+    std::vector<double> v(nCols + 1, 0.0);
+    std::vector<uint32_t> p(nCols + 1, 0);   // Fila asignada a cada columna
+    std::vector<uint32_t> way(nCols + 1, 0); // Columna previa en el camino aumentante
+
+    for (uint32_t i = 1; i <= nRows; ++i)
+    {
+        p[0] = i;
+        uint32_t j0 = 0;
+        std::vector<double> minv(nCols + 1, inf);
+        std::vector<bool> used(nCols + 1, false);
+        do
+        {
+            used[j0] = true;
+            uint32_t i0 = p[j0];
+            uint32_t j1 = 0;
+            double delta = inf;
+            for (uint32_t j = 1; j <= nCols; ++j)
+            {
+                if (!used[j])
+                {
+                    double cur = cost[(i0 - 1) * nCols + (j - 1)] - u[i0] - v[j];
+                    if (cur < minv[j])
+                    {
+                        minv[j] = cur;
+                        way[j] = j0;
+                    }
+                    if (minv[j] < delta)
+                    {
+                        delta = minv[j];
+                        j1 = j;
+                    }
+                }
+            }
+            for (uint32_t j = 0; j <= nCols; ++j)
+            {
+                if (used[j])
+                {
+                    u[p[j]] += delta;
+                    v[j] -= delta;
+                }
+                else
+                {
+                    minv[j] -= delta;
+                }
+            }
+            j0 = j1;
+        } while (p[j0] != 0);
+
+        do
+        {
+            uint32_t j1 = way[j0];
+            p[j0] = p[j1];
+            j0 = j1;
+        } while (j0 != 0);
+    }
+
+    std::vector<uint32_t> rowTo(nRows, INVALID);
+    for (uint32_t j = 1; j <= nCols; ++j)
+    {
+        if (p[j] != 0)
+        {
+            rowTo[p[j] - 1] = j - 1;
+        }
+    }
+    return rowTo;
+}
+
+std::vector<uint32_t>
+BoidsFireAssigner::SolveAuction(const std::vector<double>& cost,
+                                uint32_t nRows,
+                                uint32_t nCols,
+                                const std::vector<uint32_t>& colIds,
+                                std::map<uint32_t, double>& prices) const
+{
+    // Subasta asimétrica (Bertsekas), sin completar el problema a cuadrado. En la
+    // subasta directa las filas pujan por las columnas (beneficio = -costo - precio)
+    // hasta tener todas columna. Después, en la inversa, las columnas libres más
+    // caras que la asignada más barata (lambda) pujan por las filas o bajan a
+    // lambda. Así ninguna columna libre queda por encima de las asignadas, también
+    // con los precios de una resolución anterior, y la subasta es óptima. Con
+    // epsilon final 1/(nRows+1) la distancia total queda a menos de 1 m del óptimo.
+    const double inf = std::numeric_limits<double>::infinity();
+    auto benefit = [&](uint32_t r, uint32_t c) { return -cost[r * nCols + c]; };
+
+    std::vector<double> price(nCols, 0.0);
+    bool warm = false;
+    for (uint32_t c = 0; c < nCols; ++c)
+    {
+        auto it = prices.find(colIds[c]);
+        if (it != prices.end())
+        {
+            price[c] = it->second;
+            warm = true;
+        }
+    }
+
+    const double finalEps = 1.0 / (nRows + 1);
+    const double maxCost = *std::max_element(cost.begin(), cost.end());
+    // En caliente los precios ya están cerca del equilibrio: se empieza con epsilon pequeño
+    double eps = warm ? 16 * finalEps : std::max(finalEps, maxCost / 4);
+
+    std::vector<uint32_t> rowTo(nRows);
+    std::vector<uint32_t> colTo(nCols);
+    std::vector<double> profit(nRows); // Beneficio de cada fila con su columna
+    std::deque<uint32_t> pending;
+    while (true)
+    {
+        std::fill(rowTo.begin(), rowTo.end(), INVALID);
+        std::fill(colTo.begin(), colTo.end(), INVALID);
+
+        // Subasta directa: cada fila libre puja por su mejor columna
+        pending.resize(nRows);
+        std::iota(pending.begin(), pending.end(), 0);
+        while (!pending.empty())
+        {
+            uint32_t r = pending.front();
+            pending.pop_front();
+
+            double best = -inf;
+            double second = -inf;
+            uint32_t bestCol = 0;
+            for (uint32_t c = 0; c < nCols; ++c)
+            {
+                double value = benefit(r, c) - price[c];
+                if (value > best)
+                {
+                    second = best;
+                    best = value;
+                    bestCol = c;
+                }
+                else if (value > second)
+                {
+                    second = value;
+                }
+            }
+            if (nCols == 1)
+            {
+                second = best;
+            }
+
+            price[bestCol] += best - second + eps;
+            profit[r] = second - eps;
+            if (colTo[bestCol] != INVALID)
+            {
+                rowTo[colTo[bestCol]] = INVALID;
+                pending.push_back(colTo[bestCol]);
+            }
+            colTo[bestCol] = r;
+            rowTo[r] = bestCol;
+        }
+
+        // Subasta inversa: columnas libres con precio por encima de lambda
+        double lambda = inf;
+        for (uint32_t r = 0; r < nRows; ++r)
+        {
+            lambda = std::min(lambda, price[rowTo[r]]);
+        }
+        for (uint32_t c = 0; c < nCols; ++c)
+        {
+            if (colTo[c] == INVALID && price[c] > lambda)
+            {
+                pending.push_back(c);
+            }
+        }
+        while (!pending.empty())
+        {
+            uint32_t c = pending.front();
+            pending.pop_front();
+
+            double best = -inf;
+            double second = -inf;
+            uint32_t bestRow = 0;
+            for (uint32_t r = 0; r < nRows; ++r)
+            {
+                double value = benefit(r, c) - profit[r];
+                if (value > best)
+                {
+                    second = best;
+                    best = value;
+                    bestRow = r;
+                }
+                else if (value > second)
+                {
+                    second = value;
+                }
+            }
+            if (lambda >= best - eps)
+            {
+                // Ninguna fila la quiere a un precio mayor que lambda: queda libre
+                price[c] = lambda;
+                continue;
+            }
+
+            // La fila cambia de columna; la que deja puede quedar cara y libre
+            price[c] = std::max(lambda, second - eps);
+            profit[bestRow] = benefit(bestRow, c) - price[c];
+            uint32_t previous = rowTo[bestRow];
+            colTo[previous] = INVALID;
+            if (price[previous] > lambda)
+            {
+                pending.push_back(previous);
+            }
+            colTo[c] = bestRow;
+            rowTo[bestRow] = c;
+        }
+
+        if (eps <= finalEps)
+        {
+            break;
+        }
+        eps = std::max(finalEps, eps / 4);
+    }
+
+    // Solo se conservan los precios de las columnas vigentes
+    prices.clear();
+    for (uint32_t c = 0; c < nCols; ++c)
+    {
+        prices[colIds[c]] = price[c];
+    }
+    return rowTo;
+}
+
+} // namespace ns3
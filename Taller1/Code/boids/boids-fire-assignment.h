@@ -0,0 +1,142 @@
+#ifndef BOIDS_FIRE_ASSIGNMENT_H
+#define BOIDS_FIRE_ASSIGNMENT_H
+
+#include "ns3/vector.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Asignación de fuegos a líderes con costo mínimo (distancia total envuelta).
+ *
+ * Cada fuego recibe a lo sumo un líder y cada líder a lo sumo un fuego. Se puede
+ * elegir el algoritmo:
+ *   - GREEDY: recorre el lado menor en orden de id: con tantos fuegos como líderes
+ *     o más, cada líder toma el fuego libre más cercano; con menos fuegos, cada
+ *     fuego toma el líder libre más cercano,
+ *   - HUNGARIAN: óptimo exacto, O(n^2 m) con n líderes o fuegos (el lado menor)
+ *     y m el mayor,
+ *   - AUCTION: subasta asimétrica (directa e inversa) con escalado de epsilon,
+ *     óptima dentro de 1 m en total; conserva los precios entre llamadas para
+ *     arrancar en caliente,
+ *   - AUTO: húngaro mientras n^2 m no pase de GetAutoThreshold()^3 (un problema
+ *     cuadrado de ese tamaño) y subasta por encima.
+ * Solo se vuelve a resolver si cambia el conjunto de líderes o de fuegos.
+ */
+class BoidsFireAssigner
+{
+  public:
+    enum Algorithm
+    {
+        GREEDY,
+        HUNGARIAN,
+        AUCTION,
+        AUTO
+    };
+
+    static const uint32_t INVALID = 0xffffffff;
+
+    BoidsFireAssigner();
+
+    void SetAlgorithm(Algorithm algorithm);
+
+    Algorithm GetAlgorithm() const
+    {
+        return m_algorithm;
+    }
+
+    // "greedy", "hungarian", "auction" o "auto"; false si el nombre no existe
+    bool SetAlgorithm(const std::string& name);
+
+    void SetWorldSize(double width, double height);
+
+    void SetAutoThreshold(uint32_t n)
+    {
+        m_autoThreshold = n;
+    }
+
+    uint32_t GetAutoThreshold() const
+    {
+        return m_autoThreshold;
+    }
+
+    /**
+     * Resuelve (o reutiliza) la asignación.
+     *
+     * \param leaderIds ids de los líderes, en orden creciente
+     * \param leaderPositions posición de cada líder
+     * \param fireIds ids de los fuegos activos (cualquier orden)
+     * \param firePositions posición de cada fuego
+     * \return id del fuego asignado a cada líder (INVALID si sobran líderes)
+     */
+    const std::vector<uint32_t>& Assign(const std::vector<uint32_t>& leaderIds,
+                                        const std::vector<Vector>& leaderPositions,
+                                        const std::vector<uint32_t>& fireIds,
+                                        const std::vector<Vector>& firePositions);
+
+    // Forzar una nueva resolución en la próxima llamada
+    void Invalidate()
+    {
+        m_valid = false;
+    }
+
+    uint64_t GetSolveCount() const
+    {
+        return m_solves;
+    }
+
+    uint64_t GetReuseCount() const
+    {
+        return m_reuses;
+    }
+
+    // Distancia total de la última asignación resuelta
+    double GetLastCost() const
+    {
+        return m_lastCost;
+    }
+
+  private:
+    double Cost(const Vector& a, const Vector& b) const;
+
+    // Las tres resuelven filas -> columnas con nRows <= nCols; devuelven la columna de cada fila
+    std::vector<uint32_t> SolveGreedy(const std::vector<double>& cost,
+                                      uint32_t nRows,
+                                      uint32_t nCols) const;
+    std::vector<uint32_t> SolveHungarian(const std::vector<double>& cost,
+                                         uint32_t nRows,
+                                         uint32_t nCols) const;
+    std::vector<uint32_t> SolveAuction(const std::vector<double>& cost,
+                                       uint32_t nRows,
+                                       uint32_t nCols,
+                                       const std::vector<uint32_t>& colIds,
+                                       std::map<uint32_t, double>& prices) const;
+
+    Algorithm m_algorithm;
+    uint32_t m_autoThreshold;
+    double m_width;
+    double m_height;
+
+    // Entrada de la última resolución y su resultado
+    bool m_valid;
+    std::vector<uint32_t> m_lastLeaders;
+    std::vector<uint32_t> m_lastFires; // Ordenados
+    std::vector<uint32_t> m_result;
+
+    // Precios de la subasta por id (fuegos o líderes, según quién puja)
+    std::map<uint32_t, double> m_firePrices;
+    std::map<uint32_t, double> m_leaderPrices;
+
+    uint64_t m_solves;
+    uint64_t m_reuses;
+    double m_lastCost;
+};
+
+} // namespace ns3
+
+#endif /* BOIDS_FIRE_ASSIGNMENT_H */
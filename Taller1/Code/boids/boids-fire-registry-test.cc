@@ -0,0 +1,78 @@
+#include "ns3/boids-fire-registry.h"
+#include "ns3/test.h"
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Registro de fuegos guardado y restaurado como lo hace BoidsCheckpoint (Clear,
+ * Insert de los fuegos activos y SetNextId) después de apagar el fuego de mayor
+ * id: el siguiente fuego debe recibir un id nuevo, encontrarse y poder apagarse.
+ */
+class BoidsFireRegistryRestoreTestCase : public TestCase
+{
+  public:
+    BoidsFireRegistryRestoreTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+BoidsFireRegistryRestoreTestCase::BoidsFireRegistryRestoreTestCase()
+    : TestCase("Restaurar el registro tras apagar el fuego de mayor id")
+{
+}
+
+void
+BoidsFireRegistryRestoreTestCase::DoRun()
+{
+    BoidsFireRegistry registry;
+    registry.Configure(1000.0, 1000.0, 50.0);
+    registry.Add(Vector(100, 100, 0), Seconds(1));
+    registry.Add(Vector(500, 500, 0), Seconds(2));
+    uint32_t last = registry.Add(Vector(900, 900, 0), Seconds(3));
+    NS_TEST_ASSERT_MSG_EQ(last, 2, "ids consecutivos desde 0");
+    NS_TEST_ASSERT_MSG_EQ(registry.Remove(last), true, "apagar el fuego de mayor id");
+
+    // Guardar: fuegos activos y próximo id
+    std::vector<BoidsFire> saved(registry.begin(), registry.end());
+    uint32_t nextId = registry.GetNextId();
+
+    // Restaurar
+    registry.Clear();
+    for (const BoidsFire& fire : saved)
+    {
+        registry.Insert(fire);
+    }
+    registry.SetNextId(nextId);
+    NS_TEST_ASSERT_MSG_EQ(registry.GetN(), 2, "fuegos activos restaurados");
+    NS_TEST_ASSERT_MSG_EQ(registry.Contains(last), false, "el fuego apagado sigue apagado");
+
+    uint32_t added = registry.Add(Vector(300, 700, 0), Seconds(4));
+    NS_TEST_ASSERT_MSG_EQ(added, 3, "el id no se reutiliza");
+    NS_TEST_ASSERT_MSG_EQ(registry.Contains(added), true, "el fuego nuevo está en el registro");
+    NS_TEST_ASSERT_MSG_EQ(registry.Contains(last), false, "el fuego apagado no reaparece");
+    NS_TEST_ASSERT_MSG_EQ(registry.FindNearest(Vector(300, 700, 0)), added, "búsqueda del nuevo");
+    NS_TEST_ASSERT_MSG_EQ(registry.Get(added).startTime, Seconds(4), "Get del fuego nuevo");
+    NS_TEST_ASSERT_MSG_EQ(registry.Remove(added), true, "apagar el fuego nuevo");
+    NS_TEST_ASSERT_MSG_EQ(registry.Contains(added), false, "fuego nuevo apagado");
+    NS_TEST_ASSERT_MSG_EQ(registry.GetN(), 2, "quedan los fuegos restaurados");
+}
+
+/**
+ * Pruebas del registro de fuegos de BoidsMobilityModel.
+ */
+class BoidsFireRegistryTestSuite : public TestSuite
+{
+  public:
+    BoidsFireRegistryTestSuite();
+};
+
+BoidsFireRegistryTestSuite::BoidsFireRegistryTestSuite()
+    : TestSuite("boids-fire-registry", Type::UNIT)
+{
+    AddTestCase(new BoidsFireRegistryRestoreTestCase, TestCase::Duration::QUICK);
+}
+
+static BoidsFireRegistryTestSuite g_boidsFireRegistryTestSuite;
@@ -0,0 +1,96 @@
+#include "boids-fire-registry.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+const uint32_t BoidsFireRegistry::INVALID;
+
+BoidsFireRegistry::BoidsFireRegistry()
+    : m_nextId(0)
+{
+}
+
+void
+BoidsFireRegistry::Configure(double width, double height, double cellSize)
+{
+    m_grid.Configure(width, height, cellSize);
+}
+
+uint32_t
+BoidsFireRegistry::Add(const Vector& position, Time startTime)
+{
+    uint32_t id = m_nextId++;
+    uint32_t slot = m_fires.size();
+    m_fires.push_back({id, position, startTime, INVALID});
+    // Tras restaurar un checkpoint la tabla puede acabar antes de m_nextId (el fuego
+    // de mayor id ya se había apagado): no basta con añadir al final
+    if (id >= m_slotOfId.size())
+    {
+        m_slotOfId.resize(id + 1, INVALID);
+    }
+    m_slotOfId[id] = slot;
+    m_grid.Insert(slot, position.x, position.y);
+    return id;
+}
+
+void
+BoidsFireRegistry::Insert(const BoidsFire& fire)
+{
+    Remove(fire.id);
+    if (fire.id >= m_slotOfId.size())
+    {
+        m_slotOfId.resize(fire.id + 1, INVALID);
+    }
+    uint32_t slot = m_fires.size();
+    m_fires.push_back(fire);
+    m_slotOfId[fire.id] = slot;
+    m_grid.Insert(slot, fire.position.x, fire.position.y);
+    m_nextId = std::max(m_nextId, fire.id + 1);
+}
+
+void
+BoidsFireRegistry::SetNextId(uint32_t nextId)
+{
+    m_nextId = nextId;
+    if (m_slotOfId.size() < nextId)
+    {
+        m_slotOfId.resize(nextId, INVALID);
+    }
+}
+
+bool
+BoidsFireRegistry::Remove(uint32_t id)
+{
+    if (!Contains(id))
+    {
+        return false;
+    }
+
+    // Eliminación O(1): el último fuego ocupa el hueco
+    uint32_t slot = m_slotOfId[id];
+    uint32_t last = m_fires.size() - 1;
+    m_grid.Remove(slot);
+    if (slot != last)
+    {
+        m_grid.Remove(last);
+        m_fires[slot] = m_fires[last];
+        m_slotOfId[m_fires[slot].id] = slot;
+        m_grid.Insert(slot, m_fires[slot].position.x, m_fires[slot].position.y);
+    }
+    m_fires.pop_back();
+    m_slotOfId[id] = INVALID;
+    return true;
+}
+
+void
+BoidsFireRegistry::Clear()
+{
+    m_fires.clear();
+    m_slotOfId.clear();
+    m_grid.Clear();
+    m_nextId = 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,142 @@
+#ifndef BOIDS_FIRE_REGISTRY_H
+#define BOIDS_FIRE_REGISTRY_H
+
+#include "boids-spatial-grid.h"
+
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace ns3
+{
+
+// Fuego activo con su metadato
+struct BoidsFire
+{
+    uint32_t id;             // Estable durante toda la vida del fuego
+    Vector position;
+    Time startTime;          // Instante de aparición
+    uint32_t assignedLeader; // NodeId del líder asignado (INVALID si ninguno)
+};
+
+/**
+ * Registro de fuegos activos.
+ *
+ * Los fuegos se guardan de forma densa (eliminación O(1) intercambiando con el
+ * último) y se identifican por un id estable que no depende de la posición.
+ * Una rejilla toroidal indexa sus posiciones para que las consultas de fuego más
+ * cercano y de fuegos en un radio no recorran todos los fuegos.
+ */
+class BoidsFireRegistry
+{
+  public:
+    static const uint32_t INVALID = BoidsSpatialGrid::INVALID;
+
+    BoidsFireRegistry();
+
+    void Configure(double width, double height, double cellSize);
+
+    // Devuelve el id del nuevo fuego
+    uint32_t Add(const Vector& position, Time startTime);
+    // Vuelve a insertar un fuego con su id (restauración de un checkpoint)
+    void Insert(const BoidsFire& fire);
+    bool Remove(uint32_t id);
+    void Clear();
+
+    bool Contains(uint32_t id) const
+    {
+        return id < m_slotOfId.size() && m_slotOfId[id] != INVALID;
+    }
+
+    BoidsFire& Get(uint32_t id)
+    {
+        return m_fires[m_slotOfId[id]];
+    }
+
+    const BoidsFire& Get(uint32_t id) const
+    {
+        return m_fires[m_slotOfId[id]];
+    }
+
+    uint32_t GetN() const
+    {
+        return m_fires.size();
+    }
+
+    // Id que recibirá el próximo fuego
+    uint32_t GetNextId() const
+    {
+        return m_nextId;
+    }
+
+    // Los ids por debajo de nextId que no estén en el registro quedan como apagados
+    void SetNextId(uint32_t nextId);
+
+    bool IsEmpty() const
+    {
+        return m_fires.empty();
+    }
+
+    // Recorrido denso; el orden cambia al eliminar fuegos
+    std::vector<BoidsFire>::iterator begin()
+    {
+        return m_fires.begin();
+    }
+
+    std::vector<BoidsFire>::iterator end()
+    {
+        return m_fires.end();
+    }
+
+    std::vector<BoidsFire>::const_iterator begin() const
+    {
+        return m_fires.begin();
+    }
+
+    std::vector<BoidsFire>::const_iterator end() const
+    {
+        return m_fires.end();
+    }
+
+    /**
+     * Id del fuego más cercano a position (distancia envuelta) entre los que
+     * cumplen accept(fuego), o INVALID si no hay ninguno a menos de maxRadius.
+     */
+    template <typename F>
+    uint32_t FindNearest(const Vector& position, double maxRadius, F&& accept) const
+    {
+        uint32_t slot = m_grid.FindNearest(position.x, position.y, maxRadius, [&](uint32_t s) {
+            return accept(m_fires[s]);
+        });
+        return slot == INVALID ? INVALID : m_fires[slot].id;
+    }
+
+    uint32_t FindNearest(const Vector& position, double maxRadius = INFINITY) const
+    {
+        return FindNearest(position, maxRadius, [](const BoidsFire&) { return true; });
+    }
+
+    // Llama fn(fuego, dx, dy, dist2) para cada fuego a distancia < radius
+    template <typename F>
+    void ForEachInRadius(const Vector& position, double radius, F&& fn) const
+    {
+        m_grid.ForEachInRadius(position.x,
+                               position.y,
+                               radius,
+                               [&](uint32_t s, double dx, double dy, double d2) {
+                                   fn(m_fires[s], dx, dy, d2);
+                               });
+    }
+
+  private:
+    std::vector<BoidsFire> m_fires;   // Denso; la rejilla usa la posición como id
+    std::vector<uint32_t> m_slotOfId; // id -> posición en m_fires (INVALID si no existe)
+    uint32_t m_nextId;
+    BoidsSpatialGrid m_grid;
+};
+
+} // namespace ns3
+
+#endif /* BOIDS_FIRE_REGISTRY_H */
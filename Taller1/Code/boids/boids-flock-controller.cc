@@ -0,0 +1,547 @@
+#include "boids-flock-controller.h"
+
+#include "boids-flock-partition.h"
+#include "boids-mobility-model.h"
+
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+NS_LOG_COMPONENT_DEFINE("BoidsFlockController");
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED(BoidsFlockController);
+
+Ptr<BoidsFlockController> BoidsFlockController::s_instance = nullptr;
+
+TypeId
+BoidsFlockController::GetTypeId(void)
+{
+    static TypeId tid =
+        TypeId("ns3::BoidsFlockController")
+            .SetParent<Object>()
+            .SetGroupName("Mobility")
+            .AddConstructor<BoidsFlockController>()
+            .AddAttribute("TickInterval",
+                          "Periodo de actualización de la bandada. Las velocidades de los "
+                          "boids están expresadas en metros por tick.",
+                          TimeValue(MilliSeconds(100)),
+                          MakeTimeAccessor(&BoidsFlockController::m_tickInterval),
+                          MakeTimeChecker())
+            .AddAttribute("ElectionInterval",
+                          "Periodo de la elección de líderes WCA. Se redondea a un número "
+                          "entero de ticks (como mínimo uno).",
+                          TimeValue(MilliSeconds(100)),
+                          MakeTimeAccessor(&BoidsFlockController::m_electionInterval),
+                          MakeTimeChecker())
+            .AddAttribute("Threads",
+                          "Número de hilos para calcular el siguiente estado de la bandada. "
+                          "El resultado es idéntico para cualquier número de hilos.",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&BoidsFlockController::m_nThreads),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("SinglePrecision",
+                          "Acumular las reglas de los seguidores en precisión simple (el "
+                          "doble de carriles SIMD). Por defecto activado si se compila con "
+                          "BOIDS_FLOCK_FLOAT32.",
+                          BooleanValue(BOIDS_FLOCK_SINGLE_PRECISION),
+                          MakeBooleanAccessor(&BoidsFlockController::m_singlePrecision),
+                          MakeBooleanChecker())
+            .AddAttribute("VerletSkin",
+                          "Margen en metros de las listas de vecinos de las reglas: se "
+                          "construyen a radio + margen y se rehacen cuando algún boid se "
+                          "desplaza más de medio margen (0 consulta la rejilla en cada "
+                          "tick).",
+                          DoubleValue(20.0),
+                          MakeDoubleAccessor(&BoidsFlockController::m_verletSkin),
+                          MakeDoubleChecker<double>(0.0))
+            .AddTraceSource("FlockStats",
+                            "Resumen de la bandada al final de cada tick.",
+                            MakeTraceSourceAccessor(&BoidsFlockController::m_flockStatsTrace),
+                            "ns3::BoidsFlockController::FlockStatsCallback");
+    return tid;
+}
+
+Ptr<BoidsFlockController>
+BoidsFlockController::Get()
+{
+    if (!s_instance)
+    {
+        s_instance = CreateObject<BoidsFlockController>();
+        // Al destruir el simulador se descarta; la siguiente simulación crea otra
+        Simulator::ScheduleDestroy(&BoidsFlockController::DestroyInstance);
+    }
+    return s_instance;
+}
+
+void
+BoidsFlockController::DestroyInstance()
+{
+    if (s_instance)
+    {
+        s_instance->Dispose();
+        s_instance = nullptr;
+    }
+}
+
+BoidsFlockController::BoidsFlockController()
+    : m_tickInterval(MilliSeconds(100)),
+      m_electionInterval(MilliSeconds(100)),
+      m_electionCount(0),
+      m_tickCount(0),
+      m_stepCount(0),
+      m_inTick(false),
+      m_ticking(false),
+      m_startDeferred(false),
+      m_current(0),
+      m_gridCellSize(0.0),
+      m_verletSkin(20.0),
+      m_partition(nullptr),
+      m_singlePrecision(BOIDS_FLOCK_SINGLE_PRECISION),
+      m_nThreads(1)
+{
+}
+
+BoidsFlockController::~BoidsFlockController()
+{
+}
+
+void
+BoidsFlockController::DoDispose(void)
+{
+    m_tickEvent.Cancel();
+    m_boids.clear();
+    m_state[0].Clear();
+    m_state[1].Clear();
+    m_grid.Clear();
+    m_neighborLists.Clear();
+    m_halo.Clear();
+    m_haloGrid.Clear();
+    m_partition = nullptr;
+    m_contactStep.clear();
+    m_pool.reset();
+    Object::DoDispose();
+}
+
+void
+BoidsFlockController::Register(BoidsMobilityModel* boid)
+{
+    BoidsFlockState& state = GetState();
+    boid->m_boidIndex = state.Add();
+    GetNextState().Add();
+    m_boids.push_back(boid);
+    m_contactStep.push_back(0);
+    m_grid.Insert(boid->m_boidIndex, state.x[boid->m_boidIndex], state.y[boid->m_boidIndex]);
+    m_neighborLists.Invalidate();
+}
+
+void
+BoidsFlockController::Unregister(BoidsMobilityModel* boid)
+{
+    uint32_t index = boid->m_boidIndex;
+    if (index >= m_boids.size() || m_boids[index] != boid)
+    {
+        return;
+    }
+    NS_ASSERT_MSG(!m_inTick, "No se puede retirar un boid durante un tick");
+
+    // Eliminación O(1): el último boid ocupa el índice liberado
+    uint32_t lastIndex = m_boids.size() - 1;
+    BoidsMobilityModel* last = m_boids[lastIndex];
+    m_grid.Remove(index);
+    m_state[0].SwapRemove(index);
+    m_state[1].SwapRemove(index);
+    if (last != boid)
+    {
+        m_grid.Remove(lastIndex);
+        m_boids[index] = last;
+        last->m_boidIndex = index;
+        m_grid.Insert(index, GetState().x[index], GetState().y[index]);
+    }
+    m_boids.pop_back();
+    m_contactStep[index] = 0;
+    m_contactStep.pop_back();
+    boid->m_boidIndex = BoidsSpatialGrid::INVALID;
+    m_neighborLists.Invalidate();
+}
+
+void
+BoidsFlockController::Start()
+{
+    // Un boid creado durante un tick (p. ej. al llegar de otro rango) no programa
+    // otro: el siguiente se programa al acabar este
+    if (!m_startDeferred && !m_ticking && !m_tickEvent.IsPending())
+    {
+        m_tickEvent = Simulator::ScheduleNow(&BoidsFlockController::Tick, this);
+    }
+}
+
+void
+BoidsFlockController::DeferStart()
+{
+    m_startDeferred = true;
+    m_tickEvent.Cancel();
+}
+
+void
+BoidsFlockController::StartAt(Time delay)
+{
+    m_startDeferred = false;
+    m_tickEvent.Cancel();
+    m_tickEvent = Simulator::Schedule(delay, &BoidsFlockController::Tick, this);
+}
+
+void
+BoidsFlockController::SetPartition(BoidsFlockPartition* partition)
+{
+    m_partition = partition;
+    m_halo.Clear();
+    m_haloGrid.Clear();
+    if (m_partition)
+    {
+        Start();
+    }
+}
+
+bool
+BoidsFlockController::WasLeader(uint32_t index) const
+{
+    // Fuera de un tick el estado vigente es el del propio boid
+    if (!m_inTick)
+    {
+        return GetState().leader[index] != 0;
+    }
+    return m_prevLeader[index] != 0;
+}
+
+void
+BoidsFlockController::NotifyPositionChanged(uint32_t index, const Vector& position)
+{
+    m_grid.Move(index, position.x, position.y);
+}
+
+void
+BoidsFlockController::CheckFireContacts(bool sweep)
+{
+    const BoidsFireRegistry& registry = BoidsMobilityModel::GetFireRegistry();
+    for (uint32_t i = 0; i < m_boids.size() && !registry.IsEmpty(); ++i)
+    {
+        if ((!sweep && m_contactStep[i] > m_stepCount) || !m_boids[i]->IsLeader())
+        {
+            continue;
+        }
+        uint64_t steps = m_boids[i]->CheckFireContact();
+        m_contactStep[i] = steps == UINT64_MAX ? UINT64_MAX : m_stepCount + steps;
+        m_phaseTimes.contactChecks++;
+    }
+}
+
+void
+BoidsFlockController::InvalidateFireContact(uint32_t index)
+{
+    m_contactStep[index] = 0;
+}
+
+void
+BoidsFlockController::InvalidateFireContacts()
+{
+    std::fill(m_contactStep.begin(), m_contactStep.end(), 0);
+}
+
+void
+BoidsFlockController::EnsureThreadPool()
+{
+    uint32_t nThreads = std::max<uint32_t>(1, m_nThreads);
+    if (!m_pool || m_pool->GetNThreads() != nThreads)
+    {
+        m_pool = std::make_unique<BoidsThreadPool>(nThreads);
+        m_neighborBuffers.assign(nThreads, BoidsNeighborBuffer());
+        m_neighborBuffersF.assign(nThreads, BoidsNeighborBufferF());
+    }
+}
+
+void
+BoidsFlockController::RefreshSpatialGrid()
+{
+    // El tamaño de celda sigue al mayor radio de interacción entre todos los boids,
+    // así cada consulta visita como máximo 3x3 celdas
+    double cellSize = 0.0;
+    for (const BoidsMobilityModel* boid : m_boids)
+    {
+        cellSize = std::max(cellSize, boid->GetMaxInteractionRadius());
+    }
+    if (m_partition)
+    {
+        // Todos los rangos usan la misma celda, que es también el ancho del halo
+        cellSize = m_partition->AgreeCellSize(cellSize);
+    }
+    if (cellSize > 0.0 && cellSize != m_gridCellSize)
+    {
+        m_gridCellSize = cellSize;
+        m_grid.Configure(1000.0, 1000.0, cellSize);
+        m_haloGrid.Configure(1000.0, 1000.0, cellSize);
+    }
+}
+
+void
+BoidsFlockController::RefreshNeighborLists()
+{
+    if (m_verletSkin <= 0.0)
+    {
+        m_neighborLists.Invalidate();
+        return;
+    }
+    double radius = 0.0;
+    for (const BoidsMobilityModel* boid : m_boids)
+    {
+        radius = std::max(radius, boid->GetRuleRadius());
+    }
+    if (m_neighborLists.NeedsRebuild(GetState(), m_grid, radius, m_verletSkin))
+    {
+        m_neighborLists.Build(GetState(), m_grid, radius, m_verletSkin, *m_pool);
+        m_phaseTimes.neighborBuilds++;
+    }
+}
+
+bool
+BoidsFlockController::IsElectionTick() const
+{
+    int64_t period = std::max<int64_t>(
+        1,
+        std::llround(m_electionInterval.GetSeconds() / m_tickInterval.GetSeconds()));
+    return m_tickCount % period == 0;
+}
+
+void
+BoidsFlockController::RunElection()
+{
+    const uint32_t n = m_boids.size();
+
+    // Métricas y puntuación WCA de todos los boids en un barrido sobre la rejilla
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        m_boids[i]->UpdateWcaMetrics();
+    }
+
+    // Decisiones individuales: autopromoción por aislamiento y umbrales de puntuación
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        m_boids[i]->UpdateLeadership();
+    }
+
+    ResolveLeaderConflicts();
+
+    // Pertenencia a clusters con el conjunto final de líderes
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        m_boids[i]->UpdateClusterMembership();
+    }
+    m_phaseTimes.membership +=
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    m_electionCount++;
+}
+
+void
+BoidsFlockController::ResolveLeaderConflicts()
+{
+    // Los líderes se recorren de mayor a menor puntuación (a igualdad, por índice). Un
+    // líder deja de serlo si dentro de su radio de influencia ya quedó otro líder con
+    // puntuación estrictamente mayor; así el resultado no depende del orden de los nodos.
+    const BoidsFlockState& state = GetState();
+    std::vector<uint32_t> leaders;
+    for (uint32_t i = 0; i < m_boids.size(); ++i)
+    {
+        if (state.leader[i])
+        {
+            leaders.push_back(i);
+        }
+    }
+    std::sort(leaders.begin(), leaders.end(), [this](uint32_t a, uint32_t b) {
+        double sa = m_boids[a]->GetWcaScore();
+        double sb = m_boids[b]->GetWcaScore();
+        return sa != sb ? sa > sb : a < b;
+    });
+
+    std::vector<uint8_t> kept(m_boids.size(), 0);
+    for (uint32_t i : leaders)
+    {
+        BoidsMobilityModel* boid = m_boids[i];
+        double score = boid->GetWcaScore();
+        bool beaten = false;
+        m_grid.ForEachInRadius(state.x[i],
+                               state.y[i],
+                               boid->m_leaderInfluenceRadius,
+                               [&](uint32_t id, double dx, double dy, double d2) {
+                                   if (kept[id] && m_boids[id]->GetWcaScore() > score)
+                                   {
+                                       beaten = true;
+                                   }
+                               });
+        if (beaten)
+        {
+            boid->SetIsLeader(false);
+        }
+        else
+        {
+            kept[i] = 1;
+        }
+    }
+}
+
+BoidsFlockStats
+BoidsFlockController::ComputeStats() const
+{
+    const BoidsFlockState& state = GetState();
+    BoidsFlockStats stats;
+    stats.tick = m_tickCount;
+    stats.time = Simulator::Now();
+    stats.nBoids = m_boids.size();
+    stats.nLeaders = 0;
+    stats.nUnclustered = 0;
+    stats.nActiveFires = BoidsMobilityModel::GetFireRegistry().GetN();
+
+    double speed = 0.0;
+    double energy = 0.0;
+    double score = 0.0;
+    for (uint32_t i = 0; i < m_boids.size(); ++i)
+    {
+        if (state.leader[i])
+        {
+            stats.nLeaders++;
+        }
+        else if (state.cluster[i] < 0)
+        {
+            stats.nUnclustered++;
+        }
+        speed += std::sqrt(state.vx[i] * state.vx[i] + state.vy[i] * state.vy[i]);
+        energy += m_boids[i]->m_energy;
+        score += m_boids[i]->m_wcaScore;
+    }
+    double n = std::max<uint32_t>(1, m_boids.size());
+    stats.meanSpeed = speed / n;
+    stats.meanEnergy = energy / n;
+    stats.meanWcaScore = score / n;
+    return stats;
+}
+
+void
+BoidsFlockController::Tick()
+{
+    m_ticking = true;
+    RefreshSpatialGrid();
+    auto t0 = std::chrono::steady_clock::now();
+    if (m_partition)
+    {
+        m_partition->ExchangeHalo(*this);
+        auto t1 = std::chrono::steady_clock::now();
+        m_phaseTimes.exchange += std::chrono::duration<double>(t1 - t0).count();
+        t0 = t1;
+    }
+    const uint32_t n = m_boids.size();
+
+    // Instantánea del estado de líder al inicio del tick
+    m_prevLeader = GetState().leader;
+    m_inTick = true;
+    double membership = m_phaseTimes.membership;
+
+    // 1. Consumo de energía
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        m_boids[i]->ConsumeEnergy();
+    }
+
+    // 2. Elección de líderes sobre las posiciones del tick anterior
+    if (IsElectionTick())
+    {
+        RunElection();
+    }
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        m_boids[i]->UpdateWanderTarget();
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    // La pertenencia se mide aparte dentro de RunElection
+    m_phaseTimes.wca += std::chrono::duration<double>(t1 - t0).count() -
+                        (m_phaseTimes.membership - membership);
+    t0 = t1;
+
+    // 3. Siguiente estado: cada boid lee solo el buffer actual y escribe solo su
+    //    posición en el buffer siguiente, por lo que se reparte entre hilos sin
+    //    que el resultado dependa de su número
+    BoidsFlockState& next = GetNextState();
+    next.leader = GetState().leader;
+    next.cluster = GetState().cluster;
+    EnsureThreadPool();
+    RefreshNeighborLists();
+    t1 = std::chrono::steady_clock::now();
+    m_phaseTimes.neighbors += std::chrono::duration<double>(t1 - t0).count();
+    t0 = t1;
+    m_pool->ParallelFor(n, [this, &next](uint32_t begin, uint32_t end, uint32_t worker) {
+        if (m_singlePrecision)
+        {
+            BoidsNeighborBufferF& buffer = m_neighborBuffersF[worker];
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                m_boids[i]->ComputeNextState(buffer, next);
+            }
+            return;
+        }
+        BoidsNeighborBuffer& buffer = m_neighborBuffers[worker];
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            m_boids[i]->ComputeNextState(buffer, next);
+        }
+    });
+    t1 = std::chrono::steady_clock::now();
+    m_phaseTimes.rules += std::chrono::duration<double>(t1 - t0).count();
+    t0 = t1;
+
+    // 4. Intercambio de buffers y tareas secuenciales (rejilla, trazas y notificaciones)
+    m_current = 1 - m_current;
+    m_stepCount++;
+    m_inTick = false;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        m_boids[i]->CommitState();
+    }
+    if (m_partition)
+    {
+        // Los boids que salieron de la franja pasan a su rango antes de buscar
+        // contactos, y los fuegos apagados en cualquier rango se retiran en todos
+        t1 = std::chrono::steady_clock::now();
+        m_phaseTimes.commit += std::chrono::duration<double>(t1 - t0).count();
+        m_partition->Migrate(*this);
+        CheckFireContacts(false);
+        m_partition->ExchangeFires();
+        t0 = std::chrono::steady_clock::now();
+        m_phaseTimes.exchange += std::chrono::duration<double>(t0 - t1).count();
+    }
+    else
+    {
+        CheckFireContacts(false);
+    }
+    m_phaseTimes.commit +=
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    m_phaseTimes.ticks++;
+
+    if (!m_flockStatsTrace.IsEmpty())
+    {
+        m_flockStatsTrace(ComputeStats());
+    }
+
+    m_tickCount++;
+    m_ticking = false;
+    m_tickEvent = Simulator::Schedule(m_tickInterval, &BoidsFlockController::Tick, this);
+}
+
+} // namespace ns3
@@ -0,0 +1,287 @@
+#ifndef BOIDS_FLOCK_CONTROLLER_H
+#define BOIDS_FLOCK_CONTROLLER_H
+
+#include "boids-flock-state.h"
+#include "boids-neighbor-lists.h"
+#include "boids-spatial-grid.h"
+#include "boids-thread-pool.h"
+
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/traced-callback.h"
+#include "ns3/vector.h"
+
+#include <memory>
+#include <vector>
+
+namespace ns3
+{
+
+class BoidsFlockPartition;
+class BoidsMobilityModel;
+
+// Resumen de la bandada al final de un tick (fuente de traza FlockStats)
+struct BoidsFlockStats
+{
+    uint64_t tick;
+    Time time;
+    uint32_t nBoids;
+    uint32_t nLeaders;
+    uint32_t nUnclustered; // Seguidores sin cluster
+    uint32_t nActiveFires;
+    double meanSpeed;      // Metros por tick
+    double meanEnergy;
+    double meanWcaScore;
+};
+
+// Tiempo de reloj acumulado por fase del tick, en segundos
+struct BoidsFlockPhaseTimes
+{
+    double wca = 0.0;        // Energía, métricas, liderazgo y conflictos
+    double membership = 0.0; // Pertenencia a clusters
+    double rules = 0.0;      // Reglas de la bandada (paso paralelo)
+    double commit = 0.0;     // Rejilla, trazas y notificaciones
+    uint64_t ticks = 0;
+    uint64_t contactChecks = 0; // Búsquedas de fuego hechas para detectar contactos
+    double exchange = 0.0;      // Reparto entre rangos: halo, migración, contactos y fuegos
+    double neighbors = 0.0;     // Comprobación y reconstrucción de las listas de vecinos
+    uint64_t neighborBuilds = 0; // Reconstrucciones de las listas de vecinos
+};
+
+/**
+ * Controlador único de la bandada.
+ *
+ * En lugar de que cada boid se reprograme a sí mismo, un solo evento por tick
+ * actualiza a todos los boids registrados por fases:
+ *   1. consumo de energía de todos los boids,
+ *   2. cada ElectionInterval, elección WCA: métricas y puntuación de todos los
+ *      boids en un barrido, decisiones de liderazgo (leyendo el estado de líder al
+ *      inicio del tick), resolución global de conflictos entre líderes y
+ *      pertenencia a clusters,
+ *   3. cálculo del siguiente estado a partir del estado anterior (en paralelo),
+ *   4. intercambio de buffers y escritura de trazas.
+ * Así el resultado no depende del orden de los nodos ni del número de hilos.
+ *
+ * Contacto con fuegos: tras cada paso se comprueba si un líder ha entrado en el
+ * radio de un fuego, así que la extinción se detecta en el mismo tick. Cada líder
+ * solo se comprueba en el paso en que podría haber llegado al fuego más cercano
+ * (la distancia baja como mucho su velocidad máxima por paso); la predicción se
+ * anula al aparecer fuegos, al cambiar su liderazgo, su velocidad máxima o su
+ * posición, y BoidsMobilityModel::CheckFireProximity hace además un barrido de
+ * seguridad con todos los líderes a baja frecuencia.
+ *
+ * Listas de vecinos (VerletSkin): las reglas recorren una lista por boid con
+ * los vecinos a menos del radio de las reglas más un margen, construida desde
+ * la rejilla, que solo se rehace cuando algún boid se ha desplazado más de medio
+ * margen. Ver BoidsNeighborLists.
+ *
+ * Reparto entre rangos (SetPartition): cada rango calcula solo los boids de su
+ * franja del toro. Al inicio del tick recibe en un almacén aparte (halo) los
+ * boids de los rangos vecinos a menos de un radio de interacción de su franja,
+ * que las reglas, el grado WCA y el aislamiento ven como vecinos más; tras el
+ * paso los boids que salieron de la franja migran. Ver BoidsFlockPartition.
+ */
+class BoidsFlockController : public Object
+{
+  public:
+    static TypeId GetTypeId(void);
+
+    typedef void (*FlockStatsCallback)(const BoidsFlockStats& stats);
+
+    // Instancia compartida por todos los BoidsMobilityModel de la simulación
+    static Ptr<BoidsFlockController> Get();
+
+    BoidsFlockController();
+    virtual ~BoidsFlockController();
+
+    void Register(BoidsMobilityModel* boid);
+    void Unregister(BoidsMobilityModel* boid);
+
+    // Programa el primer tick si aún no hay uno pendiente (salvo con el arranque diferido)
+    void Start();
+
+    Time GetTickInterval() const
+    {
+        return m_tickInterval;
+    }
+
+    uint64_t GetTickCount() const
+    {
+        return m_tickCount;
+    }
+
+    Time GetElectionInterval() const
+    {
+        return m_electionInterval;
+    }
+
+    uint64_t GetElectionCount() const
+    {
+        return m_electionCount;
+    }
+
+    uint32_t GetNBoids() const
+    {
+        return m_boids.size();
+    }
+
+    BoidsMobilityModel* GetBoid(uint32_t index) const
+    {
+        return m_boids[index];
+    }
+
+    const BoidsSpatialGrid& GetSpatialGrid() const
+    {
+        return m_grid;
+    }
+
+    // Válidas durante el paso si VerletSkin > 0 (no incluyen el halo)
+    const BoidsNeighborLists& GetNeighborLists() const
+    {
+        return m_neighborLists;
+    }
+
+    // Boids de otros rangos junto a la franja (vacío sin reparto), al inicio del tick
+    const BoidsFlockState& GetHalo() const
+    {
+        return m_halo;
+    }
+
+    const BoidsSpatialGrid& GetHaloGrid() const
+    {
+        return m_haloGrid;
+    }
+
+    // Reparte la bandada entre rangos MPI (el llamador lo mantiene vivo; nullptr
+    // para volver a la bandada completa). Arranca los ticks: todos los rangos
+    // deben ejecutar los mismos, tengan boids o no.
+    void SetPartition(BoidsFlockPartition* partition);
+
+    BoidsFlockPartition* GetPartition() const
+    {
+        return m_partition;
+    }
+
+    // Almacén SoA de posición, velocidad, líder y cluster de todos los boids (buffer vigente)
+    BoidsFlockState& GetState()
+    {
+        return m_state[m_current];
+    }
+
+    const BoidsFlockState& GetState() const
+    {
+        return m_state[m_current];
+    }
+
+    uint32_t GetNThreads() const
+    {
+        return m_nThreads;
+    }
+
+    bool IsSinglePrecision() const
+    {
+        return m_singlePrecision;
+    }
+
+    // Estado de líder de un boid al inicio del tick en curso
+    bool WasLeader(uint32_t index) const;
+
+    // Mantiene la rejilla al día cuando cambia la posición de un boid
+    void NotifyPositionChanged(uint32_t index, const Vector& position);
+
+    // Apaga los fuegos al alcance de los líderes cuya predicción de contacto
+    // vence en este paso, o de todos los líderes si sweep
+    void CheckFireContacts(bool sweep);
+    // El líder se comprueba en el próximo paso
+    void InvalidateFireContact(uint32_t index);
+    // Todos los líderes se comprueban en el próximo paso (p. ej. al aparecer un fuego)
+    void InvalidateFireContacts();
+
+    // Resumen del estado vigente (lo que se emite por FlockStats)
+    BoidsFlockStats ComputeStats() const;
+
+    const BoidsFlockPhaseTimes& GetPhaseTimes() const
+    {
+        return m_phaseTimes;
+    }
+
+    void ResetPhaseTimes()
+    {
+        m_phaseTimes = BoidsFlockPhaseTimes();
+    }
+
+  private:
+    virtual void DoDispose(void);
+    void Tick();
+    bool IsElectionTick() const;
+    void RunElection();
+    void ResolveLeaderConflicts();
+    void RefreshSpatialGrid();
+    void RefreshNeighborLists();
+    void EnsureThreadPool();
+    static void DestroyInstance();
+
+    // Restauración de checkpoints: Start() no hace nada hasta StartAt()
+    friend class BoidsCheckpoint;
+    friend class BoidsFlockPartition;
+    void DeferStart();
+    void StartAt(Time delay);
+
+    BoidsFlockState& GetNextState()
+    {
+        return m_state[1 - m_current];
+    }
+
+    Time m_tickInterval;
+    Time m_electionInterval;
+    uint64_t m_electionCount;
+    EventId m_tickEvent;
+    uint64_t m_tickCount;
+    uint64_t m_stepCount; // Pasos aplicados al buffer vigente
+    bool m_inTick;
+    bool m_ticking; // Dentro de Tick(); m_inTick acaba con el paso
+    bool m_startDeferred;
+
+    std::vector<BoidsMobilityModel*> m_boids; // Indexados por BoidsMobilityModel::m_boidIndex
+    BoidsFlockState m_state[2];               // Doble buffer, mismo índice que m_boids
+    uint32_t m_current;                       // Buffer con el estado vigente
+    BoidsSpatialGrid m_grid;
+    double m_gridCellSize;
+
+    // Listas de vecinos de Verlet de las reglas (margen en metros, 0 = rejilla)
+    double m_verletSkin;
+    BoidsNeighborLists m_neighborLists;
+
+    // Reparto entre rangos: boids vecinos de otros rangos, con su propia rejilla
+    BoidsFlockPartition* m_partition;
+    BoidsFlockState m_halo;
+    BoidsSpatialGrid m_haloGrid;
+
+    // Estado de líder al inicio del tick
+    std::vector<uint8_t> m_prevLeader;
+
+    // Paso a partir del cual cada líder puede estar al alcance de un fuego
+    std::vector<uint64_t> m_contactStep;
+
+    // Precisión de la acumulación de reglas (SinglePrecision)
+    bool m_singlePrecision;
+
+    // Paso paralelo: un buffer de vecinos por hilo (en la precisión elegida)
+    uint32_t m_nThreads;
+    std::unique_ptr<BoidsThreadPool> m_pool;
+    std::vector<BoidsNeighborBuffer> m_neighborBuffers;
+    std::vector<BoidsNeighborBufferF> m_neighborBuffersF;
+
+    // Solo se calcula si hay algo conectado
+    TracedCallback<const BoidsFlockStats&> m_flockStatsTrace;
+
+    BoidsFlockPhaseTimes m_phaseTimes;
+
+    static Ptr<BoidsFlockController> s_instance;
+};
+
+} // namespace ns3
+
+#endif /* BOIDS_FLOCK_CONTROLLER_H */
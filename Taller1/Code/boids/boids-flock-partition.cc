@@ -0,0 +1,369 @@
+#include "boids-flock-partition.h"
+
+#include "boids-flock-controller.h"
+#include "boids-mobility-model.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+
+#ifdef NS3_MPI
+#include "ns3/mpi-interface.h"
+
+#include <mpi.h>
+#endif
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+NS_LOG_COMPONENT_DEFINE("BoidsFlockPartition");
+
+namespace ns3
+{
+
+// Etiquetas de los mensajes entre vecinos (cada Shift usa la suya y la siguiente)
+static const int HALO_TO_LEFT_TAG = 100;
+static const int HALO_TO_RIGHT_TAG = 102;
+
+BoidsFlockPartition::BoidsFlockPartition()
+    : m_rank(0),
+      m_nRanks(1),
+      m_width(1000.0),
+      m_hostStream(-1),
+      m_emigrants(0),
+      m_haloRecords(0)
+{
+#ifdef NS3_MPI
+    if (MpiInterface::IsEnabled())
+    {
+        m_rank = MpiInterface::GetSystemId();
+        m_nRanks = MpiInterface::GetSize();
+    }
+#endif
+    m_left = (m_rank + m_nRanks - 1) % m_nRanks;
+    m_right = (m_rank + 1) % m_nRanks;
+}
+
+bool
+BoidsFlockPartition::IsAvailable()
+{
+#ifdef NS3_MPI
+    return true;
+#else
+    return false;
+#endif
+}
+
+double
+BoidsFlockPartition::GetStripBegin() const
+{
+    return m_width * m_rank / m_nRanks;
+}
+
+double
+BoidsFlockPartition::GetStripEnd() const
+{
+    return m_width * (m_rank + 1) / m_nRanks;
+}
+
+uint32_t
+BoidsFlockPartition::GetOwner(double x) const
+{
+    // Misma frontera que GetStripBegin/End; las posiciones ya están en [0, ancho)
+    double wrapped = x - m_width * std::floor(x / m_width);
+    uint32_t owner = static_cast<uint32_t>(wrapped * m_nRanks / m_width);
+    return std::min(owner, m_nRanks - 1);
+}
+
+template <typename T>
+void
+BoidsFlockPartition::Shift(const std::vector<T>& send,
+                           uint32_t to,
+                           std::vector<T>& recv,
+                           uint32_t from,
+                           int tag) const
+{
+#ifdef NS3_MPI
+    MPI_Comm comm = MpiInterface::GetCommunicator();
+    uint64_t sendCount = send.size();
+    uint64_t recvCount = 0;
+    MPI_Sendrecv(&sendCount, 1, MPI_UINT64_T, to, tag, &recvCount, 1, MPI_UINT64_T, from, tag,
+                 comm, MPI_STATUS_IGNORE);
+    NS_ABORT_MSG_IF(std::max(sendCount, recvCount) * sizeof(T) > INT_MAX,
+                    "Mensaje entre rangos de más de 2 GB");
+    recv.resize(recvCount);
+    MPI_Sendrecv(send.data(), static_cast<int>(sendCount * sizeof(T)), MPI_BYTE, to, tag + 1,
+                 recv.data(), static_cast<int>(recvCount * sizeof(T)), MPI_BYTE, from, tag + 1,
+                 comm, MPI_STATUS_IGNORE);
+#else
+    recv.clear();
+#endif
+}
+
+double
+BoidsFlockPartition::AgreeCellSize(double cellSize) const
+{
+    return MaxAll(cellSize);
+}
+
+void
+BoidsFlockPartition::ExchangeHalo(BoidsFlockController& flock)
+{
+    BoidsFlockState& halo = flock.m_halo;
+    halo.Clear();
+    flock.m_haloGrid.Clear();
+    if (m_nRanks < 2)
+    {
+        return;
+    }
+
+    // Un boid a más de un radio de interacción de la frontera no es vecino de
+    // nadie del otro lado; el halo solo llega a los rangos contiguos
+    const double band = flock.m_gridCellSize;
+    const double begin = GetStripBegin();
+    const double end = GetStripEnd();
+    NS_ABORT_MSG_IF(band > end - begin,
+                    "Franjas de " << end - begin << " m más estrechas que el halo (" << band
+                                  << " m): use menos rangos");
+
+    const BoidsFlockState& state = flock.GetState();
+    m_haloLeft.clear();
+    m_haloRight.clear();
+    for (uint32_t i = 0; i < state.GetN(); ++i)
+    {
+        BoidsHaloRecord r = {state.x[i], state.y[i], state.vx[i], state.vy[i], state.leader[i], 0};
+        bool toLeft = state.x[i] < begin + band;
+        bool toRight = state.x[i] >= end - band;
+        if (toLeft)
+        {
+            m_haloLeft.push_back(r);
+        }
+        // Con dos rangos ambos vecinos son el mismo: cada boid se envía una vez
+        if (toRight && !(toLeft && m_left == m_right))
+        {
+            m_haloRight.push_back(r);
+        }
+    }
+
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        if (pass == 0)
+        {
+            Shift(m_haloLeft, m_left, m_haloIn, m_right, HALO_TO_LEFT_TAG);
+        }
+        else
+        {
+            Shift(m_haloRight, m_right, m_haloIn, m_left, HALO_TO_RIGHT_TAG);
+        }
+        for (const BoidsHaloRecord& r : m_haloIn)
+        {
+            uint32_t id = halo.Add();
+            halo.x[id] = r.x;
+            halo.y[id] = r.y;
+            halo.vx[id] = r.vx;
+            halo.vy[id] = r.vy;
+            halo.leader[id] = r.leader;
+            flock.m_haloGrid.Insert(id, r.x, r.y);
+        }
+        m_haloRecords += m_haloIn.size();
+    }
+}
+
+BoidsMobilityModel*
+BoidsFlockPartition::AcquireHost(BoidsFlockController& flock)
+{
+    if (!m_hosts.empty())
+    {
+        Ptr<BoidsMobilityModel> host = m_hosts.back();
+        m_hosts.pop_back();
+        flock.Register(PeekPointer(host));
+        return PeekPointer(host);
+    }
+    // El modelo se registra al construirse; su nodo lo mantiene vivo
+    Ptr<Node> node = CreateObject<Node>();
+    Ptr<BoidsMobilityModel> host = CreateObject<BoidsMobilityModel>();
+    node->AggregateObject(host);
+    if (m_hostStream >= 0)
+    {
+        m_hostStream += host->AssignStreams(m_hostStream);
+    }
+    // Se inicializa ahora y no en el evento que programa el nodo, para que la
+    // velocidad que sortea DoInitialize no pise después el registro migrado
+    node->Initialize();
+    return PeekPointer(host);
+}
+
+void
+BoidsFlockPartition::Migrate(BoidsFlockController& flock)
+{
+    if (m_nRanks < 2)
+    {
+        return;
+    }
+
+    // Boids fuera de la franja, agrupados por rango de destino
+    const BoidsFlockState& state = flock.GetState();
+    std::vector<std::pair<uint32_t, BoidsMobilityModel*>> leaving;
+    for (uint32_t i = 0; i < state.GetN(); ++i)
+    {
+        uint32_t owner = GetOwner(state.x[i]);
+        if (owner != m_rank)
+        {
+            leaving.emplace_back(owner, flock.GetBoid(i));
+        }
+    }
+    std::stable_sort(leaving.begin(), leaving.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+
+    std::vector<int> sendBytes(m_nRanks, 0);
+    m_migrantsOut.resize(leaving.size());
+    for (uint32_t k = 0; k < leaving.size(); ++k)
+    {
+        BoidsMobilityModel* boid = leaving[k].second;
+        BoidsCheckpoint::SaveBoid(boid, m_migrantsOut[k]);
+        m_migrantsOut[k].nodeId = boid->GetBoidId();
+        sendBytes[leaving[k].first] += sizeof(BoidsCheckpointBoid);
+    }
+    // Los clusters son de cada rango: el boid deja el suyo y el modelo queda libre
+    BoidsClusterTable& table = BoidsMobilityModel::s_clusterTable;
+    for (const auto& [owner, boid] : leaving)
+    {
+        if (table.IsConfigured())
+        {
+            table.Remove(boid->GetBoidsNode()->GetId());
+        }
+        flock.Unregister(boid);
+        m_hosts.push_back(boid);
+    }
+    m_emigrants += leaving.size();
+
+#ifdef NS3_MPI
+    MPI_Comm comm = MpiInterface::GetCommunicator();
+    std::vector<int> recvBytes(m_nRanks, 0);
+    MPI_Alltoall(sendBytes.data(), 1, MPI_INT, recvBytes.data(), 1, MPI_INT, comm);
+    std::vector<int> sendOffsets(m_nRanks, 0);
+    std::vector<int> recvOffsets(m_nRanks, 0);
+    for (uint32_t r = 1; r < m_nRanks; ++r)
+    {
+        sendOffsets[r] = sendOffsets[r - 1] + sendBytes[r - 1];
+        recvOffsets[r] = recvOffsets[r - 1] + recvBytes[r - 1];
+    }
+    m_migrantsIn.resize((recvOffsets.back() + recvBytes.back()) / sizeof(BoidsCheckpointBoid));
+    MPI_Alltoallv(m_migrantsOut.data(), sendBytes.data(), sendOffsets.data(), MPI_BYTE,
+                  m_migrantsIn.data(), recvBytes.data(), recvOffsets.data(), MPI_BYTE, comm);
+#else
+    m_migrantsIn.clear();
+#endif
+
+    for (const BoidsCheckpointBoid& r : m_migrantsIn)
+    {
+        BoidsMobilityModel* boid = AcquireHost(flock);
+        BoidsCheckpoint::ApplyBoid(boid, r, false);
+        boid->m_boidId = r.nodeId;
+        flock.GetState().cluster[boid->m_boidIndex] = BoidsClusterTable::NONE;
+    }
+}
+
+void
+BoidsFlockPartition::RecordExtinction(uint32_t fireId, Time duration)
+{
+    m_extinctions.emplace_back(fireId, duration.GetNanoSeconds());
+}
+
+void
+BoidsFlockPartition::ExchangeFires()
+{
+    if (m_nRanks < 2)
+    {
+        m_extinctions.clear();
+        return;
+    }
+
+    std::vector<uint32_t> local;
+    for (const auto& extinction : m_extinctions)
+    {
+        local.push_back(extinction.first);
+    }
+    std::vector<int> counts(m_nRanks, 0);
+    std::vector<uint32_t> all;
+#ifdef NS3_MPI
+    MPI_Comm comm = MpiInterface::GetCommunicator();
+    int count = local.size();
+    MPI_Allgather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT, comm);
+    std::vector<int> offsets(m_nRanks, 0);
+    for (uint32_t r = 1; r < m_nRanks; ++r)
+    {
+        offsets[r] = offsets[r - 1] + counts[r - 1];
+    }
+    all.resize(offsets.back() + counts.back());
+    MPI_Allgatherv(local.data(), count, MPI_UINT32_T, all.data(), counts.data(), offsets.data(),
+                   MPI_UINT32_T, comm);
+#endif
+
+    BoidsFireRegistry& registry = BoidsMobilityModel::s_fireRegistry;
+    for (uint32_t r = 0, k = 0; r < m_nRanks; ++r)
+    {
+        for (int j = 0; j < counts[r]; ++j, ++k)
+        {
+            uint32_t fireId = all[k];
+            if (r == m_rank || registry.Remove(fireId))
+            {
+                continue;
+            }
+            // Este rango también lo apagó en el mismo intervalo: cuenta el de menor rango
+            auto mine = std::find_if(m_extinctions.begin(),
+                                     m_extinctions.end(),
+                                     [fireId](const auto& e) { return e.first == fireId; });
+            if (r < m_rank && mine != m_extinctions.end())
+            {
+                BoidsMobilityModel::s_totalFiresExtinguished -= 1;
+                BoidsMobilityModel::s_totalExtinctionTime -= NanoSeconds(mine->second);
+                m_extinctions.erase(mine);
+            }
+        }
+    }
+    m_extinctions.clear();
+}
+
+uint64_t
+BoidsFlockPartition::SumAll(uint64_t value) const
+{
+    uint64_t total = value;
+#ifdef NS3_MPI
+    if (m_nRanks > 1)
+    {
+        MPI_Allreduce(&value, &total, 1, MPI_UINT64_T, MPI_SUM, MpiInterface::GetCommunicator());
+    }
+#endif
+    return total;
+}
+
+double
+BoidsFlockPartition::SumAll(double value) const
+{
+    double total = value;
+#ifdef NS3_MPI
+    if (m_nRanks > 1)
+    {
+        MPI_Allreduce(&value, &total, 1, MPI_DOUBLE, MPI_SUM, MpiInterface::GetCommunicator());
+    }
+#endif
+    return total;
+}
+
+double
+BoidsFlockPartition::MaxAll(double value) const
+{
+    double result = value;
+#ifdef NS3_MPI
+    if (m_nRanks > 1)
+    {
+        MPI_Allreduce(&value, &result, 1, MPI_DOUBLE, MPI_MAX, MpiInterface::GetCommunicator());
+    }
+#endif
+    return result;
+}
+
+} // namespace ns3
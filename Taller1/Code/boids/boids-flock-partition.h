@@ -0,0 +1,151 @@
+#ifndef BOIDS_FLOCK_PARTITION_H
+#define BOIDS_FLOCK_PARTITION_H
+
+#include "boids-checkpoint.h"
+
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+class BoidsFlockController;
+class BoidsMobilityModel;
+
+// Boid de un rango vecino tal como lo ven las reglas al inicio del tick
+struct BoidsHaloRecord
+{
+    double x;
+    double y;
+    double vx;
+    double vy;
+    uint32_t leader;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(BoidsHaloRecord) == 40, "registro de halo de 40 bytes");
+
+/**
+ * Reparto espacial de la bandada entre rangos MPI.
+ *
+ * El toro se divide en franjas verticales del mismo ancho, una por rango, y cada
+ * rango solo calcula los boids de la suya. En cada tick, dentro de
+ * BoidsFlockController::Tick:
+ *   - halo (ExchangeHalo): antes de la elección cada rango envía a sus dos
+ *     vecinos los boids a menos de un ancho de halo de la frontera común. El
+ *     ancho es el mayor radio de interacción de todos los rangos (el tamaño de
+ *     celda de la rejilla), así que reglas, grado WCA y aislamiento ven a todos
+ *     sus vecinos reales,
+ *   - migración (Migrate): tras el paso, los boids que salieron de la franja se
+ *     envían al rango que la contiene con su registro de checkpoint y se alojan en
+ *     un modelo libre de ese rango (o en un nodo nuevo si no hay ninguno),
+ *   - fuegos (ExchangeFires): el registro está replicado, porque todos los rangos
+ *     repiten la misma línea temporal o sortean con los mismos streams; los fuegos
+ *     apagados en cada rango se retiran en todos y, si dos rangos apagan el mismo
+ *     fuego en un tick, solo lo cuenta el de menor rango.
+ *
+ * Lo que no cruza las franjas: la resolución de conflictos entre líderes y los
+ * clusters son de cada rango (un boid que migra deja su cluster y se une a uno
+ * del nuevo rango en la siguiente elección) y los generadores por boid son los
+ * del modelo que lo aloja. El resultado es reproducible para un mismo número de
+ * rangos, pero no idéntico al de un solo proceso.
+ *
+ * Todos los rangos deben ejecutar los mismos ticks: las llamadas son colectivas.
+ * Sin soporte MPI (NS3_MPI) hay un solo rango y todas las operaciones son nulas.
+ */
+class BoidsFlockPartition
+{
+  public:
+    BoidsFlockPartition();
+
+    // Si se compiló con MPI
+    static bool IsAvailable();
+
+    uint32_t GetRank() const
+    {
+        return m_rank;
+    }
+
+    uint32_t GetNRanks() const
+    {
+        return m_nRanks;
+    }
+
+    // Franja [GetStripBegin(), GetStripEnd()) del eje x que calcula este rango
+    double GetStripBegin() const;
+    double GetStripEnd() const;
+
+    // Rango que calcula la posición x
+    uint32_t GetOwner(double x) const;
+
+    // Primer stream de los modelos creados para alojar boids que llegan (dos por
+    // modelo); -1 deja que ns-3 los asigne
+    void SetHostStream(int64_t stream)
+    {
+        m_hostStream = stream;
+    }
+
+    // Llamadas de BoidsFlockController::Tick
+    double AgreeCellSize(double cellSize) const;
+    void ExchangeHalo(BoidsFlockController& flock);
+    void Migrate(BoidsFlockController& flock);
+    void ExchangeFires();
+
+    // Fuego apagado en este rango desde el último ExchangeFires
+    void RecordExtinction(uint32_t fireId, Time duration);
+
+    // Reducciones entre todos los rangos (colectivas)
+    uint64_t SumAll(uint64_t value) const;
+    double SumAll(double value) const;
+    double MaxAll(double value) const;
+
+    uint64_t GetEmigrants() const
+    {
+        return m_emigrants;
+    }
+
+    uint64_t GetHaloRecords() const
+    {
+        return m_haloRecords;
+    }
+
+  private:
+    // Envía 'send' a 'to' y recibe en 'recv' lo que envía 'from'
+    template <typename T>
+    void Shift(const std::vector<T>& send,
+               uint32_t to,
+               std::vector<T>& recv,
+               uint32_t from,
+               int tag) const;
+    BoidsMobilityModel* AcquireHost(BoidsFlockController& flock);
+
+    uint32_t m_rank;
+    uint32_t m_nRanks;
+    uint32_t m_left;  // Rango de la franja anterior (con envolvimiento)
+    uint32_t m_right; // Rango de la franja siguiente
+    double m_width;   // Mismo mundo que la rejilla del controlador
+    int64_t m_hostStream;
+
+    // Buffers reutilizados entre ticks
+    std::vector<BoidsHaloRecord> m_haloLeft;
+    std::vector<BoidsHaloRecord> m_haloRight;
+    std::vector<BoidsHaloRecord> m_haloIn;
+    std::vector<BoidsCheckpointBoid> m_migrantsOut;
+    std::vector<BoidsCheckpointBoid> m_migrantsIn;
+
+    // Modelos sin boid (emigrados) que alojan a los siguientes que lleguen
+    std::vector<Ptr<BoidsMobilityModel>> m_hosts;
+
+    std::vector<std::pair<uint32_t, int64_t>> m_extinctions; // (fuego, duración en ns)
+
+    uint64_t m_emigrants;
+    uint64_t m_haloRecords; // Registros de halo recibidos
+};
+
+} // namespace ns3
+
+#endif /* BOIDS_FLOCK_PARTITION_H */
@@ -0,0 +1,372 @@
+#include "boids-flock-state.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include <cmath>
+
+namespace ns3
+{
+
+uint32_t
+BoidsFlockState::Add()
+{
+    uint32_t i = x.size();
+    x.push_back(0.0);
+    y.push_back(0.0);
+    vx.push_back(0.0);
+    vy.push_back(0.0);
+    leader.push_back(0);
+    cluster.push_back(-1);
+    return i;
+}
+
+void
+BoidsFlockState::SwapRemove(uint32_t i)
+{
+    uint32_t last = x.size() - 1;
+    x[i] = x[last];
+    y[i] = y[last];
+    vx[i] = vx[last];
+    vy[i] = vy[last];
+    leader[i] = leader[last];
+    cluster[i] = cluster[last];
+    Resize(last);
+}
+
+void
+BoidsFlockState::Resize(uint32_t n)
+{
+    x.resize(n, 0.0);
+    y.resize(n, 0.0);
+    vx.resize(n, 0.0);
+    vy.resize(n, 0.0);
+    leader.resize(n, 0);
+    cluster.resize(n, -1);
+}
+
+void
+BoidsFlockState::Clear()
+{
+    Resize(0);
+}
+
+namespace
+{
+
+// Vecino individual; también procesa la cola que no llena un registro vectorial.
+// Las distancias se calculan en la precisión del buffer, como en los carriles
+template <typename T>
+inline void
+AccumulateOne(const BoidsNeighborBufferT<T>& nb,
+              uint32_t i,
+              const BoidsRuleRadii& radii,
+              BoidsRuleSums& sums)
+{
+    T dx = nb.dx[i];
+    T dy = nb.dy[i];
+    T d2 = dx * dx + dy * dy;
+
+    // 1. Separación: alejarse de los vecinos muy cercanos
+    if (d2 > 0 && d2 < T(radii.separation * radii.separation))
+    {
+        T d = std::sqrt(d2);
+        sums.separationX -= dx / d;
+        sums.separationY -= dy / d;
+    }
+    // 2. Alineación
+    if (d2 < T(radii.alignment * radii.alignment))
+    {
+        sums.alignmentX += nb.vx[i];
+        sums.alignmentY += nb.vy[i];
+        sums.alignmentCount++;
+    }
+    // 3. Cohesión
+    if (d2 < T(radii.cohesion * radii.cohesion))
+    {
+        sums.cohesionDx += dx;
+        sums.cohesionDy += dy;
+        sums.cohesionCount++;
+    }
+    // 4. Atracción a líderes
+    if (nb.leader[i] != T(0) && d2 < T(radii.leaderInfluence * radii.leaderInfluence))
+    {
+        sums.leaderX += nb.vx[i];
+        sums.leaderY += nb.vy[i];
+        sums.leaderCount++;
+    }
+}
+
+} // namespace
+
+BoidsRuleSums
+BoidsAccumulateRules(const BoidsNeighborBuffer& nb, const BoidsRuleRadii& radii)
+{
+    BoidsRuleSums sums;
+    const uint32_t n = nb.GetN();
+    uint32_t i = 0;
+
+#if defined(__AVX2__)
+    {
+        const __m256d zero = _mm256_setzero_pd();
+        const __m256d one = _mm256_set1_pd(1.0);
+        const __m256d sep2 = _mm256_set1_pd(radii.separation * radii.separation);
+        const __m256d ali2 = _mm256_set1_pd(radii.alignment * radii.alignment);
+        const __m256d coh2 = _mm256_set1_pd(radii.cohesion * radii.cohesion);
+        const __m256d lead2 = _mm256_set1_pd(radii.leaderInfluence * radii.leaderInfluence);
+
+        __m256d sepX = zero, sepY = zero, aliX = zero, aliY = zero;
+        __m256d cohX = zero, cohY = zero, leadX = zero, leadY = zero;
+
+        for (; i + 4 <= n; i += 4)
+        {
+            __m256d dx = _mm256_loadu_pd(&nb.dx[i]);
+            __m256d dy = _mm256_loadu_pd(&nb.dy[i]);
+            __m256d vx = _mm256_loadu_pd(&nb.vx[i]);
+            __m256d vy = _mm256_loadu_pd(&nb.vy[i]);
+            __m256d isLeader = _mm256_loadu_pd(&nb.leader[i]);
+            __m256d d2 = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+
+            __m256d mSep = _mm256_and_pd(_mm256_cmp_pd(d2, sep2, _CMP_LT_OQ),
+                                         _mm256_cmp_pd(d2, zero, _CMP_GT_OQ));
+            // En los carriles sin separación se divide por 1 para no generar NaN
+            __m256d d = _mm256_blendv_pd(one, _mm256_sqrt_pd(d2), mSep);
+            sepX = _mm256_sub_pd(sepX, _mm256_and_pd(mSep, _mm256_div_pd(dx, d)));
+            sepY = _mm256_sub_pd(sepY, _mm256_and_pd(mSep, _mm256_div_pd(dy, d)));
+
+            __m256d mAli = _mm256_cmp_pd(d2, ali2, _CMP_LT_OQ);
+            aliX = _mm256_add_pd(aliX, _mm256_and_pd(mAli, vx));
+            aliY = _mm256_add_pd(aliY, _mm256_and_pd(mAli, vy));
+            sums.alignmentCount += __builtin_popcount(_mm256_movemask_pd(mAli));
+
+            __m256d mCoh = _mm256_cmp_pd(d2, coh2, _CMP_LT_OQ);
+            cohX = _mm256_add_pd(cohX, _mm256_and_pd(mCoh, dx));
+            cohY = _mm256_add_pd(cohY, _mm256_and_pd(mCoh, dy));
+            sums.cohesionCount += __builtin_popcount(_mm256_movemask_pd(mCoh));
+
+            __m256d mLead = _mm256_and_pd(_mm256_cmp_pd(d2, lead2, _CMP_LT_OQ),
+                                          _mm256_cmp_pd(isLeader, zero, _CMP_NEQ_OQ));
+            leadX = _mm256_add_pd(leadX, _mm256_and_pd(mLead, vx));
+            leadY = _mm256_add_pd(leadY, _mm256_and_pd(mLead, vy));
+            sums.leaderCount += __builtin_popcount(_mm256_movemask_pd(mLead));
+        }
+
+        double lanes[4];
+        auto reduce = [&lanes](__m256d v) {
+            _mm256_storeu_pd(lanes, v);
+            return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+        };
+        sums.separationX = reduce(sepX);
+        sums.separationY = reduce(sepY);
+        sums.alignmentX = reduce(aliX);
+        sums.alignmentY = reduce(aliY);
+        sums.cohesionDx = reduce(cohX);
+        sums.cohesionDy = reduce(cohY);
+        sums.leaderX = reduce(leadX);
+        sums.leaderY = reduce(leadY);
+    }
+#elif defined(__SSE2__)
+    {
+        const __m128d zero = _mm_setzero_pd();
+        const __m128d one = _mm_set1_pd(1.0);
+        const __m128d sep2 = _mm_set1_pd(radii.separation * radii.separation);
+        const __m128d ali2 = _mm_set1_pd(radii.alignment * radii.alignment);
+        const __m128d coh2 = _mm_set1_pd(radii.cohesion * radii.cohesion);
+        const __m128d lead2 = _mm_set1_pd(radii.leaderInfluence * radii.leaderInfluence);
+
+        __m128d sepX = zero, sepY = zero, aliX = zero, aliY = zero;
+        __m128d cohX = zero, cohY = zero, leadX = zero, leadY = zero;
+
+        for (; i + 2 <= n; i += 2)
+        {
+            __m128d dx = _mm_loadu_pd(&nb.dx[i]);
+            __m128d dy = _mm_loadu_pd(&nb.dy[i]);
+            __m128d vx = _mm_loadu_pd(&nb.vx[i]);
+            __m128d vy = _mm_loadu_pd(&nb.vy[i]);
+            __m128d isLeader = _mm_loadu_pd(&nb.leader[i]);
+            __m128d d2 = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+
+            __m128d mSep = _mm_and_pd(_mm_cmplt_pd(d2, sep2), _mm_cmpgt_pd(d2, zero));
+            // En los carriles sin separación se divide por 1 para no generar NaN
+            __m128d d = _mm_or_pd(_mm_and_pd(mSep, _mm_sqrt_pd(d2)), _mm_andnot_pd(mSep, one));
+            sepX = _mm_sub_pd(sepX, _mm_and_pd(mSep, _mm_div_pd(dx, d)));
+            sepY = _mm_sub_pd(sepY, _mm_and_pd(mSep, _mm_div_pd(dy, d)));
+
+            __m128d mAli = _mm_cmplt_pd(d2, ali2);
+            aliX = _mm_add_pd(aliX, _mm_and_pd(mAli, vx));
+            aliY = _mm_add_pd(aliY, _mm_and_pd(mAli, vy));
+            sums.alignmentCount += __builtin_popcount(_mm_movemask_pd(mAli));
+
+            __m128d mCoh = _mm_cmplt_pd(d2, coh2);
+            cohX = _mm_add_pd(cohX, _mm_and_pd(mCoh, dx));
+            cohY = _mm_add_pd(cohY, _mm_and_pd(mCoh, dy));
+            sums.cohesionCount += __builtin_popcount(_mm_movemask_pd(mCoh));
+
+            __m128d mLead = _mm_and_pd(_mm_cmplt_pd(d2, lead2), _mm_cmpneq_pd(isLeader, zero));
+            leadX = _mm_add_pd(leadX, _mm_and_pd(mLead, vx));
+            leadY = _mm_add_pd(leadY, _mm_and_pd(mLead, vy));
+            sums.leaderCount += __builtin_popcount(_mm_movemask_pd(mLead));
+        }
+
+        double lanes[2];
+        auto reduce = [&lanes](__m128d v) {
+            _mm_storeu_pd(lanes, v);
+            return lanes[0] + lanes[1];
+        };
+        sums.separationX = reduce(sepX);
+        sums.separationY = reduce(sepY);
+        sums.alignmentX = reduce(aliX);
+        sums.alignmentY = reduce(aliY);
+        sums.cohesionDx = reduce(cohX);
+        sums.cohesionDy = reduce(cohY);
+        sums.leaderX = reduce(leadX);
+        sums.leaderY = reduce(leadY);
+    }
+#endif
+
+    for (; i < n; ++i)
+    {
+        AccumulateOne(nb, i, radii, sums);
+    }
+    return sums;
+}
+
+BoidsRuleSums
+BoidsAccumulateRules(const BoidsNeighborBufferF& nb, const BoidsRuleRadii& radii)
+{
+    BoidsRuleSums sums;
+    const uint32_t n = nb.GetN();
+    uint32_t i = 0;
+
+#if defined(__AVX2__)
+    {
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 sep2 = _mm256_set1_ps(float(radii.separation * radii.separation));
+        const __m256 ali2 = _mm256_set1_ps(float(radii.alignment * radii.alignment));
+        const __m256 coh2 = _mm256_set1_ps(float(radii.cohesion * radii.cohesion));
+        const __m256 lead2 = _mm256_set1_ps(float(radii.leaderInfluence * radii.leaderInfluence));
+
+        __m256 sepX = zero, sepY = zero, aliX = zero, aliY = zero;
+        __m256 cohX = zero, cohY = zero, leadX = zero, leadY = zero;
+
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256 dx = _mm256_loadu_ps(&nb.dx[i]);
+            __m256 dy = _mm256_loadu_ps(&nb.dy[i]);
+            __m256 vx = _mm256_loadu_ps(&nb.vx[i]);
+            __m256 vy = _mm256_loadu_ps(&nb.vy[i]);
+            __m256 isLeader = _mm256_loadu_ps(&nb.leader[i]);
+            __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+
+            __m256 mSep = _mm256_and_ps(_mm256_cmp_ps(d2, sep2, _CMP_LT_OQ),
+                                        _mm256_cmp_ps(d2, zero, _CMP_GT_OQ));
+            // En los carriles sin separación se divide por 1 para no generar NaN
+            __m256 d = _mm256_blendv_ps(one, _mm256_sqrt_ps(d2), mSep);
+            sepX = _mm256_sub_ps(sepX, _mm256_and_ps(mSep, _mm256_div_ps(dx, d)));
+            sepY = _mm256_sub_ps(sepY, _mm256_and_ps(mSep, _mm256_div_ps(dy, d)));
+
+            __m256 mAli = _mm256_cmp_ps(d2, ali2, _CMP_LT_OQ);
+            aliX = _mm256_add_ps(aliX, _mm256_and_ps(mAli, vx));
+            aliY = _mm256_add_ps(aliY, _mm256_and_ps(mAli, vy));
+            sums.alignmentCount += __builtin_popcount(_mm256_movemask_ps(mAli));
+
+            __m256 mCoh = _mm256_cmp_ps(d2, coh2, _CMP_LT_OQ);
+            cohX = _mm256_add_ps(cohX, _mm256_and_ps(mCoh, dx));
+            cohY = _mm256_add_ps(cohY, _mm256_and_ps(mCoh, dy));
+            sums.cohesionCount += __builtin_popcount(_mm256_movemask_ps(mCoh));
+
+            __m256 mLead = _mm256_and_ps(_mm256_cmp_ps(d2, lead2, _CMP_LT_OQ),
+                                         _mm256_cmp_ps(isLeader, zero, _CMP_NEQ_OQ));
+            leadX = _mm256_add_ps(leadX, _mm256_and_ps(mLead, vx));
+            leadY = _mm256_add_ps(leadY, _mm256_and_ps(mLead, vy));
+            sums.leaderCount += __builtin_popcount(_mm256_movemask_ps(mLead));
+        }
+
+        float lanes[8];
+        auto reduce = [&lanes](__m256 v) {
+            _mm256_storeu_ps(lanes, v);
+            double total = 0.0;
+            for (float lane : lanes)
+            {
+                total += lane;
+            }
+            return total;
+        };
+        sums.separationX = reduce(sepX);
+        sums.separationY = reduce(sepY);
+        sums.alignmentX = reduce(aliX);
+        sums.alignmentY = reduce(aliY);
+        sums.cohesionDx = reduce(cohX);
+        sums.cohesionDy = reduce(cohY);
+        sums.leaderX = reduce(leadX);
+        sums.leaderY = reduce(leadY);
+    }
+#elif defined(__SSE2__)
+    {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 sep2 = _mm_set1_ps(float(radii.separation * radii.separation));
+        const __m128 ali2 = _mm_set1_ps(float(radii.alignment * radii.alignment));
+        const __m128 coh2 = _mm_set1_ps(float(radii.cohesion * radii.cohesion));
+        const __m128 lead2 = _mm_set1_ps(float(radii.leaderInfluence * radii.leaderInfluence));
+
+        __m128 sepX = zero, sepY = zero, aliX = zero, aliY = zero;
+        __m128 cohX = zero, cohY = zero, leadX = zero, leadY = zero;
+
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128 dx = _mm_loadu_ps(&nb.dx[i]);
+            __m128 dy = _mm_loadu_ps(&nb.dy[i]);
+            __m128 vx = _mm_loadu_ps(&nb.vx[i]);
+            __m128 vy = _mm_loadu_ps(&nb.vy[i]);
+            __m128 isLeader = _mm_loadu_ps(&nb.leader[i]);
+            __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+
+            __m128 mSep = _mm_and_ps(_mm_cmplt_ps(d2, sep2), _mm_cmpgt_ps(d2, zero));
+            // En los carriles sin separación se divide por 1 para no generar NaN
+            __m128 d = _mm_or_ps(_mm_and_ps(mSep, _mm_sqrt_ps(d2)), _mm_andnot_ps(mSep, one));
+            sepX = _mm_sub_ps(sepX, _mm_and_ps(mSep, _mm_div_ps(dx, d)));
+            sepY = _mm_sub_ps(sepY, _mm_and_ps(mSep, _mm_div_ps(dy, d)));
+
+            __m128 mAli = _mm_cmplt_ps(d2, ali2);
+            aliX = _mm_add_ps(aliX, _mm_and_ps(mAli, vx));
+            aliY = _mm_add_ps(aliY, _mm_and_ps(mAli, vy));
+            sums.alignmentCount += __builtin_popcount(_mm_movemask_ps(mAli));
+
+            __m128 mCoh = _mm_cmplt_ps(d2, coh2);
+            cohX = _mm_add_ps(cohX, _mm_and_ps(mCoh, dx));
+            cohY = _mm_add_ps(cohY, _mm_and_ps(mCoh, dy));
+            sums.cohesionCount += __builtin_popcount(_mm_movemask_ps(mCoh));
+
+            __m128 mLead = _mm_and_ps(_mm_cmplt_ps(d2, lead2), _mm_cmpneq_ps(isLeader, zero));
+            leadX = _mm_add_ps(leadX, _mm_and_ps(mLead, vx));
+            leadY = _mm_add_ps(leadY, _mm_and_ps(mLead, vy));
+            sums.leaderCount += __builtin_popcount(_mm_movemask_ps(mLead));
+        }
+
+        float lanes[4];
+        auto reduce = [&lanes](__m128 v) {
+            _mm_storeu_ps(lanes, v);
+            return (double(lanes[0]) + lanes[1]) + (double(lanes[2]) + lanes[3]);
+        };
+        sums.separationX = reduce(sepX);
+        sums.separationY = reduce(sepY);
+        sums.alignmentX = reduce(aliX);
+        sums.alignmentY = reduce(aliY);
+        sums.cohesionDx = reduce(cohX);
+        sums.cohesionDy = reduce(cohY);
+        sums.leaderX = reduce(leadX);
+        sums.leaderY = reduce(leadY);
+    }
+#endif
+
+    for (; i < n; ++i)
+    {
+        AccumulateOne(nb, i, radii, sums);
+    }
+    return sums;
+}
+
+} // namespace ns3
@@ -0,0 +1,129 @@
+#ifndef BOIDS_FLOCK_STATE_H
+#define BOIDS_FLOCK_STATE_H
+
+#include <cstdint>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Estado de la bandada en formato estructura-de-arreglos (SoA).
+ *
+ * Cada boid ocupa el mismo índice en todos los arreglos (BoidsMobilityModel::m_boidIndex),
+ * de modo que los kernels de reglas recorren memoria contigua en lugar de saltar entre
+ * objetos ns-3. Los BoidsMobilityModel son vistas sobre este almacén.
+ */
+struct BoidsFlockState
+{
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> vx; // Velocidad en metros por tick
+    std::vector<double> vy;
+    std::vector<uint8_t> leader;
+    std::vector<int32_t> cluster; // Índice del cluster (-1 si no pertenece a ninguno)
+
+    uint32_t GetN() const
+    {
+        return x.size();
+    }
+
+    // Añade un boid al final y devuelve su índice
+    uint32_t Add();
+
+    // Elimina el boid i moviendo el último a su lugar (O(1))
+    void SwapRemove(uint32_t i);
+
+    void Resize(uint32_t n);
+    void Clear();
+};
+
+/**
+ * Vecinos de un boid reunidos de forma contigua para los kernels vectoriales.
+ * Los desplazamientos (dx, dy) van del boid consultado hacia el vecino, ya envueltos.
+ * Con T = float cada registro vectorial procesa el doble de vecinos; el estado
+ * de la bandada sigue en double y solo se reducen los desplazamientos relativos,
+ * que caben de sobra en precisión simple a la escala de los radios de las reglas.
+ */
+template <typename T>
+struct BoidsNeighborBufferT
+{
+    std::vector<T> dx;
+    std::vector<T> dy;
+    std::vector<T> vx;
+    std::vector<T> vy;
+    std::vector<T> leader; // 1 si el vecino es líder, 0 si no
+
+    uint32_t GetN() const
+    {
+        return dx.size();
+    }
+
+    void Clear()
+    {
+        dx.clear();
+        dy.clear();
+        vx.clear();
+        vy.clear();
+        leader.clear();
+    }
+
+    void Push(double ndx, double ndy, double nvx, double nvy, bool isLeader)
+    {
+        dx.push_back(static_cast<T>(ndx));
+        dy.push_back(static_cast<T>(ndy));
+        vx.push_back(static_cast<T>(nvx));
+        vy.push_back(static_cast<T>(nvy));
+        leader.push_back(isLeader ? T(1) : T(0));
+    }
+};
+
+typedef BoidsNeighborBufferT<double> BoidsNeighborBuffer;
+typedef BoidsNeighborBufferT<float> BoidsNeighborBufferF;
+
+// Precisión del paso por defecto (atributo SinglePrecision de BoidsFlockController)
+#ifdef BOIDS_FLOCK_FLOAT32
+static const bool BOIDS_FLOCK_SINGLE_PRECISION = true;
+#else
+static const bool BOIDS_FLOCK_SINGLE_PRECISION = false;
+#endif
+
+// Radios de las reglas de un seguidor
+struct BoidsRuleRadii
+{
+    double separation;
+    double alignment;
+    double cohesion;
+    double leaderInfluence;
+};
+
+// Sumas de las cuatro reglas sobre los vecinos de un boid
+struct BoidsRuleSums
+{
+    double separationX = 0.0;
+    double separationY = 0.0;
+    double alignmentX = 0.0;
+    double alignmentY = 0.0;
+    double cohesionDx = 0.0; // Suma de desplazamientos hacia los vecinos de cohesión
+    double cohesionDy = 0.0;
+    double leaderX = 0.0;
+    double leaderY = 0.0;
+    uint32_t alignmentCount = 0;
+    uint32_t cohesionCount = 0;
+    uint32_t leaderCount = 0;
+};
+
+/**
+ * Acumula separación, alineación, cohesión y atracción a líderes sobre los vecinos
+ * del buffer. Usa AVX2 o SSE2 cuando el compilador los habilita y un bucle escalar
+ * para el resto. La versión float opera en precisión simple (8 carriles con AVX2,
+ * 4 con SSE2) y reduce los carriles en double.
+ */
+BoidsRuleSums BoidsAccumulateRules(const BoidsNeighborBuffer& neighbors,
+                                   const BoidsRuleRadii& radii);
+BoidsRuleSums BoidsAccumulateRules(const BoidsNeighborBufferF& neighbors,
+                                   const BoidsRuleRadii& radii);
+
+} // namespace ns3
+
+#endif /* BOIDS_FLOCK_STATE_H */
@@ -0,0 +1,220 @@
+#include "boids-helper.h"
+
+#include "boids-mobility-model.h"
+
+#include "ns3/callback.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+int64_t
+BoidsHelper::AssignStreams(NodeContainer c, int64_t stream)
+{
+    int64_t currentStream = stream;
+    if (!m_fireStreamsAssigned)
+    {
+        currentStream += BoidsMobilityModel::AssignFireStreams(currentStream);
+        m_fireStreamsAssigned = true;
+    }
+    for (NodeContainer::Iterator i = c.Begin(); i != c.End(); ++i)
+    {
+        Ptr<BoidsMobilityModel> model = (*i)->GetObject<BoidsMobilityModel>();
+        if (model)
+        {
+            currentStream += model->AssignStreams(currentStream);
+        }
+    }
+    return (currentStream - stream);
+}
+
+uint32_t
+BoidsTraceCounters::GetMaxLeaders() const
+{
+    return std::max(m_maxLeaders, leaders);
+}
+
+void
+BoidsTraceCounters::ResetLeaders(uint32_t nLeaders)
+{
+    leaders = nLeaders;
+    m_maxLeaders = 0;
+    m_leadersTime = Simulator::Now();
+}
+
+void
+BoidsTraceCounters::SettleLeaders()
+{
+    if (Simulator::Now() != m_leadersTime)
+    {
+        m_maxLeaders = std::max(m_maxLeaders, leaders);
+        m_leadersTime = Simulator::Now();
+    }
+}
+
+void
+BoidsTraceCounters::LeadershipChanged(uint32_t nodeId, bool isLeader, double wcaScore)
+{
+    SettleLeaders();
+    if (isLeader)
+    {
+        promotions++;
+        leaders++;
+    }
+    else
+    {
+        demotions++;
+        leaders--;
+    }
+}
+
+void
+BoidsTraceCounters::FireExtinguished(uint32_t fireId,
+                                     uint32_t nodeId,
+                                     Vector position,
+                                     Time duration)
+{
+    firesExtinguished++;
+    extinctionTime += duration;
+}
+
+void
+BoidsTraceCounters::ClusterChanged(uint32_t nodeId, int32_t oldCluster, int32_t newCluster)
+{
+    clusterChanges++;
+}
+
+Ptr<BoidsTraceCounters>
+BoidsHelper::EnableCounters(NodeContainer c)
+{
+    if (!m_counters)
+    {
+        m_counters = Create<BoidsTraceCounters>();
+    }
+    for (NodeContainer::Iterator i = c.Begin(); i != c.End(); ++i)
+    {
+        Ptr<BoidsMobilityModel> model = (*i)->GetObject<BoidsMobilityModel>();
+        if (!model)
+        {
+            continue;
+        }
+        if (model->IsLeader())
+        {
+            m_counters->leaders++;
+        }
+        model->TraceConnectWithoutContext(
+            "LeadershipChanged",
+            MakeCallback(&BoidsTraceCounters::LeadershipChanged, m_counters));
+        model->TraceConnectWithoutContext(
+            "FireExtinguished",
+            MakeCallback(&BoidsTraceCounters::FireExtinguished, m_counters));
+        model->TraceConnectWithoutContext(
+            "ClusterChanged",
+            MakeCallback(&BoidsTraceCounters::ClusterChanged, m_counters));
+    }
+    return m_counters;
+}
+
+Ptr<BoidsStreamingMetrics>
+BoidsHelper::EnableMetrics(NodeContainer c)
+{
+    if (!m_metrics)
+    {
+        m_metrics = Create<BoidsStreamingMetrics>();
+        BoidsFlockController::Get()->TraceConnectWithoutContext(
+            "FlockStats",
+            MakeCallback(&BoidsStreamingMetrics::FlockStats, m_metrics));
+    }
+    for (NodeContainer::Iterator i = c.Begin(); i != c.End(); ++i)
+    {
+        Ptr<BoidsMobilityModel> model = (*i)->GetObject<BoidsMobilityModel>();
+        if (!model)
+        {
+            continue;
+        }
+        model->TraceConnectWithoutContext(
+            "LeadershipChanged",
+            MakeCallback(&BoidsStreamingMetrics::LeadershipChanged, m_metrics));
+        model->TraceConnectWithoutContext(
+            "FireExtinguished",
+            MakeCallback(&BoidsStreamingMetrics::FireExtinguished, m_metrics));
+    }
+    return m_metrics;
+}
+
+void
+BoidsHelper::EnableAsciiTrace(Ptr<OutputStreamWrapper> stream, NodeContainer c)
+{
+    if (!m_asciiStatsConnected)
+    {
+        BoidsFlockController::Get()->TraceConnectWithoutContext(
+            "FlockStats",
+            MakeBoundCallback(&BoidsHelper::AsciiFlockStats, stream));
+        m_asciiStatsConnected = true;
+    }
+    for (NodeContainer::Iterator i = c.Begin(); i != c.End(); ++i)
+    {
+        Ptr<BoidsMobilityModel> model = (*i)->GetObject<BoidsMobilityModel>();
+        if (!model)
+        {
+            continue;
+        }
+        model->TraceConnectWithoutContext(
+            "LeadershipChanged",
+            MakeBoundCallback(&BoidsHelper::AsciiLeadershipChanged, stream));
+        model->TraceConnectWithoutContext(
+            "FireExtinguished",
+            MakeBoundCallback(&BoidsHelper::AsciiFireExtinguished, stream));
+        model->TraceConnectWithoutContext(
+            "ClusterChanged",
+            MakeBoundCallback(&BoidsHelper::AsciiClusterChanged, stream));
+    }
+}
+
+void
+BoidsHelper::AsciiLeadershipChanged(Ptr<OutputStreamWrapper> stream,
+                                    uint32_t nodeId,
+                                    bool isLeader,
+                                    double wcaScore)
+{
+    *stream->GetStream() << Simulator::Now().GetSeconds() << " LeadershipChanged node=" << nodeId
+                         << " leader=" << isLeader << " score=" << wcaScore << "\n";
+}
+
+void
+BoidsHelper::AsciiFireExtinguished(Ptr<OutputStreamWrapper> stream,
+                                   uint32_t fireId,
+                                   uint32_t nodeId,
+                                   Vector position,
+                                   Time duration)
+{
+    *stream->GetStream() << Simulator::Now().GetSeconds() << " FireExtinguished fire=" << fireId
+                         << " node=" << nodeId << " x=" << position.x << " y=" << position.y
+                         << " duration=" << duration.GetSeconds() << "\n";
+}
+
+void
+BoidsHelper::AsciiClusterChanged(Ptr<OutputStreamWrapper> stream,
+                                 uint32_t nodeId,
+                                 int32_t oldCluster,
+                                 int32_t newCluster)
+{
+    *stream->GetStream() << Simulator::Now().GetSeconds() << " ClusterChanged node=" << nodeId
+                         << " from=" << oldCluster << " to=" << newCluster << "\n";
+}
+
+void
+BoidsHelper::AsciiFlockStats(Ptr<OutputStreamWrapper> stream, const BoidsFlockStats& stats)
+{
+    *stream->GetStream() << stats.time.GetSeconds() << " FlockStats tick=" << stats.tick
+                         << " boids=" << stats.nBoids << " leaders=" << stats.nLeaders
+                         << " unclustered=" << stats.nUnclustered
+                         << " fires=" << stats.nActiveFires << " speed=" << stats.meanSpeed
+                         << " energy=" << stats.meanEnergy << " score=" << stats.meanWcaScore
+                         << "\n";
+}
+
+} // namespace ns3
@@ -0,0 +1,121 @@
+#ifndef BOIDS_HELPER_H
+#define BOIDS_HELPER_H
+
+#include "boids-flock-controller.h"
+#include "boids-streaming-metrics.h"
+
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/output-stream-wrapper.h"
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/vector.h"
+
+#include <cstdint>
+
+namespace ns3
+{
+
+/**
+ * Contadores alimentados por las fuentes de traza de los boids.
+ *
+ * No usan FlockStats del controlador: con esa traza conectada cada tick
+ * recorre toda la bandada.
+ */
+class BoidsTraceCounters : public SimpleRefCount<BoidsTraceCounters>
+{
+  public:
+    uint64_t promotions = 0; // Nodos que pasaron a ser líderes
+    uint64_t demotions = 0;  // Líderes que dejaron de serlo
+    uint64_t clusterChanges = 0;
+    uint64_t firesExtinguished = 0;
+    Time extinctionTime;     // Suma de las duraciones de los fuegos apagados
+    uint32_t leaders = 0;    // Líderes actuales entre los nodos conectados
+
+    /**
+     * Máximo de líderes al final de cada instante simulado. Una elección puede
+     * promover y hacer renunciar a varios nodos en el mismo tick; solo cuenta el
+     * número con el que queda el tick, como en FlockStats.
+     */
+    uint32_t GetMaxLeaders() const;
+
+    // Fija el número de líderes actual y el máximo (tras restaurar un checkpoint)
+    void ResetLeaders(uint32_t nLeaders);
+
+    void LeadershipChanged(uint32_t nodeId, bool isLeader, double wcaScore);
+    void FireExtinguished(uint32_t fireId, uint32_t nodeId, Vector position, Time duration);
+    void ClusterChanged(uint32_t nodeId, int32_t oldCluster, int32_t newCluster);
+
+  private:
+    // Lleva a m_maxLeaders el número de líderes de instantes anteriores al actual
+    void SettleLeaders();
+
+    uint32_t m_maxLeaders = 0; // Máximo hasta m_leadersTime, sin contar ese instante
+    Time m_leadersTime;        // Instante del último cambio de liderazgo
+};
+
+/**
+ * Utilidades para configurar una simulación de boids.
+ */
+class BoidsHelper
+{
+  public:
+    /**
+     * Fija los streams de los generadores aleatorios de todos los BoidsMobilityModel
+     * de los nodos y, la primera vez, los de los fuegos (compartidos por la clase).
+     * Con el mismo stream y la misma semilla la ejecución es reproducible.
+     *
+     * \param c nodos con BoidsMobilityModel instalado
+     * \param stream primer stream a usar
+     * \return número de streams usados
+     */
+    int64_t AssignStreams(NodeContainer c, int64_t stream);
+
+    /**
+     * Conecta las fuentes de traza de los nodos a unos contadores compartidos por
+     * todas las llamadas. Los nodos que ya son líderes cuentan como líderes actuales.
+     *
+     * \return los contadores, que se actualizan durante la simulación
+     */
+    Ptr<BoidsTraceCounters> EnableCounters(NodeContainer c);
+
+    /**
+     * Como EnableCounters, pero con las métricas de BoidsStreamingMetrics
+     * (cuantiles de latencia de extinción, serie por muestra y rotación de
+     * liderazgo).
+     *
+     * \return las métricas, compartidas por todas las llamadas
+     */
+    Ptr<BoidsStreamingMetrics> EnableMetrics(NodeContainer c);
+
+    /**
+     * Escribe en el flujo una línea por evento: "<tiempo> <fuente> campo=valor ...".
+     * FlockStats se conecta solo en la primera llamada.
+     */
+    void EnableAsciiTrace(Ptr<OutputStreamWrapper> stream, NodeContainer c);
+
+  private:
+    static void AsciiLeadershipChanged(Ptr<OutputStreamWrapper> stream,
+                                       uint32_t nodeId,
+                                       bool isLeader,
+                                       double wcaScore);
+    static void AsciiFireExtinguished(Ptr<OutputStreamWrapper> stream,
+                                      uint32_t fireId,
+                                      uint32_t nodeId,
+                                      Vector position,
+                                      Time duration);
+    static void AsciiClusterChanged(Ptr<OutputStreamWrapper> stream,
+                                    uint32_t nodeId,
+                                    int32_t oldCluster,
+                                    int32_t newCluster);
+    static void AsciiFlockStats(Ptr<OutputStreamWrapper> stream, const BoidsFlockStats& stats);
+
+    bool m_fireStreamsAssigned = false;
+    Ptr<BoidsTraceCounters> m_counters;
+    Ptr<BoidsStreamingMetrics> m_metrics;
+    bool m_asciiStatsConnected = false;
+};
+
+} // namespace ns3
+
+#endif /* BOIDS_HELPER_H */
@@ -1,5 +1,12 @@
 #include "boids-mobility-model.h"
 
+#include "boids-fire-assignment.h"
+#include "boids-fire-registry.h"
+#include "boids-flock-controller.h"
+#include "boids-flock-partition.h"
+#include "boids-trace-format.h"
+#include "boids-trace-writer.h"
+
 #include "ns3/boolean.h"
 #include "ns3/double.h"
 #include "ns3/log.h"
@@ -10,8 +17,11 @@
 #include "ns3/ptr.h"
 #include "ns3/random-variable-stream.h"
 #include "ns3/simulator.h"
+#include "ns3/uinteger.h"
 #include "ns3/vector.h"
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <vector>
 
@@ -24,83 +34,34 @@ namespace ns3
 
 NS_OBJECT_ENSURE_REGISTERED(BoidsMobilityModel);
 
+// Radio de normalización de la distancia a objetivos en la puntuación WCA (m)
+static const double WCA_TARGET_RADIUS = 200.0;
+
 // Inicialización de variables estáticas
-std::vector<Vector> BoidsMobilityModel::s_fires;
-Ptr<UniformRandomVariable> BoidsMobilityModel::s_fireRng = CreateObject<UniformRandomVariable>();
+BoidsFireRegistry BoidsMobilityModel::s_fireRegistry;
+BoidsFireAssigner BoidsMobilityModel::s_fireAssigner;
+BoidsCountedRng<UniformRandomVariable> BoidsMobilityModel::s_fireRng;
+BoidsCountedRng<NormalRandomVariable> BoidsMobilityModel::s_fireOffsetRng;
+EventId BoidsMobilityModel::s_fireEvent;
+EventId BoidsMobilityModel::s_checkFireEvent;
+EventId BoidsMobilityModel::s_assignEvent;
 Time BoidsMobilityModel::s_fireInterval = Seconds(8);
+Time BoidsMobilityModel::s_fireSweepInterval = Seconds(10);
 double BoidsMobilityModel::s_fireRadius = 30.0;
+BoidsPointProcess BoidsMobilityModel::s_fireProcess;
+std::vector<Vector> BoidsMobilityModel::s_fireBatch;
+const BoidsFireTimeline* BoidsMobilityModel::s_fireTimeline = nullptr;
+uint64_t BoidsMobilityModel::s_fireTimelineCursor = 0;
 
 // Variables estáticas de metras
-std::map<Vector, Time> BoidsMobilityModel::s_fireStartTimes;
 uint32_t BoidsMobilityModel::s_totalFiresExtinguished = 0;
 Time BoidsMobilityModel::s_totalExtinctionTime = Seconds(0);
 
-std::vector<NodeContainer>* BoidsMobilityModel::s_clusters = nullptr;
-NodeContainer* BoidsMobilityModel::s_chNodes = nullptr;
+BoidsClusterTable BoidsMobilityModel::s_clusterTable;
 
 // Variable estática para el archivo de salida
 std::ofstream* BoidsMobilityModel::s_outFile = nullptr;
-
-std::vector<Vector> BoidsMobilityModel::getSpotsPoissonSpacial(
-    uint32_t n, double areaX, double areaY, 
-    uint32_t k, double desviacion)
-{
-    std::vector<Vector> focos;
-    
-    // 1. Generar k centros de clúster (uniformemente en el área)
-    Ptr<UniformRandomVariable> ux = CreateObject<UniformRandomVariable>();
-    Ptr<UniformRandomVariable> uy = CreateObject<UniformRandomVariable>();
-    ux->SetAttribute("Min", DoubleValue(0.0));
-    ux->SetAttribute("Max", DoubleValue(areaX));
-    uy->SetAttribute("Min", DoubleValue(0.0));
-    uy->SetAttribute("Max", DoubleValue(areaY));
-    
-    std::vector<Vector> centros;
-    for (uint32_t i = 0; i < k; ++i) {
-        centros.push_back(Vector(ux->GetValue(), uy->GetValue(), 0.0));
-    }
-    
-    // 2. Repartir n focos en los clústeres
-    uint32_t promedioPorCluster = n / k;
-    
-    for (uint32_t i = 0; i < k; ++i) {
-        Ptr<NormalRandomVariable> dx = CreateObject<NormalRandomVariable>();
-        Ptr<NormalRandomVariable> dy = CreateObject<NormalRandomVariable>();
-        dx->SetAttribute("Mean", DoubleValue(0.0)); // Centrado en el cluster
-        dx->SetAttribute("Variance", DoubleValue(desviacion * desviacion));
-        dy->SetAttribute("Mean", DoubleValue(0.0));
-        dy->SetAttribute("Variance", DoubleValue(desviacion * desviacion));
-        
-        for (uint32_t j = 0; j < promedioPorCluster; ++j) {
-            double x = centros[i].x + dx->GetValue();
-            double y = centros[i].y + dy->GetValue();
-            
-            // Recortar si se sale del área
-            x = std::max(0.0, std::min(x, areaX));
-            y = std::max(0.0, std::min(y, areaY));
-            
-            focos.push_back(Vector(x, y, 0.0));
-        }
-    }
-    
-    // 3. Si falta alguno por redondeo, añade desde clúster 0
-    while (focos.size() < n) {
-        Ptr<NormalRandomVariable> dx = CreateObject<NormalRandomVariable>();
-        Ptr<NormalRandomVariable> dy = CreateObject<NormalRandomVariable>();
-        dx->SetAttribute("Mean", DoubleValue(0.0));
-        dx->SetAttribute("Variance", DoubleValue(desviacion * desviacion));
-        dy->SetAttribute("Mean", DoubleValue(0.0));
-        dy->SetAttribute("Variance", DoubleValue(desviacion * desviacion));
-        
-        double x = centros[0].x + dx->GetValue();
-        double y = centros[0].y + dy->GetValue();
-        x = std::max(0.0, std::min(x, areaX));
-        y = std::max(0.0, std::min(y, areaY));
-        focos.push_back(Vector(x, y, 0.0));
-    }
-    
-    return focos;
-}
+BoidsTraceWriter* BoidsMobilityModel::s_traceWriter = nullptr;
 
 TypeId
 BoidsMobilityModel::GetTypeId(void)
@@ -135,10 +96,18 @@ BoidsMobilityModel::GetTypeId(void)
                           DoubleValue(5.0),
                           MakeDoubleAccessor(&BoidsMobilityModel::m_maxSpeed),
                           MakeDoubleChecker<double>())
+            .AddAttribute("BoidId",
+                          "Identificador del boid en la traza de posiciones. Por defecto "
+                          "el NodeId; con la bandada repartida entre rangos lo fija "
+                          "BoidsFlockPartition y viaja con el boid al migrar.",
+                          UintegerValue(BoidsSpatialGrid::INVALID),
+                          MakeUintegerAccessor(&BoidsMobilityModel::m_boidId),
+                          MakeUintegerChecker<uint32_t>())
             .AddAttribute("IsLeader",
                           "Si el nodo es un líder.",
                           BooleanValue(false),
-                          MakeBooleanAccessor(&BoidsMobilityModel::m_isLeader),
+                          MakeBooleanAccessor(&BoidsMobilityModel::SetLeaderFlag,
+                                              &BoidsMobilityModel::IsLeader),
                           MakeBooleanChecker())
             .AddAttribute("FireInterval",
                           "Intervalo entre aparición de nuevos fuegos.",
@@ -151,7 +120,21 @@ BoidsMobilityModel::GetTypeId(void)
                           DoubleValue(30.0),
                           MakeDoubleAccessor(&BoidsMobilityModel::GetFireRadius,
                                              &BoidsMobilityModel::SetFireRadius),
-                          MakeDoubleChecker<double>());
+                          MakeDoubleChecker<double>())
+            .AddTraceSource("LeadershipChanged",
+                            "El nodo pasa a ser líder o deja de serlo.",
+                            MakeTraceSourceAccessor(
+                                &BoidsMobilityModel::m_leadershipChangedTrace),
+                            "ns3::BoidsMobilityModel::LeadershipChangedCallback")
+            .AddTraceSource("FireExtinguished",
+                            "Este líder apagó un fuego.",
+                            MakeTraceSourceAccessor(
+                                &BoidsMobilityModel::m_fireExtinguishedTrace),
+                            "ns3::BoidsMobilityModel::FireExtinguishedCallback")
+            .AddTraceSource("ClusterChanged",
+                            "El seguidor cambió de cluster (-1 si queda sin cluster).",
+                            MakeTraceSourceAccessor(&BoidsMobilityModel::m_clusterChangedTrace),
+                            "ns3::BoidsMobilityModel::ClusterChangedCallback");
     return tid;
 }
 
@@ -161,23 +144,125 @@ BoidsMobilityModel::BoidsMobilityModel()
       m_cohesionRadius(50.0),
       m_leaderInfluenceRadius(100.0),
       m_maxSpeed(5.0),
-      m_isLeader(false)
+      m_energy(1.0),
+      m_degree(0.0),
+      m_distanceToTargets(0.0),
+      m_mobility(0.0),
+      m_wcaScore(0.0),
+      m_assignedFire(BoidsFireRegistry::INVALID),
+      m_lastMetricsTick(0),
+      m_boidIndex(BoidsSpatialGrid::INVALID),
+      m_boidId(BoidsSpatialGrid::INVALID)
 {
-    Ptr<UniformRandomVariable> uv = CreateObject<UniformRandomVariable>();
-    m_velocity.x = uv->GetValue(-1, 1);
-    m_velocity.y = uv->GetValue(-1, 1);
-    m_velocity.z = 0;
+    // Generadores propios del modelo, creados una sola vez (ver DoAssignStreams)
+    m_rng.Create();
+    m_energyRng.Create();
+    m_energyRng.Get()->SetAttribute("Mean", DoubleValue(0.005));
+
+    // Todos los boids se actualizan desde un único controlador de bandada, que guarda
+    // su posición, velocidad y estado de líder en un almacén SoA
+    m_controller = BoidsFlockController::Get();
+    m_controller->Register(this);
+}
 
-    if (m_isLeader)
+BoidsMobilityModel::~BoidsMobilityModel()
+{
+    if (m_controller)
     {
-        m_target.x = uv->GetValue(0, 1000);
-        m_target.y = uv->GetValue(0, 1000);
-        m_target.z = 0;
+        m_controller->Unregister(this);
     }
 }
 
-BoidsMobilityModel::~BoidsMobilityModel()
+int64_t
+BoidsMobilityModel::DoAssignStreams(int64_t stream)
+{
+    m_rng.SetStream(stream);
+    m_energyRng.SetStream(stream + 1);
+    return 2;
+}
+
+void
+BoidsMobilityModel::CreateFireRngs()
+{
+    if (!s_fireRng)
+    {
+        s_fireRng.Create();
+        s_fireOffsetRng.Create();
+    }
+}
+
+int64_t
+BoidsMobilityModel::AssignFireStreams(int64_t stream)
+{
+    CreateFireRngs();
+    s_fireRng.SetStream(stream);
+    s_fireOffsetRng.SetStream(stream + 1);
+    return 2;
+}
+
+void
+BoidsMobilityModel::ResetSharedState()
+{
+    s_fireRegistry.Clear();
+    s_fireAssigner.Invalidate();
+    s_clusterTable.Clear();
+    s_totalFiresExtinguished = 0;
+    s_totalExtinctionTime = Seconds(0);
+    s_fireRng.Reset();
+    s_fireOffsetRng.Reset();
+    s_outFile = nullptr;
+    s_traceWriter = nullptr;
+    s_fireTimeline = nullptr;
+    s_fireTimelineCursor = 0;
+    s_fireBatch.clear();
+    s_fireEvent = EventId();
+    s_checkFireEvent = EventId();
+    s_assignEvent = EventId();
+}
+
+void
+BoidsMobilityModel::DoDispose(void)
+{
+    if (m_controller)
+    {
+        m_controller->Unregister(this);
+        m_controller = nullptr;
+    }
+    MobilityModel::DoDispose();
+}
+
+double
+BoidsMobilityModel::GetRuleRadius() const
+{
+    return std::max({m_separationRadius,
+                     m_alignmentRadius,
+                     m_cohesionRadius,
+                     m_leaderInfluenceRadius});
+}
+
+double
+BoidsMobilityModel::GetMaxInteractionRadius() const
+{
+    // IsIsolated() busca líderes hasta 1.2 veces el radio de influencia
+    return std::max({m_separationRadius,
+                     m_alignmentRadius,
+                     m_cohesionRadius,
+                     m_leaderInfluenceRadius * 1.2});
+}
+
+int32_t
+BoidsMobilityModel::GetClusterHeadIndex(Ptr<Node> node)
+{
+    if (!node)
+        return -1;
+    return s_clusterTable.GetHeadCluster(node->GetId());
+}
+
+void
+BoidsMobilityModel::SetClusters(const NodeContainer& chNodes,
+                                const std::vector<NodeContainer>& clusters)
 {
+    s_clusterTable.Import(chNodes, clusters);
 }
 
 void
@@ -186,74 +271,56 @@ BoidsMobilityModel::SetOutputFile(std::ofstream* outFile)
     s_outFile = outFile;
 }
 
+void
+BoidsMobilityModel::SetTraceWriter(BoidsTraceWriter* writer)
+{
+    s_traceWriter = writer;
+}
+
 Ptr<Node>
 BoidsMobilityModel::FindNearestLeader() const
 {
     Ptr<Node> nearestLeader = nullptr;
     double minDistance = std::numeric_limits<double>::max();
 
-    if (!s_chNodes)
+    if (!s_clusterTable.IsConfigured())
         return nullptr;
 
-    for (uint32_t i = 0; i < s_chNodes->GetN(); ++i)
-    {
-        Ptr<Node> leader = s_chNodes->Get(i);
-        Ptr<MobilityModel> leaderMobility = leader->GetObject<MobilityModel>();
-
-        if (leaderMobility)
-        {
-            double distance = CalculateDistance(m_position, leaderMobility->GetPosition());
-            if (distance < m_leaderInfluenceRadius && distance < minDistance)
+    // Solo los boids dentro del radio de influencia pueden ser el líder más cercano
+    const BoidsFlockController& flock = *m_controller;
+    Vector position = DoGetPosition();
+    flock.GetSpatialGrid().ForEachInRadius(
+        position.x,
+        position.y,
+        m_leaderInfluenceRadius,
+        [&](uint32_t id, double dx, double dy, double d2) {
+            Ptr<Node> node = flock.GetBoid(id)->GetBoidsNode();
+            double distance = std::sqrt(d2);
+            if (distance < minDistance && GetClusterHeadIndex(node) >= 0)
             {
                 minDistance = distance;
-                nearestLeader = leader;
+                nearestLeader = node;
             }
-        }
-    }
+        });
     return nearestLeader;
 }
 
 void
 BoidsMobilityModel::UpdateClusterMembership()
 {
-    if (!s_clusters || !s_chNodes || m_isLeader)
+    if (!s_clusterTable.IsConfigured() || IsLeader())
         return;
 
-    Ptr<Node> currentNode = GetBoidsNode();
+    // Pasar al cluster del líder más cercano, o a ninguno si no hay (O(1) en la tabla)
     Ptr<Node> nearestLeader = FindNearestLeader();
-
-    // Buscar y eliminar el nodo de cualquier cluster actual
-    for (auto& cluster : *s_clusters)
+    int32_t clusterIndex = nearestLeader ? GetClusterHeadIndex(nearestLeader) : -1;
+    Ptr<Node> node = GetBoidsNode();
+    int32_t oldCluster = s_clusterTable.GetCluster(node->GetId());
+    s_clusterTable.Assign(node, clusterIndex);
+    m_controller->GetState().cluster[m_boidIndex] = clusterIndex;
+    if (oldCluster != clusterIndex)
     {
-        for (uint32_t i = 0; i < cluster.GetN(); ++i)
-        {
-            if (cluster.Get(i) == currentNode)
-            {
-                NodeContainer newCluster;
-                for (uint32_t i = 0; i < cluster.GetN(); ++i)
-                {
-                    if (cluster.Get(i) != currentNode)
-                    {
-                        newCluster.Add(cluster.Get(i));
-                    }
-                }
-                cluster = newCluster; // Reemplazar el cluster con la nueva versión
-                break;
-            }
-        }
-    }
-
-    // Añadir al cluster del líder más cercano si existe
-    if (nearestLeader)
-    {
-        for (uint32_t i = 0; i < s_chNodes->GetN(); ++i)
-        {
-            if (s_chNodes->Get(i) == nearestLeader)
-            {
-                (*s_clusters)[i].Add(currentNode);
-                break;
-            }
-        }
+        m_clusterChangedTrace(node->GetId(), oldCluster, clusterIndex);
     }
 }
 
@@ -264,78 +331,146 @@ BoidsMobilityModel::GetBoidsNode() const
     return GetObject<Node>();
 }
 
+uint32_t
+BoidsMobilityModel::GetBoidId() const
+{
+    return m_boidId != BoidsSpatialGrid::INVALID ? m_boidId : GetBoidsNode()->GetId();
+}
+
+void
+BoidsMobilityModel::AddFire(const Vector& fire)
+{
+    // El registro guarda el tiempo de aparición junto al fuego
+    uint32_t fireId = s_fireRegistry.Add(fire, Simulator::Now());
+    TraceFireEvent(fireId, fire, BOIDS_TRACE_FIRE_CREATED);
+    NS_LOG_INFO("Nuevo fuego " << fireId << " en: " << fire.x << ", " << fire.y);
+    // El nuevo fuego puede estar más cerca que el que predijo cada líder
+    BoidsFlockController::Get()->InvalidateFireContacts();
+}
+
 void
 BoidsMobilityModel::AddRandomFire()
 {
-    // Generar entre 1 y 3 fuegos cada vez
-    Ptr<UniformRandomVariable> countVar = CreateObject<UniformRandomVariable>();
-    int fireCount = countVar->GetInteger(1, 3);
-    
-    // Generar los fuegos con distribución de cluster Thomas
-    std::vector<Vector> newFires = getSpotsPoissonSpacial(
-        fireCount, 1000.0, 1000.0, // Área de 1000x1000
-        3, // 3 clusters
-        50.0); // Desviación estándar de 50 metros
-    
-    for (const auto& fire : newFires) {
-        s_fires.push_back(fire);
-        // Registrar el tiempo de aparición del fuego
-        s_fireStartTimes[fire] = Simulator::Now();
-        NS_LOG_UNCOND("Nuevo fuego aparecido en: " << fire.x << ", " << fire.y);
+    if (s_fireTimeline)
+    {
+        // Repetir los fuegos de la línea temporal hasta ahora y esperar al siguiente
+        const int64_t now = Simulator::Now().GetNanoSeconds();
+        const BoidsFireTimeline& timeline = *s_fireTimeline;
+        while (s_fireTimelineCursor < timeline.GetSize() &&
+               timeline[s_fireTimelineCursor].timeNs <= now)
+        {
+            const BoidsFireTimelineRecord& r = timeline[s_fireTimelineCursor++];
+            AddFire(Vector(r.x, r.y, 0.0));
+        }
+        if (s_fireTimelineCursor < timeline.GetSize())
+        {
+            s_fireEvent = Simulator::Schedule(
+                NanoSeconds(timeline[s_fireTimelineCursor].timeNs - now),
+                &BoidsMobilityModel::AddRandomFire);
+        }
+        return;
     }
-    
+
+    // Sin línea temporal: un patrón del proceso puntual en cada intervalo
+    CreateFireRngs();
+    s_fireProcess.Generate(s_fireRng, s_fireOffsetRng, s_fireBatch);
+    for (const auto& fire : s_fireBatch)
+    {
+        AddFire(fire);
+    }
+
     // Programar próximo fuego
-    Simulator::Schedule(s_fireInterval, &BoidsMobilityModel::AddRandomFire);
+    s_fireEvent = Simulator::Schedule(s_fireInterval, &BoidsMobilityModel::AddRandomFire);
 }
 
-// Actualiza las métricas para WCA
 void
-BoidsMobilityModel::UpdateWcaMetrics()
+BoidsMobilityModel::GenerateFireTimeline(Time stop, BoidsFireTimeline& timeline)
 {
-    // 1. Actualizar energía (modelo de consumo simplificado)
-    Ptr<ExponentialRandomVariable> energyConsumption = CreateObject<ExponentialRandomVariable>();
-    energyConsumption->SetAttribute("Mean", DoubleValue(0.005));
-    m_energy = std::max(0.0, m_energy - energyConsumption->GetValue());
+    CreateFireRngs();
+    s_fireProcess.GenerateTimeline(s_fireRng,
+                                   s_fireOffsetRng,
+                                   Simulator::Now(),
+                                   s_fireInterval,
+                                   stop,
+                                   timeline);
+}
 
-    // 2. Calcular grado de conectividad (número de vecinos en rango)
-    m_degree = 0.0;
-    double totalDistance = 0.0;
+void
+BoidsMobilityModel::SetFireTimeline(const BoidsFireTimeline* timeline)
+{
+    s_fireTimeline = timeline;
+    s_fireTimelineCursor = 0;
+}
 
-    for (NodeList::Iterator i = NodeList::Begin(); i != NodeList::End(); ++i)
+// Consumo de energía de un tick (modelo simplificado)
+void
+BoidsMobilityModel::ConsumeEnergy()
+{
+    // Agotada no cambia más: sin sorteo, los que repite un checkpoint no crecen con el tiempo
+    if (m_energy > 0.0)
     {
-        Ptr<Node> node = *i;
-        Ptr<MobilityModel> otherMobility = node->GetObject<MobilityModel>();
+        m_energy = std::max(0.0, m_energy - m_energyRng.GetValue());
+    }
+}
 
-        if (otherMobility && otherMobility != this)
-        {
-            double distance = CalculateDistance(GetPosition(), otherMobility->GetPosition());
-            if (distance < m_leaderInfluenceRadius)
+// Actualiza las métricas para WCA y guarda la puntuación (una vez por elección)
+void
+BoidsMobilityModel::UpdateWcaMetrics()
+{
+    // 1. La energía se consume en cada tick (ConsumeEnergy)
+
+    // 2. Calcular grado de conectividad (número de vecinos en rango)
+    m_degree = 0.0;
+    Vector position = DoGetPosition();
+
+    m_controller->GetSpatialGrid().ForEachInRadius(
+        position.x,
+        position.y,
+        m_leaderInfluenceRadius,
+        [&](uint32_t id, double dx, double dy, double d2) {
+            if (id != m_boidIndex)
             {
                 m_degree += 1.0;
-                totalDistance += distance;
             }
-        }
-    }
-
-    // 3. Calcular distancia a objetivos (fuegos)
+        });
+    // Vecinos de otros rangos (solo con la bandada repartida)
+    m_controller->GetHaloGrid().ForEachInRadius(
+        position.x,
+        position.y,
+        m_leaderInfluenceRadius,
+        [&](uint32_t id, double dx, double dy, double d2) { m_degree += 1.0; });
+
+    // 3. Calcular distancia a objetivos (fuegos): media de la distancia a cada fuego
+    // limitada al radio de normalización, así que solo hace falta recorrer con la
+    // rejilla los fuegos dentro de ese radio; los demás cuentan como el radio
     m_distanceToTargets = 0.0;
-    if (!s_fires.empty())
+    if (!s_fireRegistry.IsEmpty())
     {
-        for (const auto& fire : s_fires)
-        {
-            m_distanceToTargets += CalculateDistance(GetPosition(), fire);
-        }
-        m_distanceToTargets /= s_fires.size(); // Distancia promedio
+        uint32_t nearFires = 0;
+        s_fireRegistry.ForEachInRadius(
+            position,
+            WCA_TARGET_RADIUS,
+            [&](const BoidsFire& fire, double dx, double dy, double d2) {
+                m_distanceToTargets += std::sqrt(d2);
+                nearFires++;
+            });
+        m_distanceToTargets += (s_fireRegistry.GetN() - nearFires) * WCA_TARGET_RADIUS;
+        m_distanceToTargets /= s_fireRegistry.GetN(); // Distancia promedio
     }
 
-    // 4. Calcular movilidad (cambio de posición respecto al último paso)
-    static Vector lastPosition;
-    if (Simulator::Now().GetSeconds() > 0.1)
-    { // Esperar un pequeño intervalo
-        double distanceMoved = CalculateDistance(GetPosition(), lastPosition);
-        m_mobility = distanceMoved / 0.1; // Velocidad instantánea
+    // 4. Calcular movilidad (velocidad media desde la elección anterior de este nodo)
+    uint64_t tickCount = m_controller->GetTickCount();
+    if (tickCount > m_lastMetricsTick)
+    {
+        double elapsed = (tickCount - m_lastMetricsTick) * m_controller->GetTickInterval().GetSeconds();
+        double distanceMoved = CalculateWrappedDistance(position, m_lastPosition);
+        m_mobility = distanceMoved / elapsed;
     }
-    lastPosition = GetPosition();
+    m_lastPosition = position;
+    m_lastMetricsTick = tickCount;
+
+    // 5. La puntuación se calcula una sola vez por elección
+    m_wcaScore = CalculateWcaScore();
 }
 
 // Cálculo del peso WCA
@@ -349,7 +484,7 @@ BoidsMobilityModel::CalculateWcaScore() const
     double normDegree = std::min(m_degree / 10.0, 1.0);
 
     // Normalizar distancia a objetivos (inversa, considerando radio de 200m)
-    double normTargetDistance = 1.0 - std::min(m_distanceToTargets / 200.0, 1.0);
+    double normTargetDistance = 1.0 - std::min(m_distanceToTargets / WCA_TARGET_RADIUS, 1.0);
 
     // Normalizar movilidad (asumiendo velocidad máxima de 10 m/s)
     double normMobility = 1.0 - std::min(m_mobility / 10.0, 1.0);
@@ -380,7 +515,7 @@ BoidsMobilityModel::CheckFireProximity()
             Ptr<Node> node = *i;
             Ptr<BoidsMobilityModel> mob = node->GetObject<BoidsMobilityModel>();
 
-            if (mob && mob->m_isLeader)
+            if (mob && mob->IsLeader())
             {
                 Vector leaderPos = mob->DoGetPosition();
                 Vector diff = *it - leaderPos;
@@ -413,65 +548,90 @@ BoidsMobilityModel::CheckFireProximity()
 void
 BoidsMobilityModel::CheckFireProximity()
 {
-    for (auto it = s_fires.begin(); it != s_fires.end();)
-    {
-        bool fireExtinguished = false;
-        Ptr<BoidsMobilityModel> extinguishingLeader = nullptr;
-
-        // Verificar si algún líder está cerca del fuego
-        for (NodeList::Iterator i = NodeList::Begin(); i != NodeList::End(); ++i)
-        {
-            Ptr<Node> node = *i;
-            Ptr<BoidsMobilityModel> mob = node->GetObject<BoidsMobilityModel>();
-
-            if (mob && mob->m_isLeader)
-            {
-                Vector leaderPos = mob->DoGetPosition();
-                Vector diff = *it - leaderPos;
-                double distance = std::sqrt(diff.x * diff.x + diff.y * diff.y);
-
-                if (distance < s_fireRadius)
-                {
-                    fireExtinguished = true;
+    // Barrido de seguridad: los contactos se detectan en cada tick, cuando vence
+    // la predicción de cada líder; aquí se comprueban todos los líderes igualmente
+    BoidsFlockController::Get()->CheckFireContacts(true);
 
-                    // Actualiza métricas SOLO UNA VEZ
-                    auto fireTimeIt = s_fireStartTimes.find(*it);
-                    if (fireTimeIt != s_fireStartTimes.end())
-                    {
-                        Time extinctionTime = Simulator::Now() - fireTimeIt->second;
-                        s_totalExtinctionTime += extinctionTime;
-                        s_totalFiresExtinguished += 1;
-                        s_fireStartTimes.erase(fireTimeIt);
-                    }
+    // Programar próxima verificación
+    s_checkFireEvent =
+        Simulator::Schedule(s_fireSweepInterval, &BoidsMobilityModel::CheckFireProximity);
+}
 
-                    NS_LOG_UNCOND("Fuego extinguido en: " << it->x << ", " << it->y);
-                    // Si quieres que el líder deje de ser líder:
-                    mob->SetIsLeader(false);
+uint64_t
+BoidsMobilityModel::CheckFireContact()
+{
+    Vector position = DoGetPosition();
+    uint32_t fireId = s_fireRegistry.FindNearest(position, s_fireRadius);
+    if (fireId != BoidsFireRegistry::INVALID)
+    {
+        ExtinguishFire(fireId);
+        if (!IsLeader())
+        {
+            return UINT64_MAX;
+        }
+    }
 
-                    // Elimina el fuego y sale del ciclo de líderes
-                    it = s_fires.erase(it);
-                    break; // Sale del ciclo de líderes, pasa al siguiente fuego
-                }
-            }
+    fireId = s_fireRegistry.FindNearest(position);
+    if (fireId == BoidsFireRegistry::INVALID || m_maxSpeed <= 0.0)
+    {
+        return UINT64_MAX;
+    }
+    // En k pasos la distancia baja como mucho k * m_maxSpeed: no puede haber
+    // contacto mientras k <= (d - radio) / m_maxSpeed
+    double distance = CalculateWrappedDistance(position, s_fireRegistry.Get(fireId).position);
+    double steps = std::floor((distance - s_fireRadius) / (m_maxSpeed * (1.0 + 1e-9)));
+    return steps > 0.0 ? static_cast<uint64_t>(steps) + 1 : 1;
+}
 
+void
+BoidsMobilityModel::ExtinguishFire(uint32_t fireId)
+{
+    const BoidsFire& fire = s_fireRegistry.Get(fireId);
+    Time duration = Simulator::Now() - fire.startTime;
+    s_totalExtinctionTime += duration;
+    s_totalFiresExtinguished += 1;
+
+    NS_LOG_INFO("Fuego " << fireId << " extinguido en: " << fire.position.x << ", "
+                         << fire.position.y);
+    m_fireExtinguishedTrace(fireId, GetBoidsNode()->GetId(), fire.position, duration);
+    TraceFireEvent(fireId, fire.position, BOIDS_TRACE_FIRE_EXTINGUISHED);
+    s_fireRegistry.Remove(fireId);
+    if (BoidsFlockPartition* partition = m_controller->GetPartition())
+    {
+        // Los demás rangos lo retiran de sus copias del registro
+        partition->RecordExtinction(fireId, duration);
+    }
 
-        }
+    // El líder que apagó el fuego deja de ser líder
+    SetIsLeader(false);
+}
 
-        if (!fireExtinguished)
-        {
-            ++it;
-        }
+void
+BoidsMobilityModel::TraceFireEvent(uint32_t fireId, const Vector& fire, uint8_t event)
+{
+    double now = Simulator::Now().GetSeconds();
+    if (s_traceWriter && s_traceWriter->IsOpen())
+    {
+        s_traceWriter->Write({now, -1, fire.x, fire.y, 0, event, static_cast<int32_t>(fireId)});
+    }
+    else if (s_outFile && s_outFile->good())
+    {
+        *s_outFile << now << ",-1," << fire.x << "," << fire.y << ",0," << static_cast<int>(event)
+                   << "," << fireId << "\n";
     }
-
-    // Programar próxima verificación
-    Simulator::Schedule(Seconds(1), &BoidsMobilityModel::CheckFireProximity);
 }
 
 void
 BoidsMobilityModel::DoInitialize(void)
 {
+    // La velocidad inicial se sortea aquí y no en el constructor para que use el
+    // stream asignado con AssignStreams
+    BoidsFlockState& state = m_controller->GetState();
+    state.vx[m_boidIndex] = m_rng.GetValue(-1, 1);
+    state.vy[m_boidIndex] = m_rng.GetValue(-1, 1);
+
     MobilityModel::DoInitialize();
-    Update();
+    m_controller->Start();
 }
 
 // Cambia la implementación para que sea const-correct:
@@ -500,7 +660,7 @@ BoidsMobilityModel::CalculateWrappedDistance(const Vector& a, const Vector& b)
 /*bool
 BoidsMobilityModel::IsIsolated() const
 {
-    if (m_isLeader)
+    if (IsLeader())
         return false;
     // return true;
     bool hasLeaderInRange = false;
@@ -510,7 +670,7 @@ BoidsMobilityModel::IsIsolated() const
         Ptr<Node> node = *i;
         Ptr<BoidsMobilityModel> other = node->GetObject<BoidsMobilityModel>();
 
-        if (other && other != this && other->m_isLeader)
+        if (other && other != this && other->IsLeader())
         {
             double distance = CalculateDistance(m_position, other->DoGetPosition());
             if (distance <
@@ -529,58 +689,10 @@ BoidsMobilityModel::IsIsolated() const
     return !hasLeaderInRange;
 }*/
 
-void
-BoidsMobilityModel::EvaluateLeadershipWithWCA(Ptr<const BoidsMobilityModel> otherLeader)
-{
-    // Solo ejecutar esta evaluación para nodos que son líderes
-    if (!m_isLeader || !otherLeader->m_isLeader)
-        return;
-
-    // Calcular distancia entre los líderes (con wrapping)
-    double distance = CalculateWrappedDistance(m_position, otherLeader->DoGetPosition());
-
-    // Solo evaluar si están dentro del radio de influencia de líderes
-    if (distance > m_leaderInfluenceRadius)
-        return;
-
-    // Actualizar métricas WCA para ambos líderes
-    const_cast<BoidsMobilityModel*>(this)->UpdateWcaMetrics();
-    const_cast<BoidsMobilityModel*>(PeekPointer(otherLeader))->UpdateWcaMetrics();
-
-    // Obtener puntuaciones WCA
-    double myScore = CalculateWcaScore();
-    double otherScore = otherLeader->CalculateWcaScore();
-
-    NS_LOG_UNCOND("Evaluación de liderazgo entre "
-                  << GetBoidsNode()->GetId() << " (score: " << myScore << ") y "
-                  << otherLeader->GetBoidsNode()->GetId() << " (score: " << otherScore << ")");
-
-    // Comparar puntuaciones WCA
-    if (myScore < otherScore)
-    {
-        // Este líder tiene peor puntuación, dejar de ser líder
-        SetIsLeader(false);
-        NS_LOG_UNCOND("Nodo " << GetBoidsNode()->GetId()
-                              << " deja de ser líder. Mejor líder encontrado: "
-                              << otherLeader->GetBoidsNode()->GetId());
-
-        // Actualizar clusters
-        UpdateClusterMembership();
-    }
-    else if (myScore > otherScore)
-    {
-        // El otro líder tiene peor puntuación, sugerir que deje de ser líder
-        NS_LOG_UNCOND("Nodo " << otherLeader->GetBoidsNode()->GetId()
-                              << " debería evaluar dejar de ser líder (mejor líder: "
-                              << GetBoidsNode()->GetId() << ")");
-    }
-    // Si las puntuaciones son iguales, no hacer cambios
-}
-
 bool
 BoidsMobilityModel::IsIsolated() const
 {
-    if (m_isLeader)
+    if (IsLeader())
     {
         NS_LOG_DEBUG("Node " << GetBoidsNode()->GetId() << " es líder, no puede estar aislado");
         return false;
@@ -589,91 +701,98 @@ BoidsMobilityModel::IsIsolated() const
     bool hasLeaderInRange = false;
     const double effectiveRadius = m_leaderInfluenceRadius * 1.2;
 
-    for (NodeList::Iterator i = NodeList::Begin(); i != NodeList::End(); ++i)
-    {
-        Ptr<Node> node = *i;
-        Ptr<const BoidsMobilityModel> other = node->GetObject<BoidsMobilityModel>();
-
-        if (other && other != this && other->m_isLeader)
-        {
-            double distance = CalculateWrappedDistance(m_position, other->DoGetPosition());
-            if (distance < effectiveRadius)
-            {
-                hasLeaderInRange = true;
-                break;
-            }
-        }
-    }
+    // Se usa el estado de líder al inicio del tick para no depender del orden
+    const BoidsFlockController& flock = *m_controller;
+    Vector position = DoGetPosition();
+    flock.GetSpatialGrid().ForEachInRadius(position.x,
+                                           position.y,
+                                           effectiveRadius,
+                                           [&](uint32_t id, double dx, double dy, double d2) {
+                                               if (id != m_boidIndex && flock.WasLeader(id))
+                                               {
+                                                   hasLeaderInRange = true;
+                                               }
+                                           });
+    // El halo lleva el estado de líder al inicio del tick de los otros rangos
+    const BoidsFlockState& halo = flock.GetHalo();
+    flock.GetHaloGrid().ForEachInRadius(position.x,
+                                        position.y,
+                                        effectiveRadius,
+                                        [&](uint32_t id, double dx, double dy, double d2) {
+                                            if (halo.leader[id])
+                                            {
+                                                hasLeaderInRange = true;
+                                            }
+                                        });
 
     return !hasLeaderInRange;
 }
 
 void
-BoidsMobilityModel::Update(void)
+BoidsMobilityModel::UpdateLeadership(void)
 {
-    const_cast<BoidsMobilityModel*>(this)->UpdateWcaMetrics();
-
-    // Calcular puntuación WCA
-    double wcaScore = CalculateWcaScore();
-    NS_LOG_UNCOND("Node " << GetBoidsNode()->GetId() << " WCA Score: " << wcaScore
-                          << " (E: " << m_energy << ", D: " << m_degree
-                          << ", T: " << m_distanceToTargets << ", M: " << m_mobility << ")");
+    // Puntuación WCA calculada por el controlador en esta elección
+    double wcaScore = m_wcaScore;
+    NS_LOG_LOGIC("Node " << GetBoidsNode()->GetId() << " WCA Score: " << wcaScore
+                         << " (E: " << m_energy << ", D: " << m_degree
+                         << ", T: " << m_distanceToTargets << ", M: " << m_mobility << ")");
 
     // Comportamiento basado en WCA (ejemplo: líderes con mejor puntuación)
-    bool leaderStatusChanged = false;
-    // Lógica de autopromoción cuando está aislado
-    NS_LOG_UNCOND("Node " << GetBoidsNode()->GetId() << " es lider " << m_isLeader << " isolado"
-                          << IsIsolated() << " score " << wcaScore);
-    // Se autoproclama lider al no tener un lider cercano                          
-    if (!m_isLeader && IsIsolated() && wcaScore > 0.0)
+    // Se autoproclama lider al no tener un lider cercano
+    if (!IsLeader() && IsIsolated() && wcaScore > 0.0)
     {
-        NS_LOG_UNCOND("Node se vuelve lider" << GetBoidsNode()->GetId());
+        NS_LOG_LOGIC("Node se vuelve lider " << GetBoidsNode()->GetId());
         SetIsLeader(true);
-        leaderStatusChanged = true;
         // Comportamiento inicial como nuevo líder
-        Ptr<UniformRandomVariable> uv = CreateObject<UniformRandomVariable>();
-        m_target.x = uv->GetValue(0, 1000);
-        m_target.y = uv->GetValue(0, 1000);
+        m_target.x = m_rng.GetValue(0, 1000);
+        m_target.y = m_rng.GetValue(0, 1000);
         // Nodo con buena puntuación podría convertirse en líder
-        m_velocity.x *= 1.05;
-        m_velocity.y *= 1.05;
+        BoidsFlockState& state = m_controller->GetState();
+        state.vx[m_boidIndex] *= 1.05;
+        state.vy[m_boidIndex] *= 1.05;
     }
-    //evalua sí tiene lideres cerca y en caso de tener un WCA score menor deja de ser lider
-    if (m_isLeader)
-    {
-        for (NodeList::Iterator i = NodeList::Begin(); i != NodeList::End(); ++i)
-        {
-            Ptr<Node> node = *i;
-            Ptr<BoidsMobilityModel> other = node->GetObject<BoidsMobilityModel>();
+    // Los conflictos entre líderes cercanos los resuelve el controlador para toda la
+    // bandada después de esta fase (BoidsFlockController::ResolveLeaderConflicts)
 
-            if (other && other != this && other->m_isLeader)
-            {
-                EvaluateLeadershipWithWCA(other);
-                break; // Solo evaluar con un líder a la vez
-            }
-        }
-    }
-
-    if (m_isLeader && CalculateWcaScore() < 0.5)
+    if (IsLeader() && wcaScore < 0.5)
     {
         // Este líder ya no es adecuado
         SetIsLeader(false);
-        leaderStatusChanged = true;
     }
-    if (!m_isLeader && CalculateWcaScore() > 0.8)
+    if (!IsLeader() && wcaScore > 0.8)
     {
         // Este nodo es buen candidato a líder
         SetIsLeader(true);
-        leaderStatusChanged = true;
     }
+}
 
-    if (leaderStatusChanged || !m_isLeader)
+void
+BoidsMobilityModel::UpdateWanderTarget(void)
+{
+    // Un líder sin fuegos elige un nuevo destino aleatorio al alcanzar el actual
+    if (IsLeader() && s_fireRegistry.IsEmpty())
     {
-        UpdateClusterMembership();
+        Vector position = DoGetPosition();
+        double distance = std::sqrt((m_target.x - position.x) * (m_target.x - position.x) +
+                                    (m_target.y - position.y) * (m_target.y - position.y));
+        if (distance < 10.0)
+        {
+            m_target.x = m_rng.GetValue(0, 1000);
+            m_target.y = m_rng.GetValue(0, 1000);
+        }
     }
-    // NS_LOG_UNCOND("entra update");
-    //  Obtener todos los nodos con movilidad Boids
-    // NodeList::Iterator listEnd = NodeList::End();
+}
+
+template <typename T>
+void
+BoidsMobilityModel::ComputeNextState(BoidsNeighborBufferT<T>& neighborBuffer,
+                                     BoidsFlockState& next) const
+{
+    // Solo lee el buffer vigente y solo escribe la posición de este boid en el siguiente;
+    // se ejecuta en paralelo, así que no debe tocar estado compartido ni crear objetos
+    Vector velocity = DoGetVelocity();
+    Vector position = DoGetPosition();
+
     Vector separation(0, 0, 0);
     Vector alignment(0, 0, 0);
     Vector cohesion(0, 0, 0);
@@ -682,111 +801,75 @@ BoidsMobilityModel::Update(void)
     int neighbors = 0;
     int leaderNeighbors = 0;
 
-    if (m_isLeader)
+    if (IsLeader())
     {
-        // Comportamiento del líder: buscar fuegos más cercanos
-        Vector closestFire;
-        double minDistance = std::numeric_limits<double>::max();
-        bool fireFound = false;
-
-        for (const auto& fire : s_fires)
-        {
-            Vector diff = fire - m_position;
-            double distance = std::sqrt(diff.x * diff.x + diff.y * diff.y);
-
-            if (distance < minDistance)
-            {
-                minDistance = distance;
-                closestFire = fire;
-                fireFound = true;
-            }
-        }
-
-        if (fireFound)
-        {
-            // Moverse hacia el fuego más cercano
-            Vector direction = closestFire - m_position;
-            double distance = std::sqrt(direction.x * direction.x + direction.y * direction.y);
-
-            if (distance > 0)
-            {
-                direction.x /= distance;
-                direction.y /= distance;
-                m_velocity.x +=
-                    direction.x * 1.5; // Mayor influencia que el comportamiento aleatorio
-                m_velocity.y += direction.y * 1.5;
-            }
-        }
-        else
-        {
-            // Comportamiento aleatorio si no hay fuegos
-            Ptr<UniformRandomVariable> uv = CreateObject<UniformRandomVariable>();
-            double distance = std::sqrt((m_target.x - m_position.x) * (m_target.x - m_position.x) +
-                                        (m_target.y - m_position.y) * (m_target.y - m_position.y));
-
-            if (distance < 10.0)
-            {
-                m_target.x = uv->GetValue(0, 1000);
-                m_target.y = uv->GetValue(0, 1000);
-            }
-
-            Vector direction = m_target - m_position;
-            distance = std::sqrt(direction.x * direction.x + direction.y * direction.y);
-
-            if (distance > 0)
-            {
-                direction.x /= distance;
-                direction.y /= distance;
-                m_velocity.x += direction.x * 0.1;
-                m_velocity.y += direction.y * 0.1;
-            }
-        }
+        SteerLeader(position, velocity);
     }
     else
     {
         // COMPORTAMIENTO DE LOS SEGUIDORES (NUEVO)
-        for (NodeList::Iterator i = NodeList::Begin(); i != NodeList::End(); ++i)
+        // Se reúnen los vecinos dentro del mayor de los radios (imagen mínima del toro)
+        // en un buffer contiguo y el kernel vectorial acumula las cuatro reglas
+        const BoidsFlockController& flock = *m_controller;
+        const BoidsFlockState& state = flock.GetState();
+        BoidsRuleRadii radii = {m_separationRadius,
+                                m_alignmentRadius,
+                                m_cohesionRadius,
+                                m_leaderInfluenceRadius};
+        double ruleRadius = GetRuleRadius();
+
+        neighborBuffer.Clear();
+        const BoidsSpatialGrid& grid = flock.GetSpatialGrid();
+        const BoidsNeighborLists& lists = flock.GetNeighborLists();
+        if (lists.IsValid())
         {
-            Ptr<Node> node = *i;
-            Ptr<BoidsMobilityModel> other = node->GetObject<BoidsMobilityModel>();
-
-            if (other == this || !other)
-                continue;
-
-            Vector otherPos = other->DoGetPosition();
-            Vector diff = m_position - otherPos;
-            double distance = std::sqrt(diff.x * diff.x + diff.y * diff.y);
-
-            // 1. Separación: evitar colisiones con vecinos cercanos
-            if (distance < m_separationRadius && distance > 0)
+            // Mismo filtro y desplazamiento que la consulta a la rejilla
+            const double r2 = ruleRadius * ruleRadius;
+            for (uint32_t id : lists.Get(m_boidIndex))
             {
-                separation.x += diff.x / distance;
-                separation.y += diff.y / distance;
-            }
-
-            // 2. Alineación: ajustar velocidad a la de vecinos cercanos
-            if (distance < m_alignmentRadius)
-            {
-                alignment.x += other->m_velocity.x;
-                alignment.y += other->m_velocity.y;
-                neighbors++;
-            }
-
-            // 3. Cohesión: moverse hacia el centro de masa del grupo
-            if (distance < m_cohesionRadius)
-            {
-                cohesion.x += otherPos.x;
-                cohesion.y += otherPos.y;
-            }
-
-            // 4. Atracción a líderes: seguir a los líderes dentro del radio de influencia
-            if (other->m_isLeader && distance < m_leaderInfluenceRadius)
-            {
-                leaderAttraction.x += other->m_velocity.x;
-                leaderAttraction.y += other->m_velocity.y;
-                leaderNeighbors++;
+                double dx = BoidsSpatialGrid::WrapDelta(state.x[id] - position.x, grid.GetWidth());
+                double dy = BoidsSpatialGrid::WrapDelta(state.y[id] - position.y, grid.GetHeight());
+                if (dx * dx + dy * dy < r2)
+                {
+                    neighborBuffer.Push(dx, dy, state.vx[id], state.vy[id], state.leader[id] != 0);
+                }
             }
         }
+        else
+        {
+            grid.ForEachInRadius(
+                position.x,
+                position.y,
+                ruleRadius,
+                [&](uint32_t id, double dx, double dy, double d2) {
+                    if (id != m_boidIndex)
+                    {
+                        neighborBuffer.Push(dx,
+                                            dy,
+                                            state.vx[id],
+                                            state.vy[id],
+                                            state.leader[id] != 0);
+                    }
+                });
+        }
+        const BoidsFlockState& halo = flock.GetHalo();
+        flock.GetHaloGrid().ForEachInRadius(
+            position.x,
+            position.y,
+            ruleRadius,
+            [&](uint32_t id, double dx, double dy, double d2) {
+                neighborBuffer.Push(dx, dy, halo.vx[id], halo.vy[id], halo.leader[id] != 0);
+            });
+        BoidsRuleSums sums = BoidsAccumulateRules(neighborBuffer, radii);
+
+        separation = Vector(sums.separationX, sums.separationY, 0);
+        alignment = Vector(sums.alignmentX, sums.alignmentY, 0);
+        cohesion = Vector(sums.cohesionCount * position.x + sums.cohesionDx,
+                          sums.cohesionCount * position.y + sums.cohesionDy,
+                          0);
+        leaderAttraction = Vector(sums.leaderX, sums.leaderY, 0);
+        neighbors = sums.alignmentCount;
+        leaderNeighbors = sums.leaderCount;
 
         // Aplicar las reglas con diferentes pesos
         if (neighbors > 0)
@@ -794,109 +877,216 @@ BoidsMobilityModel::Update(void)
             // Normalizar alineación
             alignment.x /= neighbors;
             alignment.y /= neighbors;
-            m_velocity.x += (alignment.x - m_velocity.x) * 0.1;
-            m_velocity.y += (alignment.y - m_velocity.y) * 0.1;
+            velocity.x += (alignment.x - velocity.x) * 0.1;
+            velocity.y += (alignment.y - velocity.y) * 0.1;
 
             // Normalizar cohesión
             cohesion.x /= neighbors;
             cohesion.y /= neighbors;
-            Vector cohesionForce = cohesion - m_position;
+            Vector cohesionForce = cohesion - position;
             double distance =
                 std::sqrt(cohesionForce.x * cohesionForce.x + cohesionForce.y * cohesionForce.y);
             if (distance > 0)
             {
                 cohesionForce.x /= distance;
                 cohesionForce.y /= distance;
-                m_velocity.x += cohesionForce.x * 0.05;
-                m_velocity.y += cohesionForce.y * 0.05;
+                velocity.x += cohesionForce.x * 0.05;
+                velocity.y += cohesionForce.y * 0.05;
             }
         }
 
         // Aplicar separación
-        m_velocity.x += separation.x * 0.15;
-        m_velocity.y += separation.y * 0.15;
+        velocity.x += separation.x * 0.15;
+        velocity.y += separation.y * 0.15;
 
         // Aplicar atracción a líderes
         if (leaderNeighbors > 0)
         {
             leaderAttraction.x /= leaderNeighbors;
             leaderAttraction.y /= leaderNeighbors;
-            m_velocity.x += (leaderAttraction.x - m_velocity.x) * 0.2;
-            m_velocity.y += (leaderAttraction.y - m_velocity.y) * 0.2;
+            velocity.x += (leaderAttraction.x - velocity.x) * 0.2;
+            velocity.y += (leaderAttraction.y - velocity.y) * 0.2;
+        }
+    }
+
+    AdvanceStep(position, velocity);
+
+    next.x[m_boidIndex] = position.x;
+    next.y[m_boidIndex] = position.y;
+    next.vx[m_boidIndex] = velocity.x;
+    next.vy[m_boidIndex] = velocity.y;
+}
+
+template void BoidsMobilityModel::ComputeNextState(BoidsNeighborBuffer&, BoidsFlockState&) const;
+template void BoidsMobilityModel::ComputeNextState(BoidsNeighborBufferF&, BoidsFlockState&) const;
+
+void
+BoidsMobilityModel::SteerLeader(const Vector& position, Vector& velocity) const
+{
+    // Comportamiento del líder: ir al fuego asignado o, si no tiene o ya se apagó,
+    // al más cercano (el registro no cambia durante este paso, así que la consulta
+    // es segura entre hilos)
+    uint32_t fireId = m_assignedFire;
+    if (fireId == BoidsFireRegistry::INVALID || !s_fireRegistry.Contains(fireId))
+    {
+        fireId = s_fireRegistry.FindNearest(position);
+    }
+
+    if (fireId != BoidsFireRegistry::INVALID)
+    {
+        // Moverse hacia el fuego (dirección envuelta en el mundo toroidal)
+        const Vector& fire = s_fireRegistry.Get(fireId).position;
+        Vector direction(BoidsSpatialGrid::WrapDelta(fire.x - position.x, 1000.0),
+                         BoidsSpatialGrid::WrapDelta(fire.y - position.y, 1000.0),
+                         0.0);
+        double distance = std::sqrt(direction.x * direction.x + direction.y * direction.y);
+
+        if (distance > 0)
+        {
+            direction.x /= distance;
+            direction.y /= distance;
+            velocity.x +=
+                direction.x * 1.5; // Mayor influencia que el comportamiento aleatorio
+            velocity.y += direction.y * 1.5;
         }
     }
+    else
+    {
+        // Comportamiento aleatorio si no hay fuegos (destino elegido en UpdateWanderTarget)
+        Vector direction = m_target - position;
+        double distance = std::sqrt(direction.x * direction.x + direction.y * direction.y);
 
+        if (distance > 0)
+        {
+            direction.x /= distance;
+            direction.y /= distance;
+            velocity.x += direction.x * 0.1;
+            velocity.y += direction.y * 0.1;
+        }
+    }
+}
+
+void
+BoidsMobilityModel::AdvanceStep(Vector& position, Vector& velocity) const
+{
     // Limitar velocidad
-    double speed = std::sqrt(m_velocity.x * m_velocity.x + m_velocity.y * m_velocity.y);
+    double speed = std::sqrt(velocity.x * velocity.x + velocity.y * velocity.y);
     if (speed > m_maxSpeed)
     {
-        m_velocity.x = (m_velocity.x / speed) * m_maxSpeed;
-        m_velocity.y = (m_velocity.y / speed) * m_maxSpeed;
+        velocity.x = (velocity.x / speed) * m_maxSpeed;
+        velocity.y = (velocity.y / speed) * m_maxSpeed;
     }
 
     // Actualizar posición
-    m_position.x += m_velocity.x;
-    m_position.y += m_velocity.y;
+    position.x += velocity.x;
+    position.y += velocity.y;
 
     // Mantener dentro de límites (opcional)
-    m_position.x = std::fmod(m_position.x + 1000, 1000);
-    m_position.y = std::fmod(m_position.y + 1000, 1000);
+    position.x = std::fmod(position.x + 1000, 1000);
+    position.y = std::fmod(position.y + 1000, 1000);
+}
+
+void
+BoidsMobilityModel::CommitState(void)
+{
+    // El controlador ya intercambió los buffers: el estado vigente es el nuevo
+    Vector position = DoGetPosition();
+    m_controller->NotifyPositionChanged(m_boidIndex, position);
 
     /*NS_LOG_UNCOND("ejecucion: " << Simulator::Now().GetSeconds() << "," << 0 // node->GetId()
                                 << "," // Ahora funciona correctamente
                                 << m_position.x << "," << m_position.y << ","
-                                << (m_isLeader ? 1 : 0) << m_maxSpeed << "\n");*/
+                                << (IsLeader() ? 1 : 0) << m_maxSpeed << "\n");*/
 
     // Después de actualizar la posición y velocidad
-    if (s_outFile && s_outFile->good())
-    { // Cambiamos is_open() por good()
-        Vector position = DoGetPosition();
+    WritePositionRecord(position);
 
-        Ptr<Node> node = GetBoidsNode(); // Usamos nuestro nuevo método
+    // Notificar cambio de posición
+    NotifyCourseChange();
+}
 
-        *s_outFile << Simulator::Now().GetSeconds() << "," << node->GetId()
+void
+BoidsMobilityModel::WritePositionRecord(const Vector& position) const
+{
+    if (s_traceWriter && s_traceWriter->IsOpen())
+    {
+        // Solo se copian registros; el formato y la escritura van en otro hilo
+        double now = Simulator::Now().GetSeconds();
+        uint8_t isLeader = IsLeader() ? 1 : 0;
+        // Los fuegos no se repiten aquí: se registran al aparecer y al extinguirse
+        s_traceWriter->Write({now,
+                              static_cast<int32_t>(GetBoidId()),
+                              position.x,
+                              position.y,
+                              isLeader,
+                              0,
+                              -1});
+    }
+    else if (s_outFile && s_outFile->good())
+    { // Cambiamos is_open() por good()
+        *s_outFile << Simulator::Now().GetSeconds() << "," << GetBoidId()
                    << "," // Ahora funciona correctamente
-                   << position.x << "," << position.y << "," << (m_isLeader ? 1 : 0) << ",0\n";
+                   << position.x << "," << position.y << "," << (IsLeader() ? 1 : 0) << ",0,-1\n";
         /*NS_LOG_UNCOND("ejecucion: " << Simulator::Now().GetSeconds() << "," << node->GetId()
                                     << "," // Ahora funciona correctamente
                                     << position.x << "," << position.y << ","
-                                    << (m_isLeader ? 1 : 0) << "\n");*/
-        // Si es líder y hay fuegos, escribir también los fuegos
-        if (m_isLeader && !s_fires.empty())
-        {
-            for (const auto& fire : s_fires)
-            {
-                *s_outFile << Simulator::Now().GetSeconds() << "," << -1
-                           << "," // ID negativo para fuegos
-                           << fire.x << "," << fire.y << ","
-                           << "0,1\n"; // El último 1 indica que es un fuego
-            }
-        }
+                                    << (IsLeader() ? 1 : 0) << "\n");*/
     }
-
-    // Programar próximo update
-    Simulator::Schedule(MilliSeconds(100), &BoidsMobilityModel::Update, this);
-
-    // Notificar cambio de posición
-    NotifyCourseChange();
 }
 
 Vector
 BoidsMobilityModel::DoGetPosition(void) const
 {
-    return m_position;
+    if (!m_controller || m_boidIndex == BoidsSpatialGrid::INVALID)
+    {
+        return Vector();
+    }
+    const BoidsFlockState& state = m_controller->GetState();
+    return Vector(state.x[m_boidIndex], state.y[m_boidIndex], 0);
 }
 
 void
 BoidsMobilityModel::DoSetPosition(const Vector& position)
 {
-    m_position = position;
+    if (m_controller)
+    {
+        m_controller->InvalidateFireContact(m_boidIndex);
+        BoidsFlockState& state = m_controller->GetState();
+        state.x[m_boidIndex] = position.x;
+        state.y[m_boidIndex] = position.y;
+        m_controller->NotifyPositionChanged(m_boidIndex, position);
+    }
 }
 
 Vector
 BoidsMobilityModel::DoGetVelocity(void) const
 {
-    return m_velocity;
+    if (!m_controller || m_boidIndex == BoidsSpatialGrid::INVALID)
+    {
+        return Vector();
+    }
+    const BoidsFlockState& state = m_controller->GetState();
+    return Vector(state.vx[m_boidIndex], state.vy[m_boidIndex], 0);
+}
+
+bool
+BoidsMobilityModel::IsLeader() const
+{
+    return m_controller && m_boidIndex != BoidsSpatialGrid::INVALID &&
+           m_controller->GetState().leader[m_boidIndex] != 0;
+}
+
+void
+BoidsMobilityModel::SetLeaderFlag(bool isLeader)
+{
+    if (m_controller)
+    {
+        if (IsLeader() != isLeader)
+        {
+            m_controller->InvalidateFireContact(m_boidIndex);
+        }
+        m_controller->GetState().leader[m_boidIndex] = isLeader ? 1 : 0;
+    }
 }
 
 void
@@ -926,97 +1116,85 @@ BoidsMobilityModel::SetLeaderInfluenceRadius(double radius)
 void
 BoidsMobilityModel::SetMaxSpeed(double speed)
 {
+    if (m_controller)
+    {
+        m_controller->InvalidateFireContact(m_boidIndex);
+    }
     m_maxSpeed = speed;
 }
 
 void
 BoidsMobilityModel::AssignFiresToLeaders()
 {
-    // 1. Recolecta todos los líderes activos
-    std::vector<Ptr<BoidsMobilityModel>> leaders;
-    for (NodeList::Iterator i = NodeList::Begin(); i != NodeList::End(); ++i)
+    // 1. Recolecta todos los líderes activos, ordenados por NodeId
+    std::vector<std::pair<uint32_t, BoidsMobilityModel*>> leaders;
+    Ptr<BoidsFlockController> controller = BoidsFlockController::Get();
+    for (uint32_t i = 0; i < controller->GetNBoids(); ++i)
     {
-        Ptr<Node> node = *i;
-        Ptr<BoidsMobilityModel> mob = node->GetObject<BoidsMobilityModel>();
-        if (mob && mob->m_isLeader)
+        BoidsMobilityModel* mob = controller->GetBoid(i);
+        if (mob->IsLeader())
         {
-            leaders.push_back(mob);
+            leaders.emplace_back(mob->GetBoidsNode()->GetId(), mob);
         }
     }
+    std::sort(leaders.begin(), leaders.end());
 
-    // 2. Lleva registro de fuegos ya asignados
-    std::vector<Vector> assignedFires;
-
-    // 3. Para cada líder, asigna el fuego más cercano no asignado
-    for (auto& leader : leaders)
+    if (!leaders.empty() && !s_fireRegistry.IsEmpty())
     {
-        if (!s_fires.empty())
+        std::vector<uint32_t> leaderIds;
+        std::vector<Vector> leaderPositions;
+        for (const auto& leader : leaders)
         {
-            Vector myPos = leader->DoGetPosition();
-            double minDist = std::numeric_limits<double>::max();
-            Vector closestFire;
-            bool found = false;
-            for (const auto& fire : s_fires)
-            {
-                // Si ya fue asignado, ignóralo
-                if (std::find(assignedFires.begin(), assignedFires.end(), fire) != assignedFires.end())
-                    continue;
+            leaderIds.push_back(leader.first);
+            leaderPositions.push_back(leader.second->DoGetPosition());
+        }
+        std::vector<uint32_t> fireIds;
+        std::vector<Vector> firePositions;
+        for (const BoidsFire& fire : s_fireRegistry)
+        {
+            fireIds.push_back(fire.id);
+            firePositions.push_back(fire.position);
+        }
 
-                double dist = CalculateWrappedDistance(myPos, fire);
-                if (dist < minDist)
-                {
-                    minDist = dist;
-                    closestFire = fire;
-                    found = true;
-                }
-            }
-            if (found)
+        // 2. Asignación de costo mínimo; solo se recalcula si cambian líderes o fuegos
+        const std::vector<uint32_t>& assignment =
+            s_fireAssigner.Assign(leaderIds, leaderPositions, fireIds, firePositions);
+
+        for (BoidsFire& fire : s_fireRegistry)
+        {
+            fire.assignedLeader = BoidsFireRegistry::INVALID;
+        }
+        for (uint32_t l = 0; l < leaders.size(); ++l)
+        {
+            uint32_t fireId = assignment[l];
+            if (fireId != BoidsFireAssigner::INVALID)
             {
-                leader->m_target = closestFire;
-                assignedFires.push_back(closestFire);
+                s_fireRegistry.Get(fireId).assignedLeader = leaderIds[l];
+                leaders[l].second->m_assignedFire = fireId;
             }
             else
             {
-                // Si todos los fuegos ya están asignados, elige el más cercano (puede repetirse)
-                minDist = std::numeric_limits<double>::max();
-                for (const auto& fire : s_fires)
-                {
-                    double dist = CalculateWrappedDistance(myPos, fire);
-                    if (dist < minDist)
-                    {
-                        minDist = dist;
-                        closestFire = fire;
-                    }
-                }
-                leader->m_target = closestFire;
+                // Si todos los fuegos ya están asignados, SteerLeader va al más cercano
+                // (puede repetirse)
+                fireId = s_fireRegistry.FindNearest(leaderPositions[l]);
+                leaders[l].second->m_assignedFire = BoidsFireRegistry::INVALID;
             }
+            leaders[l].second->m_target = s_fireRegistry.Get(fireId).position;
         }
     }
 
     // Programa la próxima actualización periódica
-    Simulator::Schedule(Seconds(1), &BoidsMobilityModel::AssignFiresToLeaders);
+    s_assignEvent = Simulator::Schedule(Seconds(1), &BoidsMobilityModel::AssignFiresToLeaders);
 }
 
 void
 BoidsMobilityModel::UpdateLeaderTarget()
 {
-    if (m_isLeader)
+    if (IsLeader())
     {
-        if (!s_fires.empty())
+        if (!s_fireRegistry.IsEmpty())
         {
-            Vector myPos = DoGetPosition();
-            double minDist = std::numeric_limits<double>::max();
-            Vector closestFire = s_fires[0];
-            for (const auto& fire : s_fires)
-            {
-                double dist = CalculateWrappedDistance(myPos, fire);
-                if (dist < minDist)
-                {
-                    minDist = dist;
-                    closestFire = fire;
-                }
-            }
-            m_target = closestFire;
+            m_target = s_fireRegistry.Get(s_fireRegistry.FindNearest(DoGetPosition())).position;
         }
         // Si no hay fuegos, puedes mantener el target actual o asignar uno aleatorio si lo prefieres
     }
@@ -1026,31 +1204,29 @@ BoidsMobilityModel::UpdateLeaderTarget()
 void
 BoidsMobilityModel::SetIsLeader(bool isLeader)
 {
-    m_isLeader = isLeader;
-    if (m_isLeader)
+    bool wasLeader = IsLeader();
+    SetLeaderFlag(isLeader);
+    Ptr<Node> node = GetBoidsNode();
+    if (wasLeader != isLeader && node)
+    {
+        m_leadershipChangedTrace(node->GetId(), isLeader, m_wcaScore);
+    }
+    if (wasLeader != isLeader)
+    {
+        // Un líder nuevo va al fuego más cercano hasta la próxima asignación
+        m_assignedFire = BoidsFireRegistry::INVALID;
+    }
+    if (isLeader)
     {
         // Inicializa el target al fuego más cercano (o aleatorio si no hay fuegos)
-        if (!s_fires.empty())
+        if (!s_fireRegistry.IsEmpty())
         {
-            Vector myPos = DoGetPosition();
-            double minDist = std::numeric_limits<double>::max();
-            Vector closestFire = s_fires[0];
-            for (const auto& fire : s_fires)
-            {
-                double dist = CalculateWrappedDistance(myPos, fire);
-                if (dist < minDist)
-                {
-                    minDist = dist;
-                    closestFire = fire;
-                }
-            }
-            m_target = closestFire;
+            m_target = s_fireRegistry.Get(s_fireRegistry.FindNearest(DoGetPosition())).position;
         }
         else
         {
-            Ptr<UniformRandomVariable> uv = CreateObject<UniformRandomVariable>();
-            m_target.x = uv->GetValue(0, 1000);
-            m_target.y = uv->GetValue(0, 1000);
+            m_target.x = m_rng.GetValue(0, 1000);
+            m_target.y = m_rng.GetValue(0, 1000);
         }
     }
 }
@@ -1,14 +1,23 @@
 #ifndef BOIDS_MOBILITY_MODEL_H
 #define BOIDS_MOBILITY_MODEL_H
 
+#include "boids-cluster-table.h"
+#include "boids-counted-rng.h"
+#include "boids-fire-assignment.h"
+#include "boids-fire-registry.h"
+#include "boids-flock-controller.h"
+#include "boids-point-process.h"
+#include "boids-spatial-grid.h"
 #include "mobility-model.h"
 
+#include "ns3/event-id.h"
 #include "ns3/node-container.h"
 #include "ns3/node.h"
 #include "ns3/nstime.h" // Añade esto al principio del archivo
 #include "ns3/object.h"
 #include "ns3/ptr.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/traced-callback.h"
 #include "ns3/vector.h"
 
 #include <fstream>
@@ -19,17 +28,25 @@
 namespace ns3
 {
 
+class BoidsTraceWriter;
+
 class BoidsMobilityModel : public MobilityModel
 {
   public:
     static TypeId GetTypeId(void);
-    static std::map<Vector, Time> s_fireStartTimes; // Tiempo de aparición de cada fuego
-    static uint32_t s_totalFiresExtinguished;       // Total de fuegos extinguidos
-    static Time s_totalExtinctionTime;              // Tiempo acumulado de extinción
+    static uint32_t s_totalFiresExtinguished; // Total de fuegos extinguidos
+    static Time s_totalExtinctionTime;        // Tiempo acumulado de extinción
 
     BoidsMobilityModel();
     virtual ~BoidsMobilityModel();
-    void EvaluateLeadershipWithWCA(Ptr<const BoidsMobilityModel> otherLeader);
+
+    // Firmas de las fuentes de traza
+    typedef void (*LeadershipChangedCallback)(uint32_t nodeId, bool isLeader, double wcaScore);
+    typedef void (*FireExtinguishedCallback)(uint32_t fireId,
+                                             uint32_t nodeId,
+                                             Vector position,
+                                             Time duration);
+    typedef void (*ClusterChangedCallback)(uint32_t nodeId, int32_t oldCluster, int32_t newCluster);
     // Parámetros configurables
     void SetSeparationRadius(double radius);
     void SetAlignmentRadius(double radius);
@@ -37,13 +54,13 @@ class BoidsMobilityModel : public MobilityModel
     void SetLeaderInfluenceRadius(double radius);
     void SetMaxSpeed(double speed);
     void SetIsLeader(bool isLeader);
+    bool IsLeader() const;
     void UpdateLeaderTarget();
     static void AssignFiresToLeaders(); 
     static void SetOutputFile(std::ofstream* outFile);
+    // Si hay un escritor asíncrono abierto se usa en lugar de SetOutputFile
+    static void SetTraceWriter(BoidsTraceWriter* writer);
     static double CalculateWrappedDistance(const Vector& a, const Vector& b);
-    static std::vector<Vector> getSpotsPoissonSpacial(
-        uint32_t n, double areaX = 1000.0, double areaY = 1000.0,
-        uint32_t k = 5, double desviacion = 10.0);
     Time GetFireInterval() const
     {
         return s_fireInterval;
@@ -62,54 +79,144 @@ class BoidsMobilityModel : public MobilityModel
     void SetFireRadius(double radius)
     {
         s_fireRadius = radius;
+        if (m_controller)
+        {
+            m_controller->InvalidateFireContacts();
+        }
+    }
+
+    // Periodo del barrido de seguridad de CheckFireProximity (los contactos se
+    // detectan en cada tick con su predicción)
+    Time GetFireSweepInterval() const
+    {
+        return s_fireSweepInterval;
     }
 
-    // Métodos estáticos para manejar fuegos
+    void SetFireSweepInterval(Time interval)
+    {
+        s_fireSweepInterval = interval;
+    }
+
+    // Parámetros del proceso Thomas de aparición de fuegos
     uint32_t GetClusterCount() const
     {
-        return s_clusterCount;
+        return static_cast<uint32_t>(s_fireProcess.GetParentMean());
     }
 
     void SetClusterCount(uint32_t count)
     {
-        s_clusterCount = count;
+        s_fireProcess.SetParentMean(count);
     }
 
     double GetClusterDeviation() const
     {
-        return s_clusterDeviation;
+        return s_fireProcess.GetSpread();
     }
 
     void SetClusterDeviation(double deviation)
     {
-        s_clusterDeviation = deviation;
+        s_fireProcess.SetSpread(deviation);
     }
     static void AddRandomFire();
     static void CheckFireProximity();
-    // Método para generar fuegos usando Thomas cluster process
-    static std::vector<Vector> GetSpotsPoissonSpacial(uint32_t n, double areaX = 1000.0, double areaY = 1000.0, uint32_t k = 5, double desviacion = 10.0);
+
+    // Fuegos activos
+    static const BoidsFireRegistry& GetFireRegistry()
+    {
+        return s_fireRegistry;
+    }
+
+    // Proceso puntual con que AddRandomFire genera cada patrón de fuegos
+    static BoidsPointProcess& GetFireProcess()
+    {
+        return s_fireProcess;
+    }
+
+    // Genera de una vez los fuegos de [ahora, stop) con el proceso y los
+    // generadores de fuegos, un patrón cada GetFireInterval()
+    static void GenerateFireTimeline(Time stop, BoidsFireTimeline& timeline);
+
+    // Si hay línea temporal, AddRandomFire repite sus fuegos en lugar de
+    // generarlos (el llamador la mantiene viva; nullptr para volver a generarlos)
+    static void SetFireTimeline(const BoidsFireTimeline* timeline);
+
+    // Motor de asignación de fuegos a líderes usado por AssignFiresToLeaders
+    static BoidsFireAssigner& GetFireAssigner()
+    {
+        return s_fireAssigner;
+    }
+    // Fija los streams de los generadores de fuegos (compartidos por la clase).
+    // Devuelve el número de streams usados.
+    static int64_t AssignFireStreams(int64_t stream);
+    // Vacía el estado compartido por la clase (fuegos, clusters, métricas y trazas)
+    // para ejecutar otra simulación en el mismo proceso tras Simulator::Destroy()
+    static void ResetSharedState();
 
     double CalculateWcaScore() const;
 
+    // Puntuación WCA calculada en la última elección
+    double GetWcaScore() const
+    {
+        return m_wcaScore;
+    }
+
     Ptr<Node> FindNearestLeader() const;
 
+    // Identificador del boid en la traza de posiciones (atributo BoidId o NodeId)
+    uint32_t GetBoidId() const;
+
     // Función para actualizar la pertenencia al cluster
     void UpdateClusterMembership();
 
-    // Variable estática para acceder a los clusters
-    static std::vector<NodeContainer>* s_clusters;
-    static NodeContainer* s_chNodes;
+    // Carga los Cluster-Heads y la distribución inicial de seguidores
+    static void SetClusters(const NodeContainer& chNodes, const std::vector<NodeContainer>& clusters);
+
+    // Pertenencia vigente; Export() la devuelve como un NodeContainer por cluster
+    static const BoidsClusterTable& GetClusterTable()
+    {
+        return s_clusterTable;
+    }
 
   private:
     virtual Vector DoGetPosition(void) const;
     virtual void DoSetPosition(const Vector& position);
     virtual Vector DoGetVelocity(void) const;
-    void Update(void);
+    virtual int64_t DoAssignStreams(int64_t stream);
     void DoInitialize(void);
+    virtual void DoDispose(void);
+
+    // Fases del tick, invocadas por BoidsFlockController
+    friend class BoidsFlockController;
+    friend class BoidsCheckpoint;
+    friend class BoidsFlockPartition;
+    void ConsumeEnergy(void);
+    void UpdateLeadership(void);
+    void UpdateWanderTarget(void);
+    // Instanciado para BoidsNeighborBuffer y BoidsNeighborBufferF (SinglePrecision)
+    template <typename T>
+    void ComputeNextState(BoidsNeighborBufferT<T>& neighborBuffer, BoidsFlockState& next) const;
+    void CommitState(void);
+
+    // Piezas del paso de ComputeNextState y de la traza de CommitState
+    void SteerLeader(const Vector& position, Vector& velocity) const;
+    void AdvanceStep(Vector& position, Vector& velocity) const;
+    void WritePositionRecord(const Vector& position) const;
+
+    // Contacto con fuegos (solo líderes): apaga el fuego al alcance, si lo hay, y
+    // devuelve cuántos pasos pueden pasar antes de alcanzar otro (UINT64_MAX si no
+    // hay fuegos o ya no es líder)
+    uint64_t CheckFireContact();
+    void ExtinguishFire(uint32_t fireId);
 
     Ptr<Node> GetBoidsNode() const;
 
+    double GetMaxInteractionRadius() const;
+    // Mayor radio de las reglas de los seguidores (el de la búsqueda de vecinos)
+    double GetRuleRadius() const;
+    static int32_t GetClusterHeadIndex(Ptr<Node> node);
+
     static std::ofstream* s_outFile;
+    static BoidsTraceWriter* s_traceWriter;
 
     // Parámetros del modelo Boids
     double m_separationRadius;
@@ -117,25 +224,58 @@ class BoidsMobilityModel : public MobilityModel
     double m_cohesionRadius;
     double m_leaderInfluenceRadius;
     double m_maxSpeed;
-    mutable bool m_isLeader;
+
+    // Cambia solo la marca de líder en el almacén (accesor del atributo IsLeader)
+    void SetLeaderFlag(bool isLeader);
 
     double m_energy;            // Energía residual (0.0 a 1.0)
     double m_degree;            // Grado de conectividad (número de vecinos)
-    double m_distanceToTargets; // Distancia acumulada a objetivos
+    double m_distanceToTargets; // Distancia media a los fuegos, limitada a 200 m
     double m_mobility;          // Medida de movilidad del nodo
+    double m_wcaScore;          // Puntuación de la última elección
 
-    mutable Vector m_position;
-    mutable Vector m_velocity;
+    // Posición, velocidad y estado de líder viven en el BoidsFlockState del controlador
     mutable Vector m_target; // Solo para líderes
+    // Fuego que AssignFiresToLeaders dio a este líder (INVALID: el más cercano)
+    uint32_t m_assignedFire;
+
+    Vector m_lastPosition;    // Posición en la elección anterior (para la movilidad WCA)
+    uint64_t m_lastMetricsTick; // Tick de la elección anterior
+
+    Ptr<BoidsFlockController> m_controller;
+    uint32_t m_boidIndex; // Índice en el controlador e id en la rejilla espacial
+    uint32_t m_boidId;    // Id global del boid si la bandada está repartida entre rangos
+
+    static BoidsClusterTable s_clusterTable;
+
+    // Fuentes de traza (sin coste si no hay nada conectado)
+    TracedCallback<uint32_t, bool, double> m_leadershipChangedTrace;
+    TracedCallback<uint32_t, uint32_t, Vector, Time> m_fireExtinguishedTrace;
+    TracedCallback<uint32_t, int32_t, int32_t> m_clusterChangedTrace;
+
+    // Generadores del modelo: destinos/velocidad inicial y consumo de energía
+    BoidsCountedRng<UniformRandomVariable> m_rng;
+    BoidsCountedRng<ExponentialRandomVariable> m_energyRng;
 
-    static std::vector<Vector> s_fires;
-    static Ptr<UniformRandomVariable> s_fireRng;
+    static BoidsFireRegistry s_fireRegistry;
+    static BoidsFireAssigner s_fireAssigner;
+    // Registra la aparición o extinción de un fuego en la traza (una fila por evento)
+    static void TraceFireEvent(uint32_t fireId, const Vector& fire, uint8_t event);
+    static void AddFire(const Vector& fire);
+    static BoidsCountedRng<UniformRandomVariable> s_fireRng;      // Cantidad y centros de fuegos
+    static BoidsCountedRng<NormalRandomVariable> s_fireOffsetRng; // Dispersión dentro de un cluster
+    static void CreateFireRngs();
+    // Próxima ejecución de los eventos periódicos de fuegos (para los checkpoints)
+    static EventId s_fireEvent;
+    static EventId s_checkFireEvent;
+    static EventId s_assignEvent;
     static Time s_fireInterval;
+    static Time s_fireSweepInterval;
     static double s_fireRadius;
-    // Parámetros para Thomas cluster process
-    static uint32_t s_clusterCount;
-    static double s_clusterDeviation;
-    static std::vector<Vector> s_clusterCenters;
+    static BoidsPointProcess s_fireProcess;
+    static std::vector<Vector> s_fireBatch; // Patrón en curso cuando no hay línea temporal
+    static const BoidsFireTimeline* s_fireTimeline;
+    static uint64_t s_fireTimelineCursor; // Primer fuego de la línea temporal aún no añadido
     void UpdateWcaMetrics();
     bool IsIsolated() const;
 };
@@ -0,0 +1,88 @@
+#include "boids-neighbor-lists.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+BoidsNeighborLists::BoidsNeighborLists()
+    : m_valid(false),
+      m_radius(0.0),
+      m_skin(0.0),
+      m_builds(0)
+{
+}
+
+void
+BoidsNeighborLists::Invalidate()
+{
+    m_valid = false;
+}
+
+void
+BoidsNeighborLists::Clear()
+{
+    m_valid = false;
+    m_lists.clear();
+    m_x.clear();
+    m_y.clear();
+}
+
+bool
+BoidsNeighborLists::NeedsRebuild(const BoidsFlockState& state,
+                                 const BoidsSpatialGrid& grid,
+                                 double radius,
+                                 double skin) const
+{
+    if (!m_valid || radius != m_radius || skin != m_skin || state.GetN() != m_x.size())
+    {
+        return true;
+    }
+    const double limit2 = skin * skin / 4;
+    for (uint32_t i = 0; i < m_x.size(); ++i)
+    {
+        double dx = BoidsSpatialGrid::WrapDelta(state.x[i] - m_x[i], grid.GetWidth());
+        double dy = BoidsSpatialGrid::WrapDelta(state.y[i] - m_y[i], grid.GetHeight());
+        if (dx * dx + dy * dy > limit2)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+BoidsNeighborLists::Build(const BoidsFlockState& state,
+                          const BoidsSpatialGrid& grid,
+                          double radius,
+                          double skin,
+                          BoidsThreadPool& pool)
+{
+    const uint32_t n = state.GetN();
+    m_lists.resize(n);
+    m_x.assign(state.x.begin(), state.x.end());
+    m_y.assign(state.y.begin(), state.y.end());
+    pool.ParallelFor(n, [&](uint32_t begin, uint32_t end, uint32_t worker) {
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            std::vector<uint32_t>& list = m_lists[i];
+            list.clear();
+            grid.ForEachInRadius(m_x[i],
+                                 m_y[i],
+                                 radius + skin,
+                                 [&](uint32_t id, double dx, double dy, double d2) {
+                                     if (id != i)
+                                     {
+                                         list.push_back(id);
+                                     }
+                                 });
+            std::sort(list.begin(), list.end());
+        }
+    });
+    m_radius = radius;
+    m_skin = skin;
+    m_valid = true;
+    m_builds++;
+}
+
+} // namespace ns3
@@ -0,0 +1,85 @@
+#ifndef BOIDS_NEIGHBOR_LISTS_H
+#define BOIDS_NEIGHBOR_LISTS_H
+
+#include "boids-flock-state.h"
+#include "boids-spatial-grid.h"
+#include "boids-thread-pool.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Listas de vecinos de Verlet de la bandada.
+ *
+ * Cada boid guarda los índices de los boids a menos de radio + margen (skin) en
+ * el momento de construirlas. Mientras ningún boid se haya desplazado más de
+ * margen / 2 desde entonces, dos boids no pueden haberse acercado más que el
+ * margen, así que todo vecino a menos del radio sigue en la lista: basta
+ * recorrerla filtrando por distancia en lugar de consultar la rejilla. La
+ * comprobación de desplazamientos es O(n) por tick; la reconstrucción, una
+ * consulta a la rejilla por boid, solo se hace cuando falla.
+ *
+ * Los índices son los del controlador: cualquier alta o baja de un boid las
+ * invalida. Cada lista va ordenada por índice, así que las sumas de las reglas no
+ * dependen del número de hilos ni de cuándo se construyó (un checkpoint
+ * restaurado la reconstruye en otros ticks), aunque pueden diferir en el
+ * redondeo de las de una consulta directa a la rejilla.
+ */
+class BoidsNeighborLists
+{
+  public:
+    BoidsNeighborLists();
+
+    bool IsValid() const
+    {
+        return m_valid;
+    }
+
+    // Descarta las listas; la siguiente comprobación pide reconstruirlas
+    void Invalidate();
+    void Clear();
+
+    /**
+     * Si alguna lista puede haber perdido un vecino a menos de radius: no hay
+     * listas, cambió el radio, el margen o el número de boids, o algún boid se ha
+     * desplazado más de skin / 2 (con envolvimiento) desde la construcción.
+     */
+    bool NeedsRebuild(const BoidsFlockState& state,
+                      const BoidsSpatialGrid& grid,
+                      double radius,
+                      double skin) const;
+
+    // Reconstruye todas las listas a radio + skin con la rejilla (en paralelo)
+    void Build(const BoidsFlockState& state,
+               const BoidsSpatialGrid& grid,
+               double radius,
+               double skin,
+               BoidsThreadPool& pool);
+
+    // Índices a menos de radio + margen en la construcción, sin el propio boid
+    const std::vector<uint32_t>& Get(uint32_t index) const
+    {
+        return m_lists[index];
+    }
+
+    uint64_t GetBuilds() const
+    {
+        return m_builds;
+    }
+
+  private:
+    bool m_valid;
+    double m_radius;
+    double m_skin;
+    uint64_t m_builds;
+    std::vector<std::vector<uint32_t>> m_lists; // Por índice; conservan su capacidad
+    std::vector<double> m_x;                    // Posición de cada boid en la construcción
+    std::vector<double> m_y;
+};
+
+} // namespace ns3
+
+#endif /* BOIDS_NEIGHBOR_LISTS_H */
@@ -0,0 +1,231 @@
+#include "ns3/boids-point-process.h"
+#include "ns3/test.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+namespace
+{
+
+const double WIDTH = 800.0;
+const double HEIGHT = 500.0;
+
+std::vector<char>
+ReadFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(file),
+                             std::istreambuf_iterator<char>());
+}
+
+void
+WriteFile(const std::string& path, const std::vector<char>& bytes)
+{
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    file.write(bytes.data(), bytes.size());
+}
+
+// Línea temporal de 20 s con streams fijos: la misma en cada llamada
+void
+GenerateTimeline(BoidsPointProcess::Type type, BoidsFireTimeline& timeline)
+{
+    BoidsPointProcess process;
+    process.SetType(type);
+    process.SetArea(WIDTH, HEIGHT);
+    process.SetMeanCount(4.0);
+    process.SetParentMean(2.0);
+    process.SetSpread(40.0);
+    process.SetInhibitionRadius(90.0);
+
+    BoidsCountedRng<UniformRandomVariable> uniform;
+    BoidsCountedRng<NormalRandomVariable> normal;
+    uniform.Create();
+    normal.Create();
+    uniform.SetStream(40 + type);
+    normal.SetStream(50 + type);
+    process.GenerateTimeline(uniform, normal, Seconds(1), Seconds(2), Seconds(21), timeline);
+}
+
+} // namespace
+
+/**
+ * Para cada proceso, la línea temporal generada con streams fijos se guarda y se
+ * vuelve a leer: los registros, los parámetros y la separación deben ser los
+ * mismos, y guardar lo leído debe dar el mismo archivo byte a byte. También se
+ * comprueba que cada fuego cae en el área en un instante del patrón, y que con
+ * inhibición los puntos de un mismo patrón respetan la distancia mínima.
+ */
+class BoidsFireTimelineRoundTripTestCase : public TestCase
+{
+  public:
+    BoidsFireTimelineRoundTripTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+BoidsFireTimelineRoundTripTestCase::BoidsFireTimelineRoundTripTestCase()
+    : TestCase("Línea temporal de fuegos guardada y leída idéntica")
+{
+}
+
+void
+BoidsFireTimelineRoundTripTestCase::DoRun()
+{
+    for (BoidsPointProcess::Type type : {BoidsPointProcess::POISSON,
+                                         BoidsPointProcess::THOMAS,
+                                         BoidsPointProcess::MATERN,
+                                         BoidsPointProcess::INHIBITION})
+    {
+        std::string name = BoidsPointProcess::GetTypeName(type);
+        BoidsFireTimeline timeline;
+        GenerateTimeline(type, timeline);
+        NS_TEST_ASSERT_MSG_GT(timeline.GetSize(), 0, "fuegos del proceso " << name);
+        NS_TEST_ASSERT_MSG_EQ(timeline.GetInterval(), Seconds(2), "separación (" << name << ")");
+
+        for (size_t i = 0; i < timeline.GetSize(); ++i)
+        {
+            const BoidsFireTimelineRecord& r = timeline[i];
+            NS_TEST_ASSERT_MSG_EQ((r.timeNs - Seconds(1).GetNanoSeconds()) %
+                                      Seconds(2).GetNanoSeconds(),
+                                  0,
+                                  "instante de un patrón (" << name << ")");
+            NS_TEST_ASSERT_MSG_LT(r.timeNs, Seconds(21).GetNanoSeconds(), "antes del final");
+            NS_TEST_ASSERT_MSG_EQ((r.x >= 0.0 && r.x <= WIDTH && r.y >= 0.0 && r.y <= HEIGHT),
+                                  true,
+                                  "fuego " << i << " dentro del área (" << name << ")");
+            if (i > 0)
+            {
+                NS_TEST_ASSERT_MSG_EQ((timeline[i - 1].timeNs <= r.timeNs),
+                                      true,
+                                      "registros ordenados por instante (" << name << ")");
+            }
+            for (size_t j = 0; type == BoidsPointProcess::INHIBITION && j < i; ++j)
+            {
+                if (timeline[j].timeNs != r.timeNs)
+                {
+                    continue;
+                }
+                double dx = std::abs(timeline[j].x - r.x);
+                double dy = std::abs(timeline[j].y - r.y);
+                dx = std::min(dx, WIDTH - dx);
+                dy = std::min(dy, HEIGHT - dy);
+                NS_TEST_ASSERT_MSG_GT_OR_EQ(std::sqrt(dx * dx + dy * dy),
+                                            90.0,
+                                            "distancia entre los fuegos " << j << " y " << i);
+            }
+        }
+
+        // Mismos streams, misma línea temporal
+        BoidsFireTimeline again;
+        GenerateTimeline(type, again);
+        NS_TEST_ASSERT_MSG_EQ(again.GetSize(), timeline.GetSize(), "regenerar (" << name << ")");
+
+        std::string path = CreateTempDirFilename("boids-fire-timeline-" + name + ".bin");
+        std::string copy = CreateTempDirFilename("boids-fire-timeline-" + name + "-copy.bin");
+        NS_TEST_ASSERT_MSG_EQ(timeline.Save(path), true, "guardar (" << name << ")");
+        BoidsFireTimeline loaded;
+        NS_TEST_ASSERT_MSG_EQ(loaded.Load(path), true, "leer (" << name << ")");
+        NS_TEST_ASSERT_MSG_EQ(loaded.GetSize(),
+                              timeline.GetSize(),
+                              "fuegos leídos (" << name << ")");
+        NS_TEST_ASSERT_MSG_EQ(loaded.GetInterval(), timeline.GetInterval(), "separación leída");
+        const BoidsPointProcessParams& params = timeline.GetParams();
+        NS_TEST_ASSERT_MSG_EQ(std::memcmp(&loaded.GetParams(), &params, sizeof(params)),
+                              0,
+                              "parámetros leídos (" << name << ")");
+        for (size_t i = 0; i < timeline.GetSize() && i < loaded.GetSize(); ++i)
+        {
+            NS_TEST_ASSERT_MSG_EQ(loaded[i].timeNs, timeline[i].timeNs, "instante " << i);
+            NS_TEST_ASSERT_MSG_EQ(loaded[i].x, timeline[i].x, "x del fuego " << i);
+            NS_TEST_ASSERT_MSG_EQ(loaded[i].y, timeline[i].y, "y del fuego " << i);
+            NS_TEST_ASSERT_MSG_EQ(again[i].x, timeline[i].x, "x regenerada del fuego " << i);
+            NS_TEST_ASSERT_MSG_EQ(again[i].y, timeline[i].y, "y regenerada del fuego " << i);
+        }
+        NS_TEST_ASSERT_MSG_EQ(loaded.Save(copy), true, "guardar lo leído (" << name << ")");
+        NS_TEST_ASSERT_MSG_EQ((ReadFile(copy) == ReadFile(path)),
+                              true,
+                              "mismo archivo al guardar lo leído (" << name << ")");
+    }
+}
+
+/**
+ * Load rechaza un archivo con otra firma, uno truncado y uno con los registros
+ * fuera de orden (la repetición avanza con un cursor), y deja la línea vacía.
+ */
+class BoidsFireTimelineInvalidTestCase : public TestCase
+{
+  public:
+    BoidsFireTimelineInvalidTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+BoidsFireTimelineInvalidTestCase::BoidsFireTimelineInvalidTestCase()
+    : TestCase("Líneas temporales de fuegos inválidas rechazadas")
+{
+}
+
+void
+BoidsFireTimelineInvalidTestCase::DoRun()
+{
+    BoidsFireTimeline timeline;
+    GenerateTimeline(BoidsPointProcess::POISSON, timeline);
+    NS_TEST_ASSERT_MSG_GT(timeline.GetSize(), 1, "al menos dos fuegos");
+    std::string path = CreateTempDirFilename("boids-fire-timeline.bin");
+    NS_TEST_ASSERT_MSG_EQ(timeline.Save(path), true, "guardar");
+    const std::vector<char> bytes = ReadFile(path);
+
+    std::string invalid = CreateTempDirFilename("boids-fire-timeline-invalid.bin");
+    BoidsFireTimeline loaded;
+
+    std::vector<char> badMagic = bytes;
+    badMagic[0] = 'X';
+    WriteFile(invalid, badMagic);
+    NS_TEST_ASSERT_MSG_EQ(loaded.Load(invalid), false, "otra firma");
+    NS_TEST_ASSERT_MSG_EQ(loaded.GetSize(), 0, "vacía tras otra firma");
+
+    std::vector<char> truncated(bytes.begin(), bytes.end() - sizeof(BoidsFireTimelineRecord) / 2);
+    WriteFile(invalid, truncated);
+    NS_TEST_ASSERT_MSG_EQ(loaded.Load(invalid), false, "archivo truncado");
+    NS_TEST_ASSERT_MSG_EQ(loaded.GetSize(), 0, "vacía tras un archivo truncado");
+
+    // El último fuego pasa a ser anterior al primero
+    std::vector<char> unsorted = bytes;
+    BoidsFireTimelineRecord last;
+    char* lastBytes = unsorted.data() + unsorted.size() - sizeof(last);
+    std::memcpy(&last, lastBytes, sizeof(last));
+    last.timeNs = timeline[0].timeNs - 1;
+    std::memcpy(lastBytes, &last, sizeof(last));
+    WriteFile(invalid, unsorted);
+    NS_TEST_ASSERT_MSG_EQ(loaded.Load(invalid), false, "registros fuera de orden");
+    NS_TEST_ASSERT_MSG_EQ(loaded.GetSize(), 0, "vacía tras registros fuera de orden");
+
+    NS_TEST_ASSERT_MSG_EQ(loaded.Load(path), true, "el original sigue siendo válido");
+}
+
+/**
+ * Pruebas de BoidsPointProcess y BoidsFireTimeline.
+ */
+class BoidsPointProcessTestSuite : public TestSuite
+{
+  public:
+    BoidsPointProcessTestSuite();
+};
+
+BoidsPointProcessTestSuite::BoidsPointProcessTestSuite()
+    : TestSuite("boids-point-process", Type::UNIT)
+{
+    AddTestCase(new BoidsFireTimelineRoundTripTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new BoidsFireTimelineInvalidTestCase, TestCase::Duration::QUICK);
+}
+
+static BoidsPointProcessTestSuite g_boidsPointProcessTestSuite;
@@ -0,0 +1,298 @@
+#include "boids-point-process.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace ns3
+{
+
+// Candidatos por punto antes de dar por lleno un patrón de inhibición
+static const uint32_t INHIBITION_ATTEMPTS = 50;
+
+BoidsFireTimeline::BoidsFireTimeline()
+    : m_intervalNs(0)
+{
+    std::memset(&m_params, 0, sizeof(m_params));
+}
+
+void
+BoidsFireTimeline::Clear()
+{
+    m_records.clear();
+    m_intervalNs = 0;
+}
+
+bool
+BoidsFireTimeline::Save(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    BoidsFireTimelineHeader header;
+    std::memcpy(header.magic, BOIDS_FIRE_TIMELINE_MAGIC, sizeof(header.magic));
+    header.version = BOIDS_FIRE_TIMELINE_VERSION;
+    header.recordSize = sizeof(BoidsFireTimelineRecord);
+    header.nRecords = m_records.size();
+    header.intervalNs = m_intervalNs;
+    header.params = m_params;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(m_records.data()),
+               m_records.size() * sizeof(BoidsFireTimelineRecord));
+    return static_cast<bool>(file);
+}
+
+bool
+BoidsFireTimeline::Load(const std::string& path)
+{
+    Clear();
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    BoidsFireTimelineHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, BOIDS_FIRE_TIMELINE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != BOIDS_FIRE_TIMELINE_VERSION ||
+        header.recordSize != sizeof(BoidsFireTimelineRecord))
+    {
+        return false;
+    }
+
+    m_records.resize(header.nRecords);
+    if (!file.read(reinterpret_cast<char*>(m_records.data()),
+                   m_records.size() * sizeof(BoidsFireTimelineRecord)))
+    {
+        m_records.clear();
+        return false;
+    }
+    // La repetición avanza con un cursor: los registros deben ir en orden
+    if (!std::is_sorted(m_records.begin(),
+                        m_records.end(),
+                        [](const BoidsFireTimelineRecord& a, const BoidsFireTimelineRecord& b) {
+                            return a.timeNs < b.timeNs;
+                        }))
+    {
+        m_records.clear();
+        return false;
+    }
+    m_params = header.params;
+    m_intervalNs = header.intervalNs;
+    return true;
+}
+
+BoidsPointProcess::BoidsPointProcess()
+{
+    // Por defecto, lo que hacía AddRandomFire: ~2 fuegos por patrón en torno a 3
+    // centros con 50 m de desviación, en el mundo de 1000x1000
+    std::memset(&m_params, 0, sizeof(m_params));
+    m_params.type = THOMAS;
+    m_params.meanCount = 2.0;
+    m_params.parentMean = 3.0;
+    m_params.spread = 50.0;
+    m_params.inhibitionRadius = 60.0;
+    m_params.width = 1000.0;
+    m_params.height = 1000.0;
+}
+
+bool
+BoidsPointProcess::SetType(const std::string& name)
+{
+    if (name == "poisson")
+    {
+        SetType(POISSON);
+    }
+    else if (name == "thomas")
+    {
+        SetType(THOMAS);
+    }
+    else if (name == "matern")
+    {
+        SetType(MATERN);
+    }
+    else if (name == "inhibition")
+    {
+        SetType(INHIBITION);
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+std::string
+BoidsPointProcess::GetTypeName(Type type)
+{
+    switch (type)
+    {
+    case POISSON:
+        return "poisson";
+    case THOMAS:
+        return "thomas";
+    case MATERN:
+        return "matern";
+    case INHIBITION:
+        return "inhibition";
+    }
+    return "unknown";
+}
+
+void
+BoidsPointProcess::SetArea(double width, double height)
+{
+    m_params.width = width;
+    m_params.height = height;
+}
+
+uint32_t
+BoidsPointProcess::DrawPoisson(BoidsCountedRng<UniformRandomVariable>& uniform, double mean)
+{
+    // Knuth por tramos para que exp(-media) no se anule con medias grandes
+    uint32_t count = 0;
+    while (mean > 0.0)
+    {
+        double chunk = std::min(mean, 500.0);
+        mean -= chunk;
+        double limit = std::exp(-chunk);
+        double p = uniform.GetValue();
+        while (p > limit)
+        {
+            ++count;
+            p *= uniform.GetValue();
+        }
+    }
+    return count;
+}
+
+double
+BoidsPointProcess::Wrap(double value, double size) const
+{
+    return value - size * std::floor(value / size);
+}
+
+bool
+BoidsPointProcess::IsInhibited(const std::vector<Vector>& points, double x, double y) const
+{
+    const double r2 = m_params.inhibitionRadius * m_params.inhibitionRadius;
+    for (const Vector& p : points)
+    {
+        double dx = std::abs(p.x - x);
+        double dy = std::abs(p.y - y);
+        dx = std::min(dx, m_params.width - dx);
+        dy = std::min(dy, m_params.height - dy);
+        if (dx * dx + dy * dy < r2)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+BoidsPointProcess::Generate(BoidsCountedRng<UniformRandomVariable>& uniform,
+                            BoidsCountedRng<NormalRandomVariable>& normal,
+                            std::vector<Vector>& points)
+{
+    const double width = m_params.width;
+    const double height = m_params.height;
+    points.clear();
+
+    switch (GetType())
+    {
+    case POISSON: {
+        uint32_t n = DrawPoisson(uniform, m_params.meanCount);
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            double x = uniform.GetValue(0.0, width);
+            double y = uniform.GetValue(0.0, height);
+            points.emplace_back(x, y, 0.0);
+        }
+        break;
+    }
+    case THOMAS:
+    case MATERN: {
+        // Cada centro tiene su propio número de hijos (no n/k repartido a mano)
+        uint32_t parents = DrawPoisson(uniform, m_params.parentMean);
+        double childMean = m_params.parentMean > 0.0 ? m_params.meanCount / m_params.parentMean : 0.0;
+        const double variance = m_params.spread * m_params.spread;
+        for (uint32_t i = 0; i < parents; ++i)
+        {
+            double cx = uniform.GetValue(0.0, width);
+            double cy = uniform.GetValue(0.0, height);
+            uint32_t children = DrawPoisson(uniform, childMean);
+            for (uint32_t j = 0; j < children; ++j)
+            {
+                double dx;
+                double dy;
+                if (GetType() == THOMAS)
+                {
+                    dx = normal.GetValue(0.0, variance);
+                    dy = normal.GetValue(0.0, variance);
+                }
+                else
+                {
+                    // Uniforme en el disco: radio con raíz para densidad constante
+                    double r = m_params.spread * std::sqrt(uniform.GetValue());
+                    double angle = uniform.GetValue(0.0, 2.0 * M_PI);
+                    dx = r * std::cos(angle);
+                    dy = r * std::sin(angle);
+                }
+                // El mundo es toroidal: los hijos que salen del área entran por el otro lado
+                points.emplace_back(Wrap(cx + dx, width), Wrap(cy + dy, height), 0.0);
+            }
+        }
+        break;
+    }
+    case INHIBITION: {
+        uint32_t n = DrawPoisson(uniform, m_params.meanCount);
+        uint32_t attempts = n * INHIBITION_ATTEMPTS;
+        while (points.size() < n && attempts-- > 0)
+        {
+            double x = uniform.GetValue(0.0, width);
+            double y = uniform.GetValue(0.0, height);
+            if (!IsInhibited(points, x, y))
+            {
+                points.emplace_back(x, y, 0.0);
+            }
+        }
+        break;
+    }
+    }
+}
+
+void
+BoidsPointProcess::GenerateTimeline(BoidsCountedRng<UniformRandomVariable>& uniform,
+                                    BoidsCountedRng<NormalRandomVariable>& normal,
+                                    Time start,
+                                    Time interval,
+                                    Time stop,
+                                    BoidsFireTimeline& timeline)
+{
+    timeline.Clear();
+    timeline.m_params = m_params;
+    timeline.m_intervalNs = interval.GetNanoSeconds();
+    if (interval.GetNanoSeconds() <= 0 || stop <= start)
+    {
+        return;
+    }
+
+    uint64_t patterns = (stop - start).GetNanoSeconds() / interval.GetNanoSeconds() + 1;
+    timeline.m_records.reserve(static_cast<size_t>(patterns * m_params.meanCount * 1.25) + 16);
+    for (Time t = start; t < stop; t += interval)
+    {
+        Generate(uniform, normal, m_scratch);
+        for (const Vector& p : m_scratch)
+        {
+            timeline.m_records.push_back({t.GetNanoSeconds(), p.x, p.y});
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,217 @@
+#ifndef BOIDS_POINT_PROCESS_H
+#define BOIDS_POINT_PROCESS_H
+
+#include "boids-counted-rng.h"
+
+#include "ns3/nstime.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/vector.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Formato binario de una línea temporal de fuegos (little-endian).
+ *
+ *   cabecera | registro por fuego (ordenados por instante)
+ *
+ * La cabecera guarda el proceso y los parámetros con que se generó, solo como
+ * referencia: al repetir el archivo se usan los registros tal cual.
+ */
+static const char BOIDS_FIRE_TIMELINE_MAGIC[8] = {'B', 'O', 'I', 'D', 'S', 'F', 'T', '1'};
+static const uint32_t BOIDS_FIRE_TIMELINE_VERSION = 1;
+
+struct BoidsPointProcessParams
+{
+    uint32_t type;           // BoidsPointProcess::Type
+    uint32_t reserved;
+    double meanCount;        // Puntos esperados por patrón
+    double parentMean;       // Centros de cluster esperados (Thomas y Matérn)
+    double spread;           // Desviación (Thomas) o radio (Matérn) alrededor del centro
+    double inhibitionRadius; // Distancia mínima entre puntos (inhibición)
+    double width;
+    double height;
+};
+
+struct BoidsFireTimelineHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t nRecords;
+    int64_t intervalNs; // Separación entre patrones
+    BoidsPointProcessParams params;
+};
+
+struct BoidsFireTimelineRecord
+{
+    int64_t timeNs;
+    double x;
+    double y;
+};
+
+static_assert(sizeof(BoidsPointProcessParams) == 56, "parámetros de 56 bytes");
+static_assert(sizeof(BoidsFireTimelineHeader) == 88, "cabecera de 88 bytes");
+static_assert(sizeof(BoidsFireTimelineRecord) == 24, "registro de 24 bytes");
+
+/**
+ * Línea temporal de fuegos de una ejecución completa en un arreglo plano.
+ *
+ * Se genera de una vez con BoidsPointProcess::GenerateTimeline o se lee de un
+ * archivo; repetir el mismo archivo en varias variantes da comparaciones
+ * pareadas (mismos fuegos en los mismos instantes).
+ */
+class BoidsFireTimeline
+{
+  public:
+    BoidsFireTimeline();
+
+    void Clear();
+
+    bool Save(const std::string& path) const;
+    bool Load(const std::string& path);
+
+    size_t GetSize() const
+    {
+        return m_records.size();
+    }
+
+    const BoidsFireTimelineRecord& operator[](size_t i) const
+    {
+        return m_records[i];
+    }
+
+    // Proceso y separación con que se generó
+    const BoidsPointProcessParams& GetParams() const
+    {
+        return m_params;
+    }
+
+    Time GetInterval() const
+    {
+        return NanoSeconds(m_intervalNs);
+    }
+
+  private:
+    friend class BoidsPointProcess;
+
+    std::vector<BoidsFireTimelineRecord> m_records;
+    BoidsPointProcessParams m_params;
+    int64_t m_intervalNs;
+};
+
+/**
+ * Procesos puntuales espaciales para la aparición de fuegos en el área
+ * (toroidal, como el mundo de los boids):
+ *   - POISSON: número de puntos Poisson(media) con posición uniforme,
+ *   - THOMAS: centros Poisson(padres), cada uno con Poisson(media/padres) hijos
+ *     desplazados con una normal de desviación 'spread',
+ *   - MATERN: como THOMAS pero con los hijos uniformes en un disco de radio 'spread',
+ *   - INHIBITION: inhibición secuencial; Poisson(media) candidatos uniformes que
+ *     se descartan si caen a menos de 'inhibitionRadius' de un punto aceptado.
+ * Los generadores se reciben por parámetro para que sus streams y sorteos sean los
+ * del modelo (AssignFireStreams y los checkpoints los tienen en cuenta).
+ */
+class BoidsPointProcess
+{
+  public:
+    enum Type
+    {
+        POISSON,
+        THOMAS,
+        MATERN,
+        INHIBITION
+    };
+
+    BoidsPointProcess();
+
+    void SetType(Type type)
+    {
+        m_params.type = type;
+    }
+
+    Type GetType() const
+    {
+        return static_cast<Type>(m_params.type);
+    }
+
+    // "poisson", "thomas", "matern" o "inhibition"; false si el nombre no existe
+    bool SetType(const std::string& name);
+    static std::string GetTypeName(Type type);
+
+    void SetArea(double width, double height);
+
+    void SetMeanCount(double mean)
+    {
+        m_params.meanCount = mean;
+    }
+
+    double GetMeanCount() const
+    {
+        return m_params.meanCount;
+    }
+
+    void SetParentMean(double mean)
+    {
+        m_params.parentMean = mean;
+    }
+
+    double GetParentMean() const
+    {
+        return m_params.parentMean;
+    }
+
+    void SetSpread(double spread)
+    {
+        m_params.spread = spread;
+    }
+
+    double GetSpread() const
+    {
+        return m_params.spread;
+    }
+
+    void SetInhibitionRadius(double radius)
+    {
+        m_params.inhibitionRadius = radius;
+    }
+
+    double GetInhibitionRadius() const
+    {
+        return m_params.inhibitionRadius;
+    }
+
+    const BoidsPointProcessParams& GetParams() const
+    {
+        return m_params;
+    }
+
+    // Un patrón de puntos en 'points' (se vacía antes; no reserva si ya hay capacidad)
+    void Generate(BoidsCountedRng<UniformRandomVariable>& uniform,
+                  BoidsCountedRng<NormalRandomVariable>& normal,
+                  std::vector<Vector>& points);
+
+    // Un patrón cada 'interval' en [start, stop), todos seguidos en 'timeline'
+    void GenerateTimeline(BoidsCountedRng<UniformRandomVariable>& uniform,
+                          BoidsCountedRng<NormalRandomVariable>& normal,
+                          Time start,
+                          Time interval,
+                          Time stop,
+                          BoidsFireTimeline& timeline);
+
+  private:
+    static uint32_t DrawPoisson(BoidsCountedRng<UniformRandomVariable>& uniform, double mean);
+    double Wrap(double value, double size) const;
+    bool IsInhibited(const std::vector<Vector>& points, double x, double y) const;
+
+    BoidsPointProcessParams m_params;
+    std::vector<Vector> m_scratch; // Patrón en curso de GenerateTimeline
+};
+
+} // namespace ns3
+
+#endif /* BOIDS_POINT_PROCESS_H */
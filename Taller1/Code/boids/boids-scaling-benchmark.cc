@@ -0,0 +1,572 @@
+#include "ns3/boids-flock-controller.h"
+#include "ns3/boids-flock-partition.h"
+#include "ns3/boids-helper.h"
+#include "ns3/boids-mobility-model.h"
+#include "ns3/boids-trace-writer.h"
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/network-module.h"
+#ifdef NS3_MPI
+#include "ns3/mpi-interface.h"
+#endif
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/*------------------------------------------------
+    Benchmark de escalado de BoidsMobilityModel.
+
+    Recorre tamaños de bandada con semilla fija, con y sin traza de posiciones
+    y con y sin fuegos, sin pila Wi-Fi/IP. Por cada caso escribe una fila CSV con
+    ns por boid-paso, eventos del planificador por segundo simulado, pico de RSS
+    y el reparto del tiempo entre las fases del tick (WCA, pertenencia, reglas y
+    escritura).
+
+    Es un ejemplo del módulo mobility (se compila con --enable-examples), así que
+    cada versión del modelo se puede medir con el mismo programa:
+
+    ./ns3 run "boids-scaling-benchmark --sizes=100,1000,10000,100000 --output=bench.csv"
+
+    Con --validatePrecision=K no mide tiempos: ejecuta cada caso K ticks con las
+    reglas en double y otra vez en precisión simple (atributo SinglePrecision), con
+    la misma semilla, y escribe por caso la mayor divergencia de posición entre
+    ambas y los cambios de liderazgo que no coinciden. Un caso pasa si la
+    divergencia no supera --divergenceBudget metros y el liderazgo es idéntico;
+    si alguno falla el programa termina con código 1.
+
+    boids-scaling-benchmark --sizes=1000,10000 --validatePrecision=600 --output=prec.csv
+
+    Con --partition la bandada se reparte en franjas entre los rangos MPI
+    (BoidsFlockPartition): todos los rangos sortean las mismas posiciones
+    iniciales y cada uno crea solo los boids de su franja. El CSV, que escribe
+    el rango 0, da el tiempo del rango más lento y los totales de todos.
+
+    mpirun -np 4 boids-scaling-benchmark --partition --sizes=10000,100000
+------------------------------------------------*/
+
+struct BenchmarkConfig
+{
+    std::string sizes = "100,1000,10000,100000";
+    double simTime = 10.0;        // Segundos simulados por caso
+    uint32_t seed = 1;
+    uint32_t threads = 1;
+    double verletSkin = 20.0;     // Margen de las listas de vecinos (0 = rejilla)
+    bool singlePrecision = BOIDS_FLOCK_SINGLE_PRECISION; // Reglas en float
+    uint32_t validatePrecision = 0; // Ticks de la comparación float/double (0 = benchmark)
+    double divergenceBudget = 0.5;  // Divergencia máxima admitida en metros
+    bool partition = false;       // Repartir la bandada entre los rangos MPI
+    double leaderFraction = 0.02; // Fracción de líderes iniciales
+    std::string trace = "both";   // on, off o both
+    std::string fires = "both";   // on, off o both
+    std::string traceFormat = "binary";
+    std::string traceFile = "boids_benchmark_trace.bin";
+    std::string output = "boids_benchmark.csv";
+};
+
+struct BenchmarkResult
+{
+    uint32_t nBoids;
+    uint32_t nLeaders;
+    bool trace;
+    bool fires;
+    uint64_t ticks;
+    double setupSeconds;
+    double runSeconds;
+    uint64_t events;
+    double peakRssMb;
+    bool peakRssReset; // false: el pico incluye casos anteriores
+    BoidsFlockPhaseTimes phases;
+    uint32_t firesExtinguished;
+    uint32_t ranks;
+    uint64_t migrations; // Boids que cambiaron de rango
+};
+
+// Posiciones y liderazgo de todos los boids al final de cada tick, seguidos
+struct PrecisionSnapshots
+{
+    uint32_t nBoids = 0;
+    uint64_t ticks = 0;
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<uint8_t> leader;
+};
+
+struct PrecisionReport
+{
+    uint64_t ticks;
+    double maxDivergence;       // Metros, distancia envuelta
+    uint64_t maxDivergenceTick;
+    double finalMeanDivergence; // Media sobre los boids en el último tick
+    uint64_t leaderDifferences; // (tick, boid) con distinto estado de líder
+    int64_t firstLeaderDifference; // Primer tick con diferencias (-1 si ninguno)
+};
+
+std::vector<uint32_t>
+ParseSizes(const std::string& sizes)
+{
+    std::vector<uint32_t> result;
+    std::stringstream ss(sizes);
+    std::string item;
+    while (std::getline(ss, item, ','))
+    {
+        if (!item.empty())
+        {
+            result.push_back(std::strtoul(item.c_str(), nullptr, 10));
+        }
+    }
+    return result;
+}
+
+std::vector<bool>
+ParseSwitch(const std::string& value, const std::string& name)
+{
+    if (value == "both")
+    {
+        return {false, true};
+    }
+    if (value == "on")
+    {
+        return {true};
+    }
+    if (value == "off")
+    {
+        return {false};
+    }
+    NS_FATAL_ERROR("Valor de --" << name << " desconocido: " << value << " (on, off o both)");
+    return {};
+}
+
+// Reinicia el pico de RSS del proceso (Linux: VmHWM); devuelve false si no se pudo
+bool
+ResetPeakRss()
+{
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    if (!clearRefs)
+    {
+        return false;
+    }
+    clearRefs << "5";
+    clearRefs.close();
+    return !clearRefs.fail();
+}
+
+double
+GetPeakRssMb()
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line))
+    {
+        if (line.compare(0, 6, "VmHWM:") == 0)
+        {
+            return std::strtod(line.c_str() + 6, nullptr) / 1024.0; // kB
+        }
+    }
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.0;
+}
+
+// Conectado a FlockStats, que se emite al final de cada tick
+void
+RecordSnapshot(PrecisionSnapshots* snapshots, const BoidsFlockStats& stats)
+{
+    const BoidsFlockState& state = BoidsFlockController::Get()->GetState();
+    snapshots->nBoids = state.GetN();
+    snapshots->x.insert(snapshots->x.end(), state.x.begin(), state.x.end());
+    snapshots->y.insert(snapshots->y.end(), state.y.begin(), state.y.end());
+    snapshots->leader.insert(snapshots->leader.end(), state.leader.begin(), state.leader.end());
+    snapshots->ticks++;
+}
+
+PrecisionReport
+ComparePrecision(const PrecisionSnapshots& reference, const PrecisionSnapshots& single)
+{
+    PrecisionReport report = {std::min(reference.ticks, single.ticks), 0.0, 0, 0.0, 0, -1};
+    const uint32_t n = reference.nBoids;
+    for (uint64_t tick = 0; tick < report.ticks; ++tick)
+    {
+        double total = 0.0;
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            size_t k = tick * n + i;
+            double d = BoidsMobilityModel::CalculateWrappedDistance(
+                Vector(reference.x[k], reference.y[k], 0),
+                Vector(single.x[k], single.y[k], 0));
+            total += d;
+            if (d > report.maxDivergence)
+            {
+                report.maxDivergence = d;
+                report.maxDivergenceTick = tick;
+            }
+            if (reference.leader[k] != single.leader[k])
+            {
+                report.leaderDifferences++;
+                if (report.firstLeaderDifference < 0)
+                {
+                    report.firstLeaderDifference = tick;
+                }
+            }
+        }
+        report.finalMeanDivergence = n > 0 ? total / n : 0.0;
+    }
+    return report;
+}
+
+// Crea los boids de la franja del rango. Todos los rangos sortean las mismas
+// posiciones y streams, así que cada boid global g tiene el mismo estado inicial
+// con cualquier número de rangos; los líderes son los g < nLeaders
+void
+CreatePartitionedFlock(uint32_t nBoids,
+                       uint32_t nLeaders,
+                       BoidsFlockPartition& partition,
+                       NodeContainer& leaders)
+{
+    Ptr<UniformRandomVariable> position = CreateObject<UniformRandomVariable>();
+    position->SetAttribute("Max", DoubleValue(1000.0));
+    position->SetStream(0);
+    const int64_t boidStream = 1 + BoidsMobilityModel::AssignFireStreams(1);
+    partition.SetHostStream(boidStream +
+                            2 * static_cast<int64_t>(nBoids) * (1 + partition.GetRank()));
+
+    for (uint32_t g = 0; g < nBoids; ++g)
+    {
+        double x = position->GetValue();
+        double y = position->GetValue();
+        if (partition.GetOwner(x) != partition.GetRank())
+        {
+            continue;
+        }
+        Ptr<Node> node = CreateObject<Node>();
+        Ptr<BoidsMobilityModel> model = CreateObject<BoidsMobilityModel>();
+        node->AggregateObject(model);
+        model->SetAttribute("BoidId", UintegerValue(g));
+        model->SetPosition(Vector(x, y, 0));
+        model->AssignStreams(boidStream + 2 * static_cast<int64_t>(g));
+        if (g < nLeaders)
+        {
+            model->SetIsLeader(true);
+            leaders.Add(node);
+        }
+    }
+}
+
+BenchmarkResult
+RunCase(const BenchmarkConfig& config,
+        uint32_t nBoids,
+        bool trace,
+        bool fires,
+        PrecisionSnapshots* snapshots = nullptr)
+{
+    BenchmarkResult result;
+    result.nBoids = nBoids;
+    result.nLeaders = std::max<uint32_t>(1, nBoids * config.leaderFraction);
+    result.trace = trace;
+    result.fires = fires;
+    result.peakRssReset = ResetPeakRss();
+
+    auto setupStart = std::chrono::steady_clock::now();
+    RngSeedManager::SetSeed(config.seed);
+    RngSeedManager::SetRun(1);
+
+    // Uno por caso: los modelos libres que guarda mueren con Simulator::Destroy
+    std::unique_ptr<BoidsFlockPartition> partition;
+    NodeContainer leaders;
+    if (config.partition)
+    {
+        partition = std::make_unique<BoidsFlockPartition>();
+        CreatePartitionedFlock(nBoids, result.nLeaders, *partition, leaders);
+        BoidsFlockController::Get()->SetPartition(partition.get());
+    }
+    else
+    {
+        NodeContainer followers;
+        leaders.Create(result.nLeaders);
+        followers.Create(nBoids - std::min(nBoids, result.nLeaders));
+
+        MobilityHelper mobility;
+        mobility.SetMobilityModel("ns3::BoidsMobilityModel");
+        mobility.SetPositionAllocator("ns3::RandomRectanglePositionAllocator",
+                                      "X",
+                                      StringValue("ns3::UniformRandomVariable[Min=0|Max=1000]"),
+                                      "Y",
+                                      StringValue("ns3::UniformRandomVariable[Min=0|Max=1000]"));
+        mobility.Install(leaders);
+        mobility.Install(followers);
+
+        BoidsHelper boidsHelper;
+        int64_t stream = 1;
+        stream += boidsHelper.AssignStreams(leaders, stream);
+        stream += boidsHelper.AssignStreams(followers, stream);
+
+        for (uint32_t i = 0; i < leaders.GetN(); ++i)
+        {
+            leaders.Get(i)->GetObject<BoidsMobilityModel>()->SetIsLeader(true);
+        }
+    }
+    // Los seguidores se unen al cluster del líder más cercano en la primera elección
+    BoidsMobilityModel::SetClusters(leaders, std::vector<NodeContainer>(leaders.GetN()));
+
+    BoidsTraceWriter traceWriter;
+    if (trace)
+    {
+        // Cada rango escribe su propia traza
+        traceWriter.Open(partition ? config.traceFile + "." + std::to_string(partition->GetRank())
+                                   : config.traceFile,
+                         config.traceFormat == "binary" ? BoidsTraceWriter::BINARY
+                                                        : BoidsTraceWriter::CSV);
+        BoidsMobilityModel::SetTraceWriter(&traceWriter);
+    }
+    if (fires)
+    {
+        BoidsMobilityModel::AddRandomFire();
+        BoidsMobilityModel::CheckFireProximity();
+        Simulator::ScheduleNow(&BoidsMobilityModel::AssignFiresToLeaders);
+    }
+    result.setupSeconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - setupStart).count();
+
+    Time stopTime = Seconds(config.simTime);
+    if (snapshots)
+    {
+        Ptr<BoidsFlockController> flock = BoidsFlockController::Get();
+        flock->TraceConnectWithoutContext("FlockStats",
+                                          MakeBoundCallback(&RecordSnapshot, snapshots));
+        stopTime = flock->GetTickInterval() * static_cast<int64_t>(config.validatePrecision);
+    }
+    Simulator::Stop(stopTime);
+    uint64_t events = Simulator::GetEventCount();
+    auto runStart = std::chrono::steady_clock::now();
+    Simulator::Run();
+    if (trace)
+    {
+        // El vaciado de la traza forma parte del coste de escribirla
+        traceWriter.Close();
+        BoidsMobilityModel::SetTraceWriter(nullptr);
+    }
+    result.runSeconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - runStart).count();
+    result.events = Simulator::GetEventCount() - events;
+
+    Ptr<BoidsFlockController> controller = BoidsFlockController::Get();
+    result.phases = controller->GetPhaseTimes();
+    result.ticks = result.phases.ticks;
+    result.firesExtinguished = BoidsMobilityModel::s_totalFiresExtinguished;
+    result.peakRssMb = GetPeakRssMb();
+    result.ranks = 1;
+    result.migrations = 0;
+    if (partition)
+    {
+        // Tiempos y memoria del rango más lento; eventos, fuegos y migraciones de todos
+        result.ranks = partition->GetNRanks();
+        result.setupSeconds = partition->MaxAll(result.setupSeconds);
+        result.runSeconds = partition->MaxAll(result.runSeconds);
+        result.peakRssMb = partition->MaxAll(result.peakRssMb);
+        result.phases.wca = partition->MaxAll(result.phases.wca);
+        result.phases.membership = partition->MaxAll(result.phases.membership);
+        result.phases.rules = partition->MaxAll(result.phases.rules);
+        result.phases.commit = partition->MaxAll(result.phases.commit);
+        result.phases.exchange = partition->MaxAll(result.phases.exchange);
+        result.phases.neighbors = partition->MaxAll(result.phases.neighbors);
+        result.phases.neighborBuilds = partition->SumAll(result.phases.neighborBuilds);
+        result.phases.contactChecks = partition->SumAll(result.phases.contactChecks);
+        result.events = partition->SumAll(result.events);
+        result.firesExtinguished = partition->SumAll(uint64_t(result.firesExtinguished));
+        result.migrations = partition->SumAll(partition->GetEmigrants());
+    }
+
+    Simulator::Destroy();
+    BoidsMobilityModel::ResetSharedState();
+    return result;
+}
+
+void
+WriteHeader(std::ostream& out)
+{
+    out << "NBoids,NLeaders,Trace,Fires,Threads,SimSeconds,Ticks,SetupSeconds,RunSeconds,"
+           "NsPerBoidStep,Events,EventsPerSimSecond,PeakRssMb,PeakRssReset,WcaSeconds,"
+           "MembershipSeconds,RulesSeconds,CommitSeconds,OtherSeconds,FiresExtinguished,"
+           "ContactChecks,SinglePrecision,Ranks,ExchangeSeconds,Migrations,VerletSkin,"
+           "NeighborSeconds,NeighborBuilds\n";
+}
+
+void
+WritePrecisionHeader(std::ostream& out)
+{
+    out << "NBoids,Fires,Ticks,MaxDivergence,MaxDivergenceTick,FinalMeanDivergence,"
+           "LeaderDifferences,FirstLeaderDifferenceTick,Pass\n";
+}
+
+void
+WriteResult(std::ostream& out, const BenchmarkConfig& config, const BenchmarkResult& r)
+{
+    double boidSteps = static_cast<double>(r.nBoids) * std::max<uint64_t>(1, r.ticks);
+    double phases = r.phases.wca + r.phases.membership + r.phases.rules + r.phases.commit +
+                    r.phases.exchange + r.phases.neighbors;
+    out << r.nBoids << "," << r.nLeaders << "," << r.trace << "," << r.fires << ","
+        << config.threads << "," << config.simTime << "," << r.ticks << "," << r.setupSeconds
+        << "," << r.runSeconds << "," << r.runSeconds * 1e9 / boidSteps << "," << r.events << ","
+        << r.events / config.simTime << "," << r.peakRssMb << "," << r.peakRssReset << ","
+        << r.phases.wca << "," << r.phases.membership << "," << r.phases.rules << ","
+        << r.phases.commit << "," << std::max(0.0, r.runSeconds - phases) << ","
+        << r.firesExtinguished << "," << r.phases.contactChecks << ","
+        << config.singlePrecision << "," << r.ranks << "," << r.phases.exchange << ","
+        << r.migrations << "," << config.verletSkin << "," << r.phases.neighbors << ","
+        << r.phases.neighborBuilds << "\n";
+}
+
+// Ejecuta el caso en double y en float y compara sus trayectorias tick a tick
+bool
+ValidatePrecision(std::ostream& out, const BenchmarkConfig& config, uint32_t nBoids, bool fires)
+{
+    PrecisionSnapshots reference;
+    PrecisionSnapshots single;
+    Config::SetDefault("ns3::BoidsFlockController::SinglePrecision", BooleanValue(false));
+    RunCase(config, nBoids, false, fires, &reference);
+    Config::SetDefault("ns3::BoidsFlockController::SinglePrecision", BooleanValue(true));
+    RunCase(config, nBoids, false, fires, &single);
+
+    PrecisionReport r = ComparePrecision(reference, single);
+    bool pass = r.maxDivergence <= config.divergenceBudget && r.leaderDifferences == 0;
+    out << nBoids << "," << fires << "," << r.ticks << "," << r.maxDivergence << ","
+        << r.maxDivergenceTick << "," << r.finalMeanDivergence << "," << r.leaderDifferences << ","
+        << r.firstLeaderDifference << "," << pass << "\n";
+    std::cout << "N=" << nBoids << " fuegos=" << fires << ": divergencia máxima "
+              << r.maxDivergence << " m en el tick " << r.maxDivergenceTick << ", "
+              << r.leaderDifferences << " diferencias de liderazgo"
+              << (pass ? "" : " (fuera del presupuesto)") << std::endl;
+    return pass;
+}
+
+int
+main(int argc, char* argv[])
+{
+    BenchmarkConfig config;
+    CommandLine cmd;
+    cmd.AddValue("sizes", "Tamaños de bandada separados por comas", config.sizes);
+    cmd.AddValue("simTime", "Segundos simulados por caso", config.simTime);
+    cmd.AddValue("seed", "Semilla de los generadores aleatorios", config.seed);
+    cmd.AddValue("threads", "Hilos para el paso de la bandada", config.threads);
+    cmd.AddValue("verletSkin",
+                 "Margen de las listas de vecinos en metros (0 consulta la rejilla en cada tick)",
+                 config.verletSkin);
+    cmd.AddValue("singlePrecision",
+                 "Acumular las reglas en precisión simple (por defecto según BOIDS_FLOCK_FLOAT32)",
+                 config.singlePrecision);
+    cmd.AddValue("validatePrecision",
+                 "Ticks de la comparación de precisión simple frente a double (0 = benchmark)",
+                 config.validatePrecision);
+    cmd.AddValue("divergenceBudget",
+                 "Divergencia de posición admitida en la comparación de precisión (m)",
+                 config.divergenceBudget);
+    cmd.AddValue("partition",
+                 "Repartir la bandada en franjas entre los rangos MPI (lanzar con mpirun)",
+                 config.partition);
+    cmd.AddValue("leaderFraction", "Fracción de líderes iniciales", config.leaderFraction);
+    cmd.AddValue("trace", "Traza de posiciones: on, off o both", config.trace);
+    cmd.AddValue("fires", "Fuegos: on, off o both", config.fires);
+    cmd.AddValue("traceFormat", "Formato de la traza: csv o binary", config.traceFormat);
+    cmd.AddValue("traceFile", "Archivo temporal de la traza", config.traceFile);
+    cmd.AddValue("output", "CSV de resultados", config.output);
+    cmd.Parse(argc, argv);
+
+    if (config.partition)
+    {
+        if (!BoidsFlockPartition::IsAvailable())
+        {
+            NS_FATAL_ERROR("--partition necesita ns-3 compilado con --enable-mpi");
+        }
+        if (config.validatePrecision > 0)
+        {
+            NS_FATAL_ERROR("--partition no admite --validatePrecision");
+        }
+#ifdef NS3_MPI
+        MpiInterface::Enable(&argc, &argv);
+#endif
+    }
+    // Con la bandada repartida solo el rango 0 escribe resultados
+    const uint32_t rank = BoidsFlockPartition().GetRank();
+    const bool writer = rank == 0;
+
+    std::vector<uint32_t> sizes = ParseSizes(config.sizes);
+    std::vector<bool> traceModes = ParseSwitch(config.trace, "trace");
+    std::vector<bool> fireModes = ParseSwitch(config.fires, "fires");
+    Config::SetDefault("ns3::BoidsFlockController::Threads", UintegerValue(config.threads));
+    Config::SetDefault("ns3::BoidsFlockController::VerletSkin", DoubleValue(config.verletSkin));
+
+    std::ofstream out;
+    if (writer)
+    {
+        out.open(config.output);
+    }
+    if (writer && !out)
+    {
+        NS_FATAL_ERROR("No se pudo abrir " << config.output);
+    }
+    if (config.validatePrecision > 0)
+    {
+        WritePrecisionHeader(out);
+        bool pass = true;
+        for (uint32_t nBoids : sizes)
+        {
+            for (bool fires : fireModes)
+            {
+                pass = ValidatePrecision(out, config, nBoids, fires) && pass;
+                out.flush();
+            }
+        }
+        return pass ? 0 : 1;
+    }
+    Config::SetDefault("ns3::BoidsFlockController::SinglePrecision",
+                       BooleanValue(config.singlePrecision));
+    WriteHeader(out);
+
+    for (uint32_t nBoids : sizes)
+    {
+        for (bool trace : traceModes)
+        {
+            for (bool fires : fireModes)
+            {
+                BenchmarkResult result = RunCase(config, nBoids, trace, fires);
+                if (!writer)
+                {
+                    continue;
+                }
+                WriteResult(out, config, result);
+                out.flush();
+                std::cout << "N=" << nBoids << " traza=" << trace << " fuegos=" << fires << ": "
+                          << result.runSeconds * 1e9 /
+                                 (static_cast<double>(nBoids) * std::max<uint64_t>(1, result.ticks))
+                          << " ns/boid-paso, " << result.peakRssMb << " MB" << std::endl;
+            }
+        }
+    }
+    if (std::find(traceModes.begin(), traceModes.end(), true) != traceModes.end())
+    {
+        std::string traceFile = config.traceFile;
+        if (config.partition)
+        {
+            traceFile += "." + std::to_string(rank);
+        }
+        std::remove(traceFile.c_str());
+    }
+#ifdef NS3_MPI
+    if (config.partition)
+    {
+        MpiInterface::Disable();
+    }
+#endif
+    return 0;
+}
@@ -0,0 +1,256 @@
+#include "ns3/boids-spatial-grid.h"
+#include "ns3/test.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <tuple>
+#include <vector>
+
+using namespace ns3;
+
+namespace
+{
+
+// Mundo no cuadrado y celda que no lo divide: las celdas se estiran en cada eje
+const double WIDTH = 1000.0;
+const double HEIGHT = 600.0;
+const double CELL = 70.0;
+const uint32_t N_POINTS = 400;
+
+// Resultado de una consulta: id y desplazamiento envuelto
+using Hit = std::tuple<uint32_t, double, double>;
+
+struct Point
+{
+    double x;
+    double y;
+    bool inserted;
+};
+
+std::vector<Hit>
+GridQuery(const BoidsSpatialGrid& grid, double x, double y, double radius)
+{
+    std::vector<Hit> hits;
+    grid.ForEachInRadius(x, y, radius, [&](uint32_t id, double dx, double dy, double) {
+        hits.emplace_back(id, dx, dy);
+    });
+    std::sort(hits.begin(), hits.end());
+    return hits;
+}
+
+// Recorre todos los puntos con la misma distancia envuelta que la rejilla
+std::vector<Hit>
+BruteForceQuery(const std::vector<Point>& points, double x, double y, double radius)
+{
+    std::vector<Hit> hits;
+    for (uint32_t id = 0; id < points.size(); ++id)
+    {
+        if (!points[id].inserted)
+        {
+            continue;
+        }
+        double dx = BoidsSpatialGrid::WrapDelta(points[id].x - x, WIDTH);
+        double dy = BoidsSpatialGrid::WrapDelta(points[id].y - y, HEIGHT);
+        if (dx * dx + dy * dy < radius * radius)
+        {
+            hits.emplace_back(id, dx, dy);
+        }
+    }
+    return hits;
+}
+
+// Consultas repartidas por el mundo más las que tocan bordes y esquinas
+std::vector<std::pair<double, double>>
+QueryCenters(std::mt19937& rng)
+{
+    std::vector<std::pair<double, double>> centers = {{0.0, 0.0},
+                                                      {WIDTH - 1.0, HEIGHT - 1.0},
+                                                      {5.0, HEIGHT / 2},
+                                                      {WIDTH / 2, HEIGHT - 5.0},
+                                                      {WIDTH - 3.0, 2.0}};
+    std::uniform_real_distribution<double> ux(0.0, WIDTH);
+    std::uniform_real_distribution<double> uy(0.0, HEIGHT);
+    for (uint32_t q = 0; q < 40; ++q)
+    {
+        centers.emplace_back(ux(rng), uy(rng));
+    }
+    return centers;
+}
+
+} // namespace
+
+/**
+ * Las consultas por radio de la rejilla deben devolver los mismos elementos, con
+ * el mismo desplazamiento envuelto, que un recorrido de todos los puntos: cerca
+ * de los bordes y esquinas del toro, con radios menores que una celda y mayores
+ * que medio mundo, y después de mover y quitar elementos.
+ */
+class BoidsSpatialGridRadiusTestCase : public TestCase
+{
+  public:
+    BoidsSpatialGridRadiusTestCase();
+
+  private:
+    void DoRun() override;
+    void CheckQueries(const BoidsSpatialGrid& grid,
+                      const std::vector<Point>& points,
+                      std::mt19937& rng);
+};
+
+BoidsSpatialGridRadiusTestCase::BoidsSpatialGridRadiusTestCase()
+    : TestCase("Consultas por radio con envolvimiento iguales a un recorrido completo")
+{
+}
+
+void
+BoidsSpatialGridRadiusTestCase::CheckQueries(const BoidsSpatialGrid& grid,
+                                             const std::vector<Point>& points,
+                                             std::mt19937& rng)
+{
+    for (const auto& [x, y] : QueryCenters(rng))
+    {
+        for (double radius : {30.0, CELL, 150.0, 350.0, 700.0})
+        {
+            std::vector<Hit> expected = BruteForceQuery(points, x, y, radius);
+            std::vector<Hit> hits = GridQuery(grid, x, y, radius);
+            NS_TEST_ASSERT_MSG_EQ(hits.size(),
+                                  expected.size(),
+                                  "elementos a menos de " << radius << " de (" << x << ", " << y
+                                                          << ")");
+            NS_TEST_ASSERT_MSG_EQ((hits == expected),
+                                  true,
+                                  "ids y desplazamientos a menos de " << radius << " de (" << x
+                                                                      << ", " << y << ")");
+        }
+    }
+}
+
+void
+BoidsSpatialGridRadiusTestCase::DoRun()
+{
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> ux(0.0, WIDTH);
+    std::uniform_real_distribution<double> uy(0.0, HEIGHT);
+    std::uniform_real_distribution<double> edge(0.0, 8.0);
+
+    BoidsSpatialGrid grid;
+    grid.Configure(WIDTH, HEIGHT, CELL);
+    std::vector<Point> points(N_POINTS);
+    for (uint32_t id = 0; id < N_POINTS; ++id)
+    {
+        // Una cuarta parte pegada a los bordes, donde actúa el envolvimiento
+        points[id] = {ux(rng), uy(rng), true};
+        if (id % 4 == 0)
+        {
+            points[id].x = (id % 8 == 0) ? edge(rng) : WIDTH - edge(rng);
+        }
+        grid.Insert(id, points[id].x, points[id].y);
+    }
+    CheckQueries(grid, points, rng);
+
+    // Mover a través de los bordes y quitar elementos deja las celdas en otro orden
+    std::uniform_real_distribution<double> step(-60.0, 60.0);
+    for (uint32_t id = 0; id < N_POINTS; ++id)
+    {
+        if (id % 5 == 0)
+        {
+            grid.Remove(id);
+            points[id].inserted = false;
+            continue;
+        }
+        points[id].x = std::fmod(points[id].x + step(rng) + WIDTH, WIDTH);
+        points[id].y = std::fmod(points[id].y + step(rng) + HEIGHT, HEIGHT);
+        grid.Move(id, points[id].x, points[id].y);
+    }
+    CheckQueries(grid, points, rng);
+
+    // Reconfigurar con otra celda reubica lo insertado
+    grid.Configure(WIDTH, HEIGHT, 2.5 * CELL);
+    CheckQueries(grid, points, rng);
+}
+
+/**
+ * FindNearest debe encontrar el elemento aceptado más cercano, o ninguno si no
+ * hay uno dentro del radio máximo, igual que un recorrido de todos los puntos.
+ */
+class BoidsSpatialGridNearestTestCase : public TestCase
+{
+  public:
+    BoidsSpatialGridNearestTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+BoidsSpatialGridNearestTestCase::BoidsSpatialGridNearestTestCase()
+    : TestCase("Vecino más cercano con envolvimiento igual a un recorrido completo")
+{
+}
+
+void
+BoidsSpatialGridNearestTestCase::DoRun()
+{
+    std::mt19937 rng(23);
+    std::uniform_real_distribution<double> ux(0.0, WIDTH);
+    std::uniform_real_distribution<double> uy(0.0, HEIGHT);
+
+    BoidsSpatialGrid grid;
+    grid.Configure(WIDTH, HEIGHT, CELL);
+    std::vector<Point> points;
+    for (uint32_t id = 0; id < 60; ++id)
+    {
+        points.push_back({ux(rng), uy(rng), true});
+        grid.Insert(id, points[id].x, points[id].y);
+    }
+    // Solo se aceptan los ids impares
+    auto accept = [](uint32_t id) { return id % 2 == 1; };
+
+    for (const auto& [x, y] : QueryCenters(rng))
+    {
+        for (double maxRadius : {40.0, 120.0, static_cast<double>(INFINITY)})
+        {
+            uint32_t expected = BoidsSpatialGrid::INVALID;
+            double expectedD2 = maxRadius * maxRadius;
+            for (uint32_t id = 0; id < points.size(); ++id)
+            {
+                double dx = BoidsSpatialGrid::WrapDelta(points[id].x - x, WIDTH);
+                double dy = BoidsSpatialGrid::WrapDelta(points[id].y - y, HEIGHT);
+                double d2 = dx * dx + dy * dy;
+                if (accept(id) && d2 < expectedD2)
+                {
+                    expected = id;
+                    expectedD2 = d2;
+                }
+            }
+            double d2 = -1.0;
+            uint32_t found = grid.FindNearest(x, y, maxRadius, accept, &d2);
+            NS_TEST_ASSERT_MSG_EQ(found,
+                                  expected,
+                                  "más cercano a (" << x << ", " << y << ") a menos de "
+                                                    << maxRadius);
+            if (expected != BoidsSpatialGrid::INVALID)
+            {
+                NS_TEST_ASSERT_MSG_EQ(d2, expectedD2, "distancia al más cercano");
+            }
+        }
+    }
+}
+
+/**
+ * Pruebas de BoidsSpatialGrid.
+ */
+class BoidsSpatialGridTestSuite : public TestSuite
+{
+  public:
+    BoidsSpatialGridTestSuite();
+};
+
+BoidsSpatialGridTestSuite::BoidsSpatialGridTestSuite()
+    : TestSuite("boids-spatial-grid", Type::UNIT)
+{
+    AddTestCase(new BoidsSpatialGridRadiusTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new BoidsSpatialGridNearestTestCase, TestCase::Duration::QUICK);
+}
+
+static BoidsSpatialGridTestSuite g_boidsSpatialGridTestSuite;
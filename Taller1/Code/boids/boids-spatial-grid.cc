@@ -0,0 +1,150 @@
+#include "boids-spatial-grid.h"
+
+namespace ns3
+{
+
+const uint32_t BoidsSpatialGrid::INVALID;
+
+BoidsSpatialGrid::BoidsSpatialGrid()
+    : m_width(1000.0),
+      m_height(1000.0),
+      m_cellWidth(100.0),
+      m_cellHeight(100.0),
+      m_nx(0),
+      m_ny(0)
+{
+}
+
+void
+BoidsSpatialGrid::Configure(double width, double height, double cellSize)
+{
+    m_width = width;
+    m_height = height;
+    // Como mínimo una celda por eje; las celdas cubren el mundo completo
+    m_nx = std::max<uint32_t>(1, static_cast<uint32_t>(std::floor(width / cellSize)));
+    m_ny = std::max<uint32_t>(1, static_cast<uint32_t>(std::floor(height / cellSize)));
+    m_cellWidth = width / m_nx;
+    m_cellHeight = height / m_ny;
+
+    m_cells.assign(static_cast<size_t>(m_nx) * m_ny, std::vector<uint32_t>());
+
+    // Reinsertar los elementos existentes en la nueva rejilla
+    for (uint32_t id = 0; id < m_cellOf.size(); ++id)
+    {
+        if (m_cellOf[id] != INVALID)
+        {
+            uint32_t cell = CellIndex(m_x[id], m_y[id]);
+            m_cellOf[id] = cell;
+            m_slotOf[id] = m_cells[cell].size();
+            m_cells[cell].push_back(id);
+        }
+    }
+}
+
+uint32_t
+BoidsSpatialGrid::WrapCell(int64_t c, uint32_t n) const
+{
+    int64_t m = c % static_cast<int64_t>(n);
+    return static_cast<uint32_t>(m < 0 ? m + n : m);
+}
+
+uint32_t
+BoidsSpatialGrid::CellIndex(double x, double y) const
+{
+    int64_t cx = static_cast<int64_t>(std::floor(x / m_cellWidth));
+    int64_t cy = static_cast<int64_t>(std::floor(y / m_cellHeight));
+    return WrapCell(cy, m_ny) * m_nx + WrapCell(cx, m_nx);
+}
+
+void
+BoidsSpatialGrid::Insert(uint32_t id, double x, double y)
+{
+    if (m_cells.empty())
+    {
+        Configure(m_width, m_height, GetCellSize());
+    }
+    if (id >= m_cellOf.size())
+    {
+        m_cellOf.resize(id + 1, INVALID);
+        m_slotOf.resize(id + 1, 0);
+        m_x.resize(id + 1, 0.0);
+        m_y.resize(id + 1, 0.0);
+    }
+    if (m_cellOf[id] != INVALID)
+    {
+        Move(id, x, y);
+        return;
+    }
+
+    uint32_t cell = CellIndex(x, y);
+    m_x[id] = x;
+    m_y[id] = y;
+    m_cellOf[id] = cell;
+    m_slotOf[id] = m_cells[cell].size();
+    m_cells[cell].push_back(id);
+}
+
+void
+BoidsSpatialGrid::Move(uint32_t id, double x, double y)
+{
+    if (!Contains(id))
+    {
+        Insert(id, x, y);
+        return;
+    }
+
+    m_x[id] = x;
+    m_y[id] = y;
+    uint32_t cell = CellIndex(x, y);
+    if (cell == m_cellOf[id])
+    {
+        return;
+    }
+
+    Remove(id);
+    m_x[id] = x;
+    m_y[id] = y;
+    m_cellOf[id] = cell;
+    m_slotOf[id] = m_cells[cell].size();
+    m_cells[cell].push_back(id);
+}
+
+void
+BoidsSpatialGrid::Remove(uint32_t id)
+{
+    if (!Contains(id))
+    {
+        return;
+    }
+
+    // Eliminación O(1): el último de la celda ocupa el hueco
+    std::vector<uint32_t>& cell = m_cells[m_cellOf[id]];
+    uint32_t slot = m_slotOf[id];
+    uint32_t last = cell.back();
+    cell[slot] = last;
+    m_slotOf[last] = slot;
+    cell.pop_back();
+
+    m_cellOf[id] = INVALID;
+}
+
+void
+BoidsSpatialGrid::Clear()
+{
+    for (auto& cell : m_cells)
+    {
+        cell.clear();
+    }
+    m_cellOf.clear();
+    m_slotOf.clear();
+    m_x.clear();
+    m_y.clear();
+}
+
+bool
+BoidsSpatialGrid::Contains(uint32_t id) const
+{
+    return id < m_cellOf.size() && m_cellOf[id] != INVALID;
+}
+
+} // namespace ns3
@@ -0,0 +1,213 @@
+#ifndef BOIDS_SPATIAL_GRID_H
+#define BOIDS_SPATIAL_GRID_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Índice espacial de rejilla uniforme sobre un mundo toroidal.
+ *
+ * Cada elemento se identifica por un id denso (índice del boid) y se guarda en
+ * la celda que contiene su posición. Las consultas por radio recorren solo las
+ * celdas que cubren el círculo y aplican el mismo envolvimiento (wrapping) que
+ * BoidsMobilityModel::CalculateWrappedDistance, de modo que el costo por consulta
+ * depende de la densidad local y no del número total de nodos.
+ */
+class BoidsSpatialGrid
+{
+  public:
+    static const uint32_t INVALID = 0xffffffff;
+
+    BoidsSpatialGrid();
+
+    // Define el tamaño del mundo y de la celda. Reubica los elementos ya insertados.
+    void Configure(double width, double height, double cellSize);
+
+    void Insert(uint32_t id, double x, double y);
+    void Move(uint32_t id, double x, double y);
+    void Remove(uint32_t id);
+    void Clear();
+
+    bool Contains(uint32_t id) const;
+
+    double GetCellSize() const
+    {
+        return std::max(m_cellWidth, m_cellHeight);
+    }
+
+    double GetWidth() const
+    {
+        return m_width;
+    }
+
+    double GetHeight() const
+    {
+        return m_height;
+    }
+
+    // Diferencia mínima con envolvimiento (convención de imagen mínima)
+    static double WrapDelta(double d, double size)
+    {
+        if (std::abs(d) > size / 2)
+        {
+            d -= size * std::round(d / size);
+        }
+        return d;
+    }
+
+    /**
+     * Llama fn(id, dx, dy, dist2) para cada elemento a distancia < radius de (x, y).
+     * (dx, dy) es el desplazamiento envuelto desde (x, y) hasta el elemento. El propio
+     * elemento consultado (si está insertado) también se reporta con distancia 0.
+     */
+    template <typename F>
+    void ForEachInRadius(double x, double y, double radius, F&& fn) const;
+
+    /**
+     * Elemento más cercano a (x, y) a distancia < maxRadius entre los que cumplen
+     * accept(id). Recorre anillos de celdas alrededor de (x, y) y se detiene cuando
+     * ningún anillo restante puede tener un elemento más cercano.
+     *
+     * \return id encontrado o INVALID; en dist2 la distancia al cuadrado
+     */
+    template <typename F>
+    uint32_t FindNearest(double x, double y, double maxRadius, F&& accept, double* dist2 = nullptr)
+        const;
+
+    uint32_t FindNearest(double x, double y, double maxRadius = INFINITY) const
+    {
+        return FindNearest(x, y, maxRadius, [](uint32_t) { return true; });
+    }
+
+  private:
+    uint32_t CellIndex(double x, double y) const;
+    uint32_t WrapCell(int64_t c, uint32_t n) const;
+
+    double m_width;
+    double m_height;
+    double m_cellWidth; // Las celdas cubren el mundo exactamente en cada eje
+    double m_cellHeight;
+    uint32_t m_nx;
+    uint32_t m_ny;
+
+    std::vector<std::vector<uint32_t>> m_cells; // ids por celda
+    std::vector<uint32_t> m_cellOf;             // id -> celda (INVALID si no está)
+    std::vector<uint32_t> m_slotOf;             // id -> posición dentro de la celda
+    std::vector<double> m_x;                    // posición registrada por id
+    std::vector<double> m_y;
+};
+
+template <typename F>
+void
+BoidsSpatialGrid::ForEachInRadius(double x, double y, double radius, F&& fn) const
+{
+    if (m_cells.empty())
+    {
+        return;
+    }
+
+    const double r2 = radius * radius;
+    const int64_t reachX = static_cast<int64_t>(std::ceil(radius / m_cellWidth));
+    const int64_t reachY = static_cast<int64_t>(std::ceil(radius / m_cellHeight));
+    const int64_t cx = static_cast<int64_t>(std::floor(x / m_cellWidth));
+    const int64_t cy = static_cast<int64_t>(std::floor(y / m_cellHeight));
+
+    // Si el radio cubre todo el eje se recorren todas las columnas/filas una sola vez
+    const bool allX = (2 * reachX + 1) >= static_cast<int64_t>(m_nx);
+    const bool allY = (2 * reachY + 1) >= static_cast<int64_t>(m_ny);
+    const int64_t x0 = allX ? 0 : cx - reachX;
+    const int64_t x1 = allX ? static_cast<int64_t>(m_nx) - 1 : cx + reachX;
+    const int64_t y0 = allY ? 0 : cy - reachY;
+    const int64_t y1 = allY ? static_cast<int64_t>(m_ny) - 1 : cy + reachY;
+
+    for (int64_t gy = y0; gy <= y1; ++gy)
+    {
+        const uint32_t row = WrapCell(gy, m_ny) * m_nx;
+        for (int64_t gx = x0; gx <= x1; ++gx)
+        {
+            const std::vector<uint32_t>& cell = m_cells[row + WrapCell(gx, m_nx)];
+            for (uint32_t id : cell)
+            {
+                double dx = WrapDelta(m_x[id] - x, m_width);
+                double dy = WrapDelta(m_y[id] - y, m_height);
+                double d2 = dx * dx + dy * dy;
+                if (d2 < r2)
+                {
+                    fn(id, dx, dy, d2);
+                }
+            }
+        }
+    }
+}
+
+template <typename F>
+uint32_t
+BoidsSpatialGrid::FindNearest(double x, double y, double maxRadius, F&& accept, double* dist2) const
+{
+    uint32_t best = INVALID;
+    double bestD2 = maxRadius * maxRadius;
+    if (m_cells.empty())
+    {
+        return best;
+    }
+
+    const double cellMin = std::min(m_cellWidth, m_cellHeight);
+    const int64_t cx = static_cast<int64_t>(std::floor(x / m_cellWidth));
+    const int64_t cy = static_cast<int64_t>(std::floor(y / m_cellHeight));
+    // Con envolvimiento ninguna celda está a más de n/2 celdas en cada eje
+    const int64_t maxRing = std::max(m_nx, m_ny) / 2;
+
+    auto visit = [&](int64_t gx, int64_t gy) {
+        for (uint32_t id : m_cells[WrapCell(gy, m_ny) * m_nx + WrapCell(gx, m_nx)])
+        {
+            double dx = WrapDelta(m_x[id] - x, m_width);
+            double dy = WrapDelta(m_y[id] - y, m_height);
+            double d2 = dx * dx + dy * dy;
+            if (d2 < bestD2 && accept(id))
+            {
+                bestD2 = d2;
+                best = id;
+            }
+        }
+    };
+
+    for (int64_t k = 0; k <= maxRing; ++k)
+    {
+        // Todo elemento del anillo k está al menos a (k - 1) celdas de distancia
+        double ringMin = (k - 1) * cellMin;
+        if (k > 0 && ringMin * ringMin >= bestD2)
+        {
+            break;
+        }
+        if (k == 0)
+        {
+            visit(cx, cy);
+            continue;
+        }
+        for (int64_t gx = cx - k; gx <= cx + k; ++gx)
+        {
+            visit(gx, cy - k);
+            visit(gx, cy + k);
+        }
+        for (int64_t gy = cy - k + 1; gy <= cy + k - 1; ++gy)
+        {
+            visit(cx - k, gy);
+            visit(cx + k, gy);
+        }
+    }
+
+    if (dist2 && best != INVALID)
+    {
+        *dist2 = bestD2;
+    }
+    return best;
+}
+
+} // namespace ns3
+
+#endif /* BOIDS_SPATIAL_GRID_H */
@@ -0,0 +1,240 @@
+#include "boids-streaming-metrics.h"
+
+#include "boids-mobility-model.h"
+
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+NS_LOG_COMPONENT_DEFINE("BoidsStreamingMetrics");
+
+namespace ns3
+{
+
+BoidsLatencySketch::BoidsLatencySketch(double relativeError, double minValue, double maxValue)
+    : m_relativeError(relativeError),
+      m_minValue(minValue),
+      m_gamma((1.0 + relativeError) / (1.0 - relativeError)),
+      m_logGamma(std::log(m_gamma))
+{
+    const double span = std::log(maxValue / minValue) / m_logGamma;
+    m_buckets.resize(static_cast<size_t>(std::ceil(span)) + 1);
+    Clear();
+}
+
+void
+BoidsLatencySketch::Add(double value)
+{
+    size_t bucket = 0;
+    if (value > m_minValue)
+    {
+        bucket = std::min(static_cast<size_t>(std::log(value / m_minValue) / m_logGamma),
+                          m_buckets.size() - 1);
+    }
+    m_buckets[bucket]++;
+    m_count++;
+    m_sum += value;
+    m_min = std::min(m_min, value);
+    m_max = std::max(m_max, value);
+}
+
+void
+BoidsLatencySketch::Clear()
+{
+    std::fill(m_buckets.begin(), m_buckets.end(), 0);
+    m_count = 0;
+    m_sum = 0.0;
+    m_min = std::numeric_limits<double>::infinity();
+    m_max = -std::numeric_limits<double>::infinity();
+}
+
+double
+BoidsLatencySketch::GetQuantile(double q) const
+{
+    if (m_count == 0)
+    {
+        return 0.0;
+    }
+    // Rango del valor buscado entre los m_count ordenados
+    const uint64_t rank = static_cast<uint64_t>(std::clamp(q, 0.0, 1.0) * (m_count - 1));
+    uint64_t seen = 0;
+    size_t bucket = 0;
+    for (; bucket < m_buckets.size(); ++bucket)
+    {
+        seen += m_buckets[bucket];
+        if (seen > rank)
+        {
+            break;
+        }
+    }
+    // Punto de la cubeta con el mismo error relativo a ambos extremos
+    const double estimate =
+        m_minValue * std::pow(m_gamma, bucket) * 2.0 * m_gamma / (m_gamma + 1.0);
+    return std::clamp(estimate, m_min, m_max);
+}
+
+BoidsStreamingMetrics::BoidsStreamingMetrics()
+    : m_samplePeriod(Seconds(1.0)),
+      m_nextSample(Seconds(0.0)),
+      m_promotions(0),
+      m_demotions(0),
+      m_ticks(0),
+      m_leaderSeconds(0.0),
+      m_fireSeconds(0.0),
+      m_maxLeaders(0),
+      m_maxActiveFires(0),
+      m_maxClusterSize(0),
+      m_samples(0),
+      m_maxChurnPerSample(0),
+      m_samplePromotions(0),
+      m_sampleDemotions(0),
+      m_sampleExtinguished(0)
+{
+}
+
+void
+BoidsStreamingMetrics::SetSamplePeriod(Time period)
+{
+    m_samplePeriod = period;
+}
+
+bool
+BoidsStreamingMetrics::OpenSeries(const std::string& path)
+{
+    m_series.open(path);
+    if (!m_series.is_open())
+    {
+        return false;
+    }
+    m_series << "Time,ActiveFires,Leaders,Unclustered,Clusters,MeanClusterSize,MaxClusterSize,"
+                "Promotions,Demotions,Extinguished\n";
+    return true;
+}
+
+void
+BoidsStreamingMetrics::CloseSeries()
+{
+    if (m_series.is_open())
+    {
+        m_series.close();
+    }
+}
+
+void
+BoidsStreamingMetrics::LeadershipChanged(uint32_t nodeId, bool isLeader, double wcaScore)
+{
+    if (isLeader)
+    {
+        m_promotions++;
+        m_samplePromotions++;
+    }
+    else
+    {
+        m_demotions++;
+        m_sampleDemotions++;
+    }
+}
+
+void
+BoidsStreamingMetrics::FireExtinguished(uint32_t fireId,
+                                        uint32_t nodeId,
+                                        Vector position,
+                                        Time duration)
+{
+    m_latency.Add(duration.GetSeconds());
+    m_sampleExtinguished++;
+}
+
+void
+BoidsStreamingMetrics::FlockStats(const BoidsFlockStats& stats)
+{
+    if (m_ticks == 0)
+    {
+        m_firstTime = stats.time;
+    }
+    else
+    {
+        // Integrales con el valor al final de cada tick
+        const double dt = (stats.time - m_lastTime).GetSeconds();
+        m_leaderSeconds += stats.nLeaders * dt;
+        m_fireSeconds += stats.nActiveFires * dt;
+    }
+    m_ticks++;
+    m_lastTime = stats.time;
+    m_maxLeaders = std::max(m_maxLeaders, stats.nLeaders);
+    m_maxActiveFires = std::max(m_maxActiveFires, stats.nActiveFires);
+
+    if (stats.time >= m_nextSample)
+    {
+        Sample(stats);
+        while (m_nextSample <= stats.time)
+        {
+            m_nextSample += m_samplePeriod;
+        }
+    }
+}
+
+void
+BoidsStreamingMetrics::Sample(const BoidsFlockStats& stats)
+{
+    const BoidsClusterTable& table = BoidsMobilityModel::GetClusterTable();
+    uint32_t nClusters = 0;
+    uint32_t clustered = 0;
+    uint32_t maxSize = 0;
+    for (uint32_t c = 0; c < table.GetNClusters(); ++c)
+    {
+        const uint32_t size = table.GetClusterSize(c);
+        if (size > 0)
+        {
+            nClusters++;
+            clustered += size;
+            maxSize = std::max(maxSize, size);
+        }
+    }
+    m_maxClusterSize = std::max(m_maxClusterSize, maxSize);
+    m_maxChurnPerSample = std::max(m_maxChurnPerSample, m_samplePromotions + m_sampleDemotions);
+    m_samples++;
+
+    if (m_series.is_open())
+    {
+        m_series << stats.time.GetSeconds() << "," << stats.nActiveFires << "," << stats.nLeaders
+                 << "," << stats.nUnclustered << "," << nClusters << ","
+                 << (nClusters > 0 ? static_cast<double>(clustered) / nClusters : 0.0) << ","
+                 << maxSize << "," << m_samplePromotions << "," << m_sampleDemotions << ","
+                 << m_sampleExtinguished << "\n";
+    }
+    m_samplePromotions = 0;
+    m_sampleDemotions = 0;
+    m_sampleExtinguished = 0;
+}
+
+bool
+BoidsStreamingMetrics::WriteSummary(const std::string& path) const
+{
+    std::ofstream out(path);
+    if (!out.is_open())
+    {
+        NS_LOG_WARN("No se pudo abrir " << path);
+        return false;
+    }
+    const double elapsed = (m_lastTime - m_firstTime).GetSeconds();
+    const uint64_t churn = m_promotions + m_demotions;
+    out << "Extinguished,LatencyMean,LatencyP50,LatencyP95,LatencyP99,LatencyMax,"
+           "MeanActiveFires,MaxActiveFires,MeanLeaders,MaxLeaders,MaxClusterSize,"
+           "PromotionsPerSecond,DemotionsPerSecond,ChurnPerLeaderSecond,MaxChurnPerSample,"
+           "Samples\n";
+    out << m_latency.GetCount() << "," << m_latency.GetMean() << ","
+        << m_latency.GetQuantile(0.50) << "," << m_latency.GetQuantile(0.95) << ","
+        << m_latency.GetQuantile(0.99) << "," << m_latency.GetMax() << ","
+        << (elapsed > 0 ? m_fireSeconds / elapsed : 0.0) << "," << m_maxActiveFires << ","
+        << (elapsed > 0 ? m_leaderSeconds / elapsed : 0.0) << "," << m_maxLeaders << ","
+        << m_maxClusterSize << "," << (elapsed > 0 ? m_promotions / elapsed : 0.0) << ","
+        << (elapsed > 0 ? m_demotions / elapsed : 0.0) << ","
+        << (m_leaderSeconds > 0 ? churn / m_leaderSeconds : 0.0) << "," << m_maxChurnPerSample
+        << "," << m_samples << "\n";
+    return out.good();
+}
+
+} // namespace ns3
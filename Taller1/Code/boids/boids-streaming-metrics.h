@@ -0,0 +1,141 @@
+#ifndef BOIDS_STREAMING_METRICS_H
+#define BOIDS_STREAMING_METRICS_H
+
+#include "boids-flock-controller.h"
+
+#include "ns3/nstime.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/vector.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Histograma de cubetas logarítmicas para cuantiles con error relativo acotado.
+ *
+ * La cubeta i cubre [minValue * gamma^i, minValue * gamma^(i+1)) con
+ * gamma = (1 + e) / (1 - e), así que cualquier cuantil se estima con un error
+ * relativo de a lo sumo e. El número de cubetas depende solo del rango y del
+ * error, no de cuántos valores se añadan: con los valores por omisión (1 % entre
+ * 1 ms y 10^6 s) son unas mil cubetas, 8 KB.
+ */
+class BoidsLatencySketch
+{
+  public:
+    BoidsLatencySketch(double relativeError = 0.01, double minValue = 1e-3, double maxValue = 1e6);
+
+    // Los valores fuera de [minValue, maxValue] van a la primera o a la última cubeta
+    void Add(double value);
+    void Clear();
+
+    // Cuantil q en [0, 1]; 0 si no hay valores
+    double GetQuantile(double q) const;
+
+    uint64_t GetCount() const
+    {
+        return m_count;
+    }
+
+    double GetMean() const
+    {
+        return m_count > 0 ? m_sum / m_count : 0.0;
+    }
+
+    double GetMin() const
+    {
+        return m_count > 0 ? m_min : 0.0;
+    }
+
+    double GetMax() const
+    {
+        return m_count > 0 ? m_max : 0.0;
+    }
+
+    double GetRelativeError() const
+    {
+        return m_relativeError;
+    }
+
+  private:
+    double m_relativeError;
+    double m_minValue;
+    double m_gamma;
+    double m_logGamma;
+    std::vector<uint64_t> m_buckets;
+    uint64_t m_count;
+    double m_sum;
+    double m_min;
+    double m_max;
+};
+
+/**
+ * Métricas de la respuesta a fuegos calculadas durante la simulación, con memoria
+ * que no crece con la duración ni guarda trayectorias.
+ *
+ * Se alimenta de las fuentes de traza LeadershipChanged y FireExtinguished de los
+ * boids y FlockStats del controlador (ver BoidsHelper::EnableMetrics):
+ *   - latencia de extinción en un BoidsLatencySketch (p50, p95, p99),
+ *   - una muestra cada SamplePeriod de fuegos activos, líderes y tamaño de los
+ *     clusters, escrita en el momento en la serie (OpenSeries) sin guardarla,
+ *   - promociones y renuncias por segundo y por segundo-líder.
+ * WriteSummary escribe una fila con los agregados de toda la ejecución.
+ */
+class BoidsStreamingMetrics : public SimpleRefCount<BoidsStreamingMetrics>
+{
+  public:
+    BoidsStreamingMetrics();
+
+    void SetSamplePeriod(Time period);
+
+    // Serie temporal CSV, una fila por muestra; false si no se pudo abrir
+    bool OpenSeries(const std::string& path);
+    void CloseSeries();
+
+    // Resumen CSV de una fila; false si no se pudo escribir
+    bool WriteSummary(const std::string& path) const;
+
+    const BoidsLatencySketch& GetLatency() const
+    {
+        return m_latency;
+    }
+
+    void LeadershipChanged(uint32_t nodeId, bool isLeader, double wcaScore);
+    void FireExtinguished(uint32_t fireId, uint32_t nodeId, Vector position, Time duration);
+    void FlockStats(const BoidsFlockStats& stats);
+
+  private:
+    void Sample(const BoidsFlockStats& stats);
+
+    BoidsLatencySketch m_latency;
+    Time m_samplePeriod;
+    Time m_nextSample;
+    std::ofstream m_series;
+
+    // Totales de la ejecución
+    uint64_t m_promotions;
+    uint64_t m_demotions;
+    uint64_t m_ticks;
+    Time m_firstTime;
+    Time m_lastTime;
+    double m_leaderSeconds; // Integral del número de líderes en el tiempo
+    double m_fireSeconds;   // Integral del número de fuegos activos en el tiempo
+    uint32_t m_maxLeaders;
+    uint32_t m_maxActiveFires;
+    uint32_t m_maxClusterSize;
+    uint64_t m_samples;
+    uint64_t m_maxChurnPerSample; // Mayor número de cambios de liderazgo entre dos muestras
+
+    // Eventos desde la muestra anterior
+    uint64_t m_samplePromotions;
+    uint64_t m_sampleDemotions;
+    uint64_t m_sampleExtinguished;
+};
+
+} // namespace ns3
+
+#endif /* BOIDS_STREAMING_METRICS_H */
@@ -0,0 +1,80 @@
+#ifndef BOIDS_TELEMETRY_FORMAT_H
+#define BOIDS_TELEMETRY_FORMAT_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace ns3
+{
+
+/**
+ * Anillo de telemetría en memoria compartida POSIX (little-endian).
+ *
+ *   cabecera | ranura 0 | ranura 1 | ... | ranura nSlots - 1
+ *
+ * Cada ranura es una trama: su cabecera, maxBoids registros de boid y maxFires
+ * registros de fuego (solo son válidos los nBoids y nFires primeros). La trama k
+ * va en la ranura k % nSlots. Hay un único escritor, que nunca espera:
+ *   1. sequence = 2k + 1 (la ranura se está escribiendo),
+ *   2. copia de la trama,
+ *   3. sequence = 2k + 2 (con orden release) y published = k + 1.
+ * Un lector lee published, copia la ranura de la trama que quiera y la acepta
+ * solo si sequence valía 2k + 2 antes y después de copiarla; si no, el escritor
+ * la ha sobrescrito (el lector va retrasado) y la trama se pierde.
+ */
+static const char BOIDS_TELEMETRY_MAGIC[8] = {'B', 'O', 'I', 'D', 'S', 'T', 'M', '1'};
+static const uint32_t BOIDS_TELEMETRY_VERSION = 1;
+
+struct BoidsTelemetryHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t nSlots;
+    uint64_t slotSize; // Bytes por ranura, cabecera incluida
+    uint32_t maxBoids;
+    uint32_t maxFires;
+    std::atomic<uint64_t> published; // Tramas publicadas; la última es published - 1
+    std::atomic<uint64_t> closed;    // 1 cuando la simulación ha terminado
+    uint64_t reserved[2];
+};
+
+struct BoidsTelemetrySlotHeader
+{
+    std::atomic<uint64_t> sequence;
+    uint64_t tick;
+    int64_t timeNs;
+    uint32_t nBoids;
+    uint32_t nFires;
+    uint32_t nLeaders;
+    uint32_t truncated; // Boids y fuegos que no cupieron en la ranura
+    uint64_t reserved;
+};
+
+// Posición en float: basta para mirar la simulación y la trama ocupa la mitad
+struct BoidsTelemetryBoid
+{
+    uint32_t boidId;
+    uint8_t isLeader;
+    uint8_t reserved[3];
+    float x;
+    float y;
+};
+
+struct BoidsTelemetryFire
+{
+    uint32_t fireId;
+    uint32_t reserved;
+    float x;
+    float y;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "atómicos de 64 bits sin cerrojo");
+static_assert(sizeof(std::atomic<uint64_t>) == 8, "atómico del tamaño de un uint64_t");
+static_assert(sizeof(BoidsTelemetryHeader) == 64, "cabecera de 64 bytes");
+static_assert(sizeof(BoidsTelemetrySlotHeader) == 48, "cabecera de ranura de 48 bytes");
+static_assert(sizeof(BoidsTelemetryBoid) == 16, "registro de boid de 16 bytes");
+static_assert(sizeof(BoidsTelemetryFire) == 16, "registro de fuego de 16 bytes");
+
+} // namespace ns3
+
+#endif /* BOIDS_TELEMETRY_FORMAT_H */
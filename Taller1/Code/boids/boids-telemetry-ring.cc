@@ -0,0 +1,194 @@
+#include "boids-telemetry-ring.h"
+
+#include "boids-mobility-model.h"
+
+#include "ns3/callback.h"
+#include "ns3/log.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+NS_LOG_COMPONENT_DEFINE("BoidsTelemetryRing");
+
+namespace ns3
+{
+
+namespace
+{
+
+size_t
+SlotSize(uint32_t maxBoids, uint32_t maxFires)
+{
+    size_t size = sizeof(BoidsTelemetrySlotHeader) + sizeof(BoidsTelemetryBoid) * maxBoids +
+                  sizeof(BoidsTelemetryFire) * maxFires;
+    // Ranuras alineadas a línea de caché: el escritor no comparte línea con la
+    // secuencia de la ranura siguiente
+    return (size + 63) / 64 * 64;
+}
+
+} // namespace
+
+BoidsTelemetryRing::BoidsTelemetryRing()
+    : m_header(nullptr),
+      m_size(0),
+      m_interval(1),
+      m_published(0)
+{
+}
+
+BoidsTelemetryRing::~BoidsTelemetryRing()
+{
+    Close();
+}
+
+bool
+BoidsTelemetryRing::Open(const std::string& name,
+                         uint32_t maxBoids,
+                         uint32_t maxFires,
+                         uint32_t nSlots,
+                         uint32_t interval)
+{
+    Close();
+    m_name = name.empty() || name[0] != '/' ? "/" + name : name;
+    nSlots = std::max<uint32_t>(1, nSlots);
+    const size_t slotSize = SlotSize(maxBoids, maxFires);
+    m_size = sizeof(BoidsTelemetryHeader) + slotSize * nSlots;
+
+    // Un segmento nuevo en lugar de redimensionar el de una ejecución anterior: los
+    // lectores que aún lo tengan mapeado recibirían SIGBUS al encogerlo
+    shm_unlink(m_name.c_str());
+    int fd = shm_open(m_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0)
+    {
+        NS_LOG_WARN("No se pudo crear el segmento " << m_name << ": " << std::strerror(errno));
+        return false;
+    }
+    void* data = MAP_FAILED;
+    if (ftruncate(fd, m_size) == 0)
+    {
+        data = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        NS_LOG_WARN("No se pudo mapear el segmento " << m_name << ": " << std::strerror(errno));
+        shm_unlink(m_name.c_str());
+        return false;
+    }
+
+    // El segmento nuevo está a cero; la firma se escribe la última para que un
+    // lector no acepte una cabecera a medias
+    m_header = new (data) BoidsTelemetryHeader();
+    m_header->version = BOIDS_TELEMETRY_VERSION;
+    m_header->nSlots = nSlots;
+    m_header->slotSize = slotSize;
+    m_header->maxBoids = maxBoids;
+    m_header->maxFires = maxFires;
+    m_header->published.store(0, std::memory_order_relaxed);
+    m_header->closed.store(0, std::memory_order_relaxed);
+    for (uint32_t s = 0; s < nSlots; ++s)
+    {
+        new (GetSlot(s)) BoidsTelemetrySlotHeader();
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(m_header->magic, BOIDS_TELEMETRY_MAGIC, sizeof(m_header->magic));
+
+    m_interval = std::max<uint32_t>(1, interval);
+    m_published = 0;
+    m_controller = BoidsFlockController::Get();
+    m_controller->TraceConnectWithoutContext("FlockStats",
+                                             MakeCallback(&BoidsTelemetryRing::FlockStats, this));
+    return true;
+}
+
+void
+BoidsTelemetryRing::Close()
+{
+    if (!m_header)
+    {
+        return;
+    }
+    m_controller->TraceDisconnectWithoutContext(
+        "FlockStats",
+        MakeCallback(&BoidsTelemetryRing::FlockStats, this));
+    m_controller = nullptr;
+    m_header->closed.store(1, std::memory_order_release);
+    munmap(m_header, m_size);
+    shm_unlink(m_name.c_str());
+    m_header = nullptr;
+}
+
+BoidsTelemetrySlotHeader*
+BoidsTelemetryRing::GetSlot(uint64_t frame) const
+{
+    char* base = reinterpret_cast<char*>(m_header) + sizeof(BoidsTelemetryHeader);
+    return reinterpret_cast<BoidsTelemetrySlotHeader*>(base + (frame % m_header->nSlots) *
+                                                                  m_header->slotSize);
+}
+
+void
+BoidsTelemetryRing::FlockStats(const BoidsFlockStats& stats)
+{
+    if (stats.tick % m_interval == 0)
+    {
+        Publish(stats);
+    }
+}
+
+void
+BoidsTelemetryRing::Publish(const BoidsFlockStats& stats)
+{
+    const uint64_t frame = m_published;
+    BoidsTelemetrySlotHeader* slot = GetSlot(frame);
+    slot->sequence.store(2 * frame + 1, std::memory_order_relaxed);
+    // La marca de escritura es visible antes que cualquier dato de la trama nueva
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const Ptr<BoidsFlockController> flock = m_controller;
+    const BoidsFlockState& state = flock->GetState();
+    const uint32_t nBoids = std::min(state.GetN(), m_header->maxBoids);
+    BoidsTelemetryBoid* boids = reinterpret_cast<BoidsTelemetryBoid*>(slot + 1);
+    for (uint32_t i = 0; i < nBoids; ++i)
+    {
+        BoidsTelemetryBoid& r = boids[i];
+        r.boidId = flock->GetBoid(i)->GetBoidId();
+        r.isLeader = state.leader[i];
+        r.x = static_cast<float>(state.x[i]);
+        r.y = static_cast<float>(state.y[i]);
+    }
+
+    const BoidsFireRegistry& registry = BoidsMobilityModel::GetFireRegistry();
+    BoidsTelemetryFire* fires =
+        reinterpret_cast<BoidsTelemetryFire*>(boids + m_header->maxBoids);
+    uint32_t nFires = 0;
+    for (const BoidsFire& fire : registry)
+    {
+        if (nFires == m_header->maxFires)
+        {
+            break;
+        }
+        BoidsTelemetryFire& r = fires[nFires++];
+        r.fireId = fire.id;
+        r.x = static_cast<float>(fire.position.x);
+        r.y = static_cast<float>(fire.position.y);
+    }
+
+    slot->tick = stats.tick;
+    slot->timeNs = stats.time.GetNanoSeconds();
+    slot->nBoids = nBoids;
+    slot->nFires = nFires;
+    slot->nLeaders = stats.nLeaders;
+    slot->truncated = (state.GetN() - nBoids) + (registry.GetN() - nFires);
+    slot->sequence.store(2 * frame + 2, std::memory_order_release);
+    m_published = frame + 1;
+    m_header->published.store(m_published, std::memory_order_release);
+}
+
+} // namespace ns3
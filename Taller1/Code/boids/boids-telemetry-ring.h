@@ -0,0 +1,79 @@
+#ifndef BOIDS_TELEMETRY_RING_H
+#define BOIDS_TELEMETRY_RING_H
+
+#include "boids-flock-controller.h"
+#include "boids-telemetry-format.h"
+
+#include "ns3/ptr.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * Publica el estado de la bandada en un anillo de memoria compartida POSIX para
+ * seguir una simulación mientras se ejecuta (ver boids-telemetry-format.h y
+ * simulate/boids_telemetry.py).
+ *
+ * Se conecta a la fuente de traza FlockStats del controlador: cada Interval
+ * ticks copia posición, liderazgo e id de todos los boids y los fuegos activos a
+ * la siguiente ranura. El simulador nunca espera a los lectores, que pueden
+ * conectarse y desconectarse en cualquier momento; si un lector va más lento que
+ * la simulación pierde tramas, no la frena.
+ */
+class BoidsTelemetryRing
+{
+  public:
+    BoidsTelemetryRing();
+    ~BoidsTelemetryRing();
+
+    /**
+     * Crea (o reemplaza) el segmento de memoria compartida y se conecta a
+     * FlockStats.
+     *
+     * \param name nombre del segmento (p. ej. "/boids"; en Linux, /dev/shm/boids)
+     * \param maxBoids boids por trama; los que no quepan se cuentan en truncated
+     * \param maxFires fuegos por trama
+     * \param nSlots tramas que guarda el anillo
+     * \param interval ticks entre tramas
+     * \return false si no se pudo crear el segmento
+     */
+    bool Open(const std::string& name,
+              uint32_t maxBoids,
+              uint32_t maxFires = 1024,
+              uint32_t nSlots = 64,
+              uint32_t interval = 1);
+
+    bool IsOpen() const
+    {
+        return m_header != nullptr;
+    }
+
+    // Marca el anillo como cerrado, lo desconecta y borra el nombre del segmento
+    // (los lectores conectados conservan su copia mapeada)
+    void Close();
+
+    uint64_t GetFramesPublished() const
+    {
+        return m_published;
+    }
+
+  private:
+    void FlockStats(const BoidsFlockStats& stats);
+    void Publish(const BoidsFlockStats& stats);
+    BoidsTelemetrySlotHeader* GetSlot(uint64_t frame) const;
+
+    std::string m_name;
+    BoidsTelemetryHeader* m_header; // Inicio del segmento mapeado
+    size_t m_size;
+    uint32_t m_interval;
+    uint64_t m_published;
+    Ptr<BoidsFlockController> m_controller; // Al que se conectó Open
+};
+
+} // namespace ns3
+
+#endif /* BOIDS_TELEMETRY_RING_H */
@@ -0,0 +1,110 @@
+#include "boids-thread-pool.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+BoidsThreadPool::BoidsThreadPool(uint32_t nThreads)
+    : m_job(nullptr),
+      m_n(0),
+      m_chunkSize(1),
+      m_nextChunk(0),
+      m_generation(0),
+      m_running(0),
+      m_stop(false)
+{
+    // El hilo que llama a ParallelFor es el hilo 0
+    for (uint32_t i = 1; i < std::max<uint32_t>(1, nThreads); ++i)
+    {
+        m_threads.emplace_back(&BoidsThreadPool::WorkerLoop, this, i);
+    }
+}
+
+BoidsThreadPool::~BoidsThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_startCv.notify_all();
+    for (auto& t : m_threads)
+    {
+        t.join();
+    }
+}
+
+void
+BoidsThreadPool::RunChunks(uint32_t worker)
+{
+    while (true)
+    {
+        uint32_t begin = m_nextChunk.fetch_add(m_chunkSize, std::memory_order_relaxed);
+        if (begin >= m_n)
+        {
+            break;
+        }
+        (*m_job)(begin, std::min(m_n, begin + m_chunkSize), worker);
+    }
+}
+
+void
+BoidsThreadPool::WorkerLoop(uint32_t worker)
+{
+    uint64_t seen = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_startCv.wait(lock, [&] { return m_stop || m_generation != seen; });
+            if (m_stop)
+            {
+                return;
+            }
+            seen = m_generation;
+        }
+
+        RunChunks(worker);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_running == 0)
+            {
+                m_doneCv.notify_one();
+            }
+        }
+    }
+}
+
+void
+BoidsThreadPool::ParallelFor(uint32_t n, const RangeFunction& fn)
+{
+    if (m_threads.empty() || n < 2)
+    {
+        if (n > 0)
+        {
+            fn(0, n, 0);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job = &fn;
+        m_n = n;
+        // Bloques pequeños para repartir carga desigual (zonas densas vs. vacías)
+        m_chunkSize = std::max<uint32_t>(16, n / (GetNThreads() * 8));
+        m_nextChunk.store(0, std::memory_order_relaxed);
+        m_running = m_threads.size();
+        m_generation++;
+    }
+    m_startCv.notify_all();
+
+    RunChunks(0);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCv.wait(lock, [&] { return m_running == 0; });
+    m_job = nullptr;
+}
+
+} // namespace ns3
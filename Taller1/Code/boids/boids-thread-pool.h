@@ -0,0 +1,60 @@
+#ifndef BOIDS_THREAD_POOL_H
+#define BOIDS_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Grupo fijo de hilos para el paso paralelo de la bandada.
+ *
+ * ParallelFor reparte [0, n) en bloques que los hilos toman de un contador atómico;
+ * el hilo que llama también trabaja como hilo 0. Cada índice se procesa exactamente
+ * una vez, así que si la función solo escribe en la posición de su índice el
+ * resultado no depende del número de hilos ni del reparto.
+ */
+class BoidsThreadPool
+{
+  public:
+    // fn(inicio, fin, hilo) procesa el bloque [inicio, fin) con el hilo indicado
+    typedef std::function<void(uint32_t, uint32_t, uint32_t)> RangeFunction;
+
+    explicit BoidsThreadPool(uint32_t nThreads);
+    ~BoidsThreadPool();
+
+    uint32_t GetNThreads() const
+    {
+        return m_threads.size() + 1;
+    }
+
+    // Bloquea hasta que todos los bloques han terminado
+    void ParallelFor(uint32_t n, const RangeFunction& fn);
+
+  private:
+    void WorkerLoop(uint32_t worker);
+    void RunChunks(uint32_t worker);
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_startCv;
+    std::condition_variable m_doneCv;
+
+    const RangeFunction* m_job;
+    uint32_t m_n;
+    uint32_t m_chunkSize;
+    std::atomic<uint32_t> m_nextChunk;
+    uint64_t m_generation;
+    uint32_t m_running;
+    bool m_stop;
+};
+
+} // namespace ns3
+
+#endif /* BOIDS_THREAD_POOL_H */
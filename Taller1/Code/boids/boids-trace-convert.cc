@@ -0,0 +1,123 @@
+#include "ns3/boids-trace-reader.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/*------------------------------------------------
+    Convierte la traza binaria de boids.cc (--traceFormat=binary) a CSV
+    (mismas columnas que boids_positions.csv) o a formato de movilidad ns-2.
+
+    ./ns3 run "boids-trace-convert <traza.bin> <salida> [csv|ns2]"
+------------------------------------------------*/
+
+static const double WORLD_SIZE = 1000.0; // Mundo toroidal de boids.cc
+
+void
+WriteCsv(BoidsTraceReader& reader, std::ofstream& out)
+{
+    std::vector<BoidsTraceFileRecord> records;
+    out << "Time,NodeId,X,Y,IsLeader,IsFire,FireId\n";
+    for (uint64_t f = 0; f < reader.GetNFrames(); ++f)
+    {
+        reader.ReadFrame(f, records);
+        double time = reader.GetFrameTime(f);
+        for (const BoidsTraceFileRecord& r : records)
+        {
+            // En los eventos de fuego nodeId guarda el id del fuego
+            int32_t nodeId = r.isFire ? -1 : r.nodeId;
+            int32_t fireId = r.isFire ? r.nodeId : -1;
+            out << time << "," << nodeId << "," << r.x << "," << r.y << ","
+                << static_cast<int>(r.isLeader) << "," << static_cast<int>(r.isFire) << ","
+                << fireId << "\n";
+        }
+    }
+}
+
+void
+WriteNs2(BoidsTraceReader& reader, std::ofstream& out)
+{
+    // Cada tick se convierte en un setdest hacia la posición del tick siguiente.
+    // Al cruzar un borde del mundo toroidal el nodo se recoloca directamente.
+    std::vector<BoidsTraceFileRecord> records;
+    std::map<int32_t, BoidsTraceFileRecord> last;
+    double lastTime = 0.0;
+    for (uint64_t f = 0; f < reader.GetNFrames(); ++f)
+    {
+        reader.ReadFrame(f, records);
+        double time = reader.GetFrameTime(f);
+        for (const BoidsTraceFileRecord& r : records)
+        {
+            if (r.isFire)
+            {
+                continue;
+            }
+            auto it = last.find(r.nodeId);
+            if (it == last.end())
+            {
+                out << "$node_(" << r.nodeId << ") set X_ " << r.x << "\n";
+                out << "$node_(" << r.nodeId << ") set Y_ " << r.y << "\n";
+                out << "$node_(" << r.nodeId << ") set Z_ 0\n";
+                last[r.nodeId] = r;
+                continue;
+            }
+            double dx = r.x - it->second.x;
+            double dy = r.y - it->second.y;
+            if (std::abs(dx) > WORLD_SIZE / 2 || std::abs(dy) > WORLD_SIZE / 2)
+            {
+                out << "$ns_ at " << time << " \"$node_(" << r.nodeId << ") set X_ " << r.x
+                    << "\"\n";
+                out << "$ns_ at " << time << " \"$node_(" << r.nodeId << ") set Y_ " << r.y
+                    << "\"\n";
+            }
+            else if (time > lastTime)
+            {
+                double speed = std::sqrt(dx * dx + dy * dy) / (time - lastTime);
+                out << "$ns_ at " << lastTime << " \"$node_(" << r.nodeId << ") setdest " << r.x
+                    << " " << r.y << " " << speed << "\"\n";
+            }
+            it->second = r;
+        }
+        lastTime = time;
+    }
+}
+
+int
+main(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        std::cerr << "Uso: " << argv[0] << " <traza.bin> <salida> [csv|ns2]\n";
+        return 1;
+    }
+    std::string format = argc > 3 ? argv[3] : "csv";
+
+    BoidsTraceReader reader;
+    if (!reader.Open(argv[1]))
+    {
+        std::cerr << "No se pudo leer la traza " << argv[1] << "\n";
+        return 1;
+    }
+    std::ofstream out(argv[2]);
+    if (!out.is_open())
+    {
+        std::cerr << "No se pudo abrir " << argv[2] << "\n";
+        return 1;
+    }
+
+    if (format == "ns2")
+    {
+        WriteNs2(reader, out);
+    }
+    else
+    {
+        WriteCsv(reader, out);
+    }
+    return 0;
+}
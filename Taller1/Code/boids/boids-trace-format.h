@@ -0,0 +1,67 @@
+#ifndef BOIDS_TRACE_FORMAT_H
+#define BOIDS_TRACE_FORMAT_H
+
+#include <cstdint>
+
+namespace ns3
+{
+
+/**
+ * Formato binario de la traza de posiciones (little-endian).
+ *
+ *   cabecera | bloque tick 0 | bloque tick 1 | ... | índice | cola
+ *
+ * Cada bloque son registros de ancho fijo con el mismo instante. El índice tiene
+ * una entrada por bloque con el instante, el desplazamiento en bytes y el número
+ * de registros, y la cola al final del archivo dice dónde empieza el índice. Así
+ * leer un instante solo requiere leer su bloque.
+ */
+static const char BOIDS_TRACE_MAGIC[8] = {'B', 'O', 'I', 'D', 'S', 'T', 'R', '1'};
+static const char BOIDS_TRACE_INDEX_MAGIC[8] = {'B', 'O', 'I', 'D', 'S', 'I', 'D', 'X'};
+static const uint32_t BOIDS_TRACE_VERSION = 2;
+
+// Valor de isFire: los fuegos se registran como eventos, no en cada tick
+static const uint8_t BOIDS_TRACE_FIRE_CREATED = 1;
+static const uint8_t BOIDS_TRACE_FIRE_EXTINGUISHED = 2;
+
+struct BoidsTraceFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t reserved[2];
+};
+
+// Posición de un boid (isFire = 0) o evento de fuego (isFire = 1 o 2)
+struct BoidsTraceFileRecord
+{
+    int32_t nodeId; // Id del fuego si isFire != 0
+    uint8_t isLeader;
+    uint8_t isFire;
+    uint16_t reserved;
+    double x;
+    double y;
+};
+
+struct BoidsTraceIndexEntry
+{
+    double time;
+    uint64_t offset; // Byte del primer registro del bloque
+    uint64_t count;  // Registros del bloque
+};
+
+struct BoidsTraceFileTrailer
+{
+    uint64_t indexOffset;
+    uint64_t nFrames;
+    char magic[8];
+};
+
+static_assert(sizeof(BoidsTraceFileHeader) == 32, "cabecera de 32 bytes");
+static_assert(sizeof(BoidsTraceFileRecord) == 24, "registro de 24 bytes");
+static_assert(sizeof(BoidsTraceIndexEntry) == 24, "entrada de índice de 24 bytes");
+static_assert(sizeof(BoidsTraceFileTrailer) == 24, "cola de 24 bytes");
+
+} // namespace ns3
+
+#endif /* BOIDS_TRACE_FORMAT_H */
@@ -0,0 +1,74 @@
+#include "boids-trace-reader.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ns3
+{
+
+bool
+BoidsTraceReader::Open(const std::string& path)
+{
+    m_index.clear();
+    m_file.close();
+    m_file.open(path, std::ios::in | std::ios::binary);
+    if (!m_file.is_open())
+    {
+        return false;
+    }
+
+    BoidsTraceFileHeader header;
+    if (!m_file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, BOIDS_TRACE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != BOIDS_TRACE_VERSION ||
+        header.recordSize != sizeof(BoidsTraceFileRecord))
+    {
+        return false;
+    }
+
+    // La cola está al final; sin ella la traza no se cerró correctamente
+    BoidsTraceFileTrailer trailer;
+    m_file.seekg(-static_cast<std::streamoff>(sizeof(trailer)), std::ios::end);
+    if (!m_file.read(reinterpret_cast<char*>(&trailer), sizeof(trailer)) ||
+        std::memcmp(trailer.magic, BOIDS_TRACE_INDEX_MAGIC, sizeof(trailer.magic)) != 0)
+    {
+        return false;
+    }
+
+    m_index.resize(trailer.nFrames);
+    m_file.seekg(trailer.indexOffset);
+    if (!m_file.read(reinterpret_cast<char*>(m_index.data()),
+                     m_index.size() * sizeof(BoidsTraceIndexEntry)))
+    {
+        m_index.clear();
+        return false;
+    }
+    return true;
+}
+
+uint64_t
+BoidsTraceReader::FindFrame(double time) const
+{
+    auto it = std::lower_bound(m_index.begin(),
+                               m_index.end(),
+                               time,
+                               [](const BoidsTraceIndexEntry& e, double t) { return e.time < t; });
+    return it - m_index.begin();
+}
+
+bool
+BoidsTraceReader::ReadFrame(uint64_t frame, std::vector<BoidsTraceFileRecord>& records)
+{
+    if (frame >= m_index.size())
+    {
+        return false;
+    }
+    const BoidsTraceIndexEntry& entry = m_index[frame];
+    records.resize(entry.count);
+    m_file.clear();
+    m_file.seekg(entry.offset);
+    return static_cast<bool>(m_file.read(reinterpret_cast<char*>(records.data()),
+                                         entry.count * sizeof(BoidsTraceFileRecord)));
+}
+
+} // namespace ns3
@@ -0,0 +1,46 @@
+#ifndef BOIDS_TRACE_READER_H
+#define BOIDS_TRACE_READER_H
+
+#include "boids-trace-format.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Lector de la traza binaria de posiciones (ver boids-trace-format.h).
+ *
+ * Open solo lee la cabecera y el índice; ReadFrame lee el bloque de un instante
+ * sin recorrer el resto del archivo.
+ */
+class BoidsTraceReader
+{
+  public:
+    bool Open(const std::string& path);
+
+    uint64_t GetNFrames() const
+    {
+        return m_index.size();
+    }
+
+    double GetFrameTime(uint64_t frame) const
+    {
+        return m_index[frame].time;
+    }
+
+    // Primer bloque con instante >= time (GetNFrames() si no hay ninguno)
+    uint64_t FindFrame(double time) const;
+
+    bool ReadFrame(uint64_t frame, std::vector<BoidsTraceFileRecord>& records);
+
+  private:
+    std::ifstream m_file;
+    std::vector<BoidsTraceIndexEntry> m_index;
+};
+
+} // namespace ns3
+
+#endif /* BOIDS_TRACE_READER_H */
@@ -0,0 +1,240 @@
+#include "ns3/boids-trace-reader.h"
+#include "ns3/boids-trace-writer.h"
+#include "ns3/test.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+namespace
+{
+
+const uint32_t N_FRAMES = 9;
+const uint32_t N_BOIDS = 5;
+// Menor que un instante: los bloques quedan repartidos entre buffers
+const uint32_t RECORDS_PER_BUFFER = 7;
+
+// Ticks de boids más eventos de fuego en algunos instantes. Los valores se escriben
+// exactos en CSV con la precisión por defecto del stream.
+std::vector<BoidsTraceRecord>
+MakeRecords()
+{
+    std::vector<BoidsTraceRecord> records;
+    for (uint32_t f = 0; f < N_FRAMES; ++f)
+    {
+        double time = 0.25 * f;
+        for (uint32_t i = 0; i < N_BOIDS; ++i)
+        {
+            uint8_t isLeader = (i == 0);
+            records.push_back(
+                {time, static_cast<int32_t>(i), 100.5 * i + f, 20.25 * f, isLeader, 0, -1});
+        }
+        if (f % 3 == 1)
+        {
+            int32_t fireId = 10 + 2 * f;
+            records.push_back({time, -1, 400.0 + f, 300.0, 0, BOIDS_TRACE_FIRE_CREATED, fireId});
+        }
+        if (f % 4 == 3)
+        {
+            records.push_back({time, -1, 50.0, 60.0 + f, 0, BOIDS_TRACE_FIRE_EXTINGUISHED, 3});
+        }
+    }
+    return records;
+}
+
+// Registros del instante time en el orden en que se escribieron
+std::vector<BoidsTraceRecord>
+FrameRecords(const std::vector<BoidsTraceRecord>& records, double time)
+{
+    std::vector<BoidsTraceRecord> frame;
+    for (const BoidsTraceRecord& r : records)
+    {
+        if (r.time == time)
+        {
+            frame.push_back(r);
+        }
+    }
+    return frame;
+}
+
+bool
+WriteTrace(const std::string& path,
+           BoidsTraceWriter::Format format,
+           const std::vector<BoidsTraceRecord>& records)
+{
+    BoidsTraceWriter writer;
+    if (!writer.Open(path, format, RECORDS_PER_BUFFER, 1))
+    {
+        return false;
+    }
+    for (const BoidsTraceRecord& r : records)
+    {
+        writer.Write(r);
+    }
+    writer.Close();
+    return writer.GetRecordsWritten() == records.size();
+}
+
+} // namespace
+
+/**
+ * Lo escrito en CSV se vuelve a leer fila por fila: misma cabecera de columnas
+ * y los mismos valores, con el id del nodo o del fuego en su columna.
+ */
+class BoidsTraceCsvTestCase : public TestCase
+{
+  public:
+    BoidsTraceCsvTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+BoidsTraceCsvTestCase::BoidsTraceCsvTestCase()
+    : TestCase("Traza CSV escrita y leída de vuelta")
+{
+}
+
+void
+BoidsTraceCsvTestCase::DoRun()
+{
+    std::string path = CreateTempDirFilename("boids-trace.csv");
+    std::vector<BoidsTraceRecord> records = MakeRecords();
+    NS_TEST_ASSERT_MSG_EQ(WriteTrace(path, BoidsTraceWriter::CSV, records),
+                          true,
+                          "escribir la traza CSV");
+
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    NS_TEST_ASSERT_MSG_EQ(line, "Time,NodeId,X,Y,IsLeader,IsFire,FireId", "cabecera CSV");
+    uint32_t row = 0;
+    while (std::getline(file, line))
+    {
+        NS_TEST_ASSERT_MSG_LT(row, records.size(), "filas de más");
+        std::istringstream fields(line);
+        std::string field;
+        std::vector<double> values;
+        while (std::getline(fields, field, ','))
+        {
+            values.push_back(std::stod(field));
+        }
+        const BoidsTraceRecord& r = records[row];
+        NS_TEST_ASSERT_MSG_EQ(values.size(), 7, "columnas de la fila " << row);
+        NS_TEST_ASSERT_MSG_EQ(values[0], r.time, "Time de la fila " << row);
+        NS_TEST_ASSERT_MSG_EQ(values[1], r.nodeId, "NodeId de la fila " << row);
+        NS_TEST_ASSERT_MSG_EQ(values[2], r.x, "X de la fila " << row);
+        NS_TEST_ASSERT_MSG_EQ(values[3], r.y, "Y de la fila " << row);
+        NS_TEST_ASSERT_MSG_EQ(values[4], r.isLeader, "IsLeader de la fila " << row);
+        NS_TEST_ASSERT_MSG_EQ(values[5], r.isFire, "IsFire de la fila " << row);
+        NS_TEST_ASSERT_MSG_EQ(values[6], r.fireId, "FireId de la fila " << row);
+        row++;
+    }
+    NS_TEST_ASSERT_MSG_EQ(row, records.size(), "filas escritas");
+}
+
+/**
+ * La traza binaria se lee con BoidsTraceReader: el índice del final tiene un
+ * bloque por instante con su desplazamiento y número de registros, FindFrame lo
+ * busca por tiempo y cada bloque leído en desorden coincide con lo escrito. Una
+ * traza sin cola (no cerrada) no se abre.
+ */
+class BoidsTraceBinaryTestCase : public TestCase
+{
+  public:
+    BoidsTraceBinaryTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+BoidsTraceBinaryTestCase::BoidsTraceBinaryTestCase()
+    : TestCase("Traza binaria escrita y leída por instante con el índice")
+{
+}
+
+void
+BoidsTraceBinaryTestCase::DoRun()
+{
+    std::string path = CreateTempDirFilename("boids-trace.bin");
+    std::vector<BoidsTraceRecord> records = MakeRecords();
+    NS_TEST_ASSERT_MSG_EQ(WriteTrace(path, BoidsTraceWriter::BINARY, records),
+                          true,
+                          "escribir la traza binaria");
+
+    // Cola: el índice empieza justo después de los registros
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    std::vector<char> bytes{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    const uint64_t recordBytes = records.size() * sizeof(BoidsTraceFileRecord);
+    const uint64_t indexOffset = sizeof(BoidsTraceFileHeader) + recordBytes;
+    NS_TEST_ASSERT_MSG_EQ(bytes.size(),
+                          indexOffset + N_FRAMES * sizeof(BoidsTraceIndexEntry) +
+                              sizeof(BoidsTraceFileTrailer),
+                          "tamaño de la traza");
+    BoidsTraceFileTrailer trailer;
+    std::memcpy(&trailer, bytes.data() + bytes.size() - sizeof(trailer), sizeof(trailer));
+    NS_TEST_ASSERT_MSG_EQ(trailer.indexOffset, indexOffset, "inicio del índice");
+    NS_TEST_ASSERT_MSG_EQ(trailer.nFrames, N_FRAMES, "entradas del índice");
+
+    BoidsTraceReader reader;
+    NS_TEST_ASSERT_MSG_EQ(reader.Open(path), true, "abrir la traza binaria");
+    NS_TEST_ASSERT_MSG_EQ(reader.GetNFrames(), N_FRAMES, "instantes en el índice");
+
+    // Del último al primero, para que cada lectura salte por el archivo
+    std::vector<BoidsTraceFileRecord> frame;
+    for (uint32_t f = N_FRAMES; f-- > 0;)
+    {
+        double time = 0.25 * f;
+        NS_TEST_ASSERT_MSG_EQ(reader.GetFrameTime(f), time, "instante del bloque " << f);
+        NS_TEST_ASSERT_MSG_EQ(reader.FindFrame(time), f, "buscar el instante " << time);
+        NS_TEST_ASSERT_MSG_EQ(reader.FindFrame(time - 0.1), f, "buscar antes de " << time);
+
+        std::vector<BoidsTraceRecord> expected = FrameRecords(records, time);
+        NS_TEST_ASSERT_MSG_EQ(reader.ReadFrame(f, frame), true, "leer el bloque " << f);
+        NS_TEST_ASSERT_MSG_EQ(frame.size(), expected.size(), "registros del bloque " << f);
+        for (uint32_t i = 0; i < frame.size() && i < expected.size(); ++i)
+        {
+            const BoidsTraceRecord& r = expected[i];
+            // En los eventos de fuego nodeId guarda el id del fuego
+            int32_t id = r.isFire ? r.fireId : r.nodeId;
+            NS_TEST_ASSERT_MSG_EQ(frame[i].nodeId, id, "id del registro " << i);
+            NS_TEST_ASSERT_MSG_EQ(frame[i].isLeader, r.isLeader, "isLeader del registro " << i);
+            NS_TEST_ASSERT_MSG_EQ(frame[i].isFire, r.isFire, "isFire del registro " << i);
+            NS_TEST_ASSERT_MSG_EQ(frame[i].x, r.x, "x del registro " << i);
+            NS_TEST_ASSERT_MSG_EQ(frame[i].y, r.y, "y del registro " << i);
+        }
+    }
+    NS_TEST_ASSERT_MSG_EQ(reader.FindFrame(0.25 * N_FRAMES), N_FRAMES, "instante posterior");
+    NS_TEST_ASSERT_MSG_EQ(reader.ReadFrame(N_FRAMES, frame), false, "bloque inexistente");
+
+    // Sin la cola el lector no puede ubicar el índice
+    std::string truncated = CreateTempDirFilename("boids-trace-truncated.bin");
+    std::ofstream out(truncated, std::ios::out | std::ios::binary);
+    out.write(bytes.data(), indexOffset);
+    out.close();
+    BoidsTraceReader truncatedReader;
+    NS_TEST_ASSERT_MSG_EQ(truncatedReader.Open(truncated), false, "abrir una traza sin cerrar");
+}
+
+/**
+ * Pruebas de BoidsTraceWriter y BoidsTraceReader.
+ */
+class BoidsTraceTestSuite : public TestSuite
+{
+  public:
+    BoidsTraceTestSuite();
+};
+
+BoidsTraceTestSuite::BoidsTraceTestSuite()
+    : TestSuite("boids-trace", Type::UNIT)
+{
+    AddTestCase(new BoidsTraceCsvTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new BoidsTraceBinaryTestCase, TestCase::Duration::QUICK);
+}
+
+static BoidsTraceTestSuite g_boidsTraceTestSuite;
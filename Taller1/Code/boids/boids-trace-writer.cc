@@ -0,0 +1,232 @@
+#include "boids-trace-writer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace ns3
+{
+
+BoidsTraceWriter::BoidsTraceWriter()
+    : m_format(CSV),
+      m_open(false),
+      m_recordsPerBuffer(0),
+      m_current(nullptr),
+      m_stop(false),
+      m_fileOffset(0),
+      m_recordsWritten(0),
+      m_buffersWritten(0),
+      m_stalls(0),
+      m_stallSeconds(0.0)
+{
+}
+
+BoidsTraceWriter::~BoidsTraceWriter()
+{
+    Close();
+}
+
+bool
+BoidsTraceWriter::Open(const std::string& path,
+                       Format format,
+                       uint32_t recordsPerBuffer,
+                       uint32_t maxQueuedBuffers)
+{
+    Close();
+    m_format = format;
+    m_file.open(path, format == BINARY ? std::ios::out | std::ios::binary : std::ios::out);
+    if (!m_file.is_open())
+    {
+        return false;
+    }
+    if (m_format == BINARY)
+    {
+        BoidsTraceFileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, BOIDS_TRACE_MAGIC, sizeof(header.magic));
+        header.version = BOIDS_TRACE_VERSION;
+        header.recordSize = sizeof(BoidsTraceFileRecord);
+        m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        m_fileOffset = sizeof(header);
+        m_index.clear();
+    }
+    else
+    {
+        m_file << "Time,NodeId,X,Y,IsLeader,IsFire,FireId\n";
+    }
+
+    m_recordsPerBuffer = std::max<uint32_t>(1, recordsPerBuffer);
+    // Un buffer en llenado, los de la cola y uno que el escritor está vaciando
+    m_buffers.assign(std::max<uint32_t>(1, maxQueuedBuffers) + 2, Buffer());
+    m_free.clear();
+    m_full.clear();
+    for (Buffer& buffer : m_buffers)
+    {
+        buffer.reserve(m_recordsPerBuffer);
+        m_free.push_back(&buffer);
+    }
+    m_current = m_free.back();
+    m_free.pop_back();
+
+    m_stop = false;
+    m_recordsWritten = 0;
+    m_buffersWritten = 0;
+    m_stalls = 0;
+    m_stallSeconds = 0.0;
+    m_open = true;
+    m_thread = std::thread(&BoidsTraceWriter::WriterLoop, this);
+    return true;
+}
+
+void
+BoidsTraceWriter::SubmitCurrent()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_full.push_back(m_current);
+    m_fullCv.notify_one();
+
+    if (m_free.empty())
+    {
+        // Contrapresión: el disco no da abasto, la simulación espera un buffer libre
+        auto start = std::chrono::steady_clock::now();
+        m_freeCv.wait(lock, [this] { return !m_free.empty(); });
+        m_stalls++;
+        m_stallSeconds +=
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    m_current = m_free.back();
+    m_free.pop_back();
+}
+
+void
+BoidsTraceWriter::WriterLoop()
+{
+    while (true)
+    {
+        Buffer* buffer;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_fullCv.wait(lock, [this] { return m_stop || !m_full.empty(); });
+            if (m_full.empty())
+            {
+                return; // m_stop y nada pendiente
+            }
+            buffer = m_full.front();
+            m_full.pop_front();
+        }
+
+        WriteBuffer(*buffer);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_recordsWritten += buffer->size();
+        m_buffersWritten++;
+        buffer->clear();
+        m_free.push_back(buffer);
+        m_freeCv.notify_one();
+    }
+}
+
+void
+BoidsTraceWriter::WriteBuffer(const Buffer& buffer)
+{
+    if (m_format == BINARY)
+    {
+        WriteBinaryBuffer(buffer);
+        return;
+    }
+    for (const BoidsTraceRecord& r : buffer)
+    {
+        m_file << r.time << "," << r.nodeId << "," << r.x << "," << r.y << ","
+               << static_cast<int>(r.isLeader) << "," << static_cast<int>(r.isFire) << ","
+               << r.fireId << "\n";
+    }
+}
+
+void
+BoidsTraceWriter::WriteBinaryBuffer(const Buffer& buffer)
+{
+    // Los registros llegan en orden de tiempo: un cambio de instante abre un bloque
+    m_scratch.resize(buffer.size());
+    for (size_t i = 0; i < buffer.size(); ++i)
+    {
+        const BoidsTraceRecord& r = buffer[i];
+        if (m_index.empty() || m_index.back().time != r.time)
+        {
+            m_index.push_back({r.time, m_fileOffset + i * sizeof(BoidsTraceFileRecord), 0});
+        }
+        m_index.back().count++;
+        int32_t id = r.isFire ? r.fireId : r.nodeId;
+        m_scratch[i] = {id, r.isLeader, r.isFire, 0, r.x, r.y};
+    }
+    size_t bytes = m_scratch.size() * sizeof(BoidsTraceFileRecord);
+    m_file.write(reinterpret_cast<const char*>(m_scratch.data()), bytes);
+    m_fileOffset += bytes;
+}
+
+void
+BoidsTraceWriter::WriteBinaryIndex()
+{
+    BoidsTraceFileTrailer trailer;
+    trailer.indexOffset = m_fileOffset;
+    trailer.nFrames = m_index.size();
+    std::memcpy(trailer.magic, BOIDS_TRACE_INDEX_MAGIC, sizeof(trailer.magic));
+    m_file.write(reinterpret_cast<const char*>(m_index.data()),
+                 m_index.size() * sizeof(BoidsTraceIndexEntry));
+    m_file.write(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+}
+
+void
+BoidsTraceWriter::Close()
+{
+    if (!m_open)
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_current->empty())
+        {
+            m_full.push_back(m_current);
+        }
+        m_current = nullptr;
+        m_stop = true;
+    }
+    m_fullCv.notify_one();
+    m_thread.join();
+    if (m_format == BINARY)
+    {
+        WriteBinaryIndex();
+    }
+    m_file.close();
+    m_open = false;
+}
+
+uint64_t
+BoidsTraceWriter::GetRecordsWritten() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_recordsWritten;
+}
+
+uint64_t
+BoidsTraceWriter::GetBuffersWritten() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_buffersWritten;
+}
+
+uint64_t
+BoidsTraceWriter::GetStalls() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stalls;
+}
+
+double
+BoidsTraceWriter::GetStallSeconds() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stallSeconds;
+}
+
+} // namespace ns3
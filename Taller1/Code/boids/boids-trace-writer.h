@@ -0,0 +1,126 @@
+#ifndef BOIDS_TRACE_WRITER_H
+#define BOIDS_TRACE_WRITER_H
+
+#include "boids-trace-format.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ns3
+{
+
+// Fila de boids_positions.csv (posición de un boid o evento de un fuego)
+struct BoidsTraceRecord
+{
+    double time;
+    int32_t nodeId; // -1 para fuegos
+    double x;
+    double y;
+    uint8_t isLeader;
+    uint8_t isFire; // 0 boid, BOIDS_TRACE_FIRE_CREATED o BOIDS_TRACE_FIRE_EXTINGUISHED
+    int32_t fireId; // -1 para boids
+};
+
+/**
+ * Escritor asíncrono de la traza de posiciones.
+ *
+ * El hilo de simulación solo copia registros de tamaño fijo a un buffer
+ * preasignado. Cuando el buffer se llena pasa a una cola acotada y un hilo en
+ * segundo plano le da formato (CSV o binario, ver boids-trace-format.h) y lo
+ * escribe en disco. Si la cola está llena el hilo de simulación espera
+ * (contrapresión) y la espera queda en las estadísticas.
+ */
+class BoidsTraceWriter
+{
+  public:
+    enum Format
+    {
+        CSV,
+        BINARY
+    };
+
+    BoidsTraceWriter();
+    ~BoidsTraceWriter();
+
+    /**
+     * Abre el archivo, escribe la cabecera y arranca el hilo escritor.
+     *
+     * \param path archivo de salida
+     * \param format CSV o binario indexado por instante
+     * \param recordsPerBuffer registros por buffer
+     * \param maxQueuedBuffers buffers llenos que pueden esperar en la cola
+     * \return false si no se pudo abrir el archivo
+     */
+    bool Open(const std::string& path,
+              Format format = CSV,
+              uint32_t recordsPerBuffer = 16384,
+              uint32_t maxQueuedBuffers = 4);
+
+    bool IsOpen() const
+    {
+        return m_open;
+    }
+
+    void Write(const BoidsTraceRecord& record)
+    {
+        m_current->push_back(record);
+        if (m_current->size() == m_recordsPerBuffer)
+        {
+            SubmitCurrent();
+        }
+    }
+
+    // Escribe lo pendiente y el índice, espera al hilo escritor y cierra el archivo
+    void Close();
+
+    uint64_t GetRecordsWritten() const;
+    uint64_t GetBuffersWritten() const;
+    // Veces que la simulación esperó por un buffer libre y tiempo total de espera
+    uint64_t GetStalls() const;
+    double GetStallSeconds() const;
+
+  private:
+    typedef std::vector<BoidsTraceRecord> Buffer;
+
+    void SubmitCurrent();
+    void WriterLoop();
+    void WriteBuffer(const Buffer& buffer);
+    void WriteBinaryBuffer(const Buffer& buffer);
+    void WriteBinaryIndex();
+
+    std::ofstream m_file;
+    Format m_format;
+    bool m_open;
+    uint32_t m_recordsPerBuffer;
+
+    std::vector<Buffer> m_buffers; // Preasignados en Open
+    Buffer* m_current;
+    std::deque<Buffer*> m_full;
+    std::vector<Buffer*> m_free;
+
+    std::thread m_thread;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_fullCv;
+    std::condition_variable m_freeCv;
+    bool m_stop;
+
+    // Solo formato binario (los usa el hilo escritor)
+    std::vector<BoidsTraceFileRecord> m_scratch;
+    std::vector<BoidsTraceIndexEntry> m_index;
+    uint64_t m_fileOffset;
+
+    uint64_t m_recordsWritten;
+    uint64_t m_buffersWritten;
+    uint64_t m_stalls;
+    double m_stallSeconds;
+};
+
+} // namespace ns3
+
+#endif /* BOIDS_TRACE_WRITER_H */
@@ -1,4 +1,8 @@
+#include "../src/mobility/model/boids-checkpoint.h"
+#include "../src/mobility/model/boids-helper.h"
 #include "../src/mobility/model/boids-mobility-model.h"
+#include "../src/mobility/model/boids-telemetry-ring.h"
+#include "../src/mobility/model/boids-trace-writer.h"
 
 #include "ns3/core-module.h"
 #include "ns3/internet-module.h" // InternetStackHelper, Ipv4*
@@ -22,24 +26,133 @@ std::vector<NodeContainer> clusters; // Vector para almacenar los clusters forma
 
 std::ofstream outFile("boids_data.csv");
 
+BoidsFireTimeline fireTimeline; // Fuegos de toda la ejecución, repetidos por AddRandomFire
+
 static const uint32_t N_CH = 2;   // Número de líderes (Cluster-Heads)
 static const uint32_t N_MEM = 10; // Número de seguidores (Miembros)
 
 /*------------------------------------------------
     1. Configuración de parámetros
 ------------------------------------------------*/
-std::pair<uint32_t, uint32_t>
-ParseCommandLine(int argc, char* argv[])
+struct SimulationConfig
 {
     uint32_t nClusterHeads = N_CH; // Número de líderes (Cluster-Heads)
     uint32_t nFollowers = N_MEM;   // Número de seguidores
-    CommandLine cmd;               // Procesa argumentos de línea de comandos
-    cmd.AddValue("nClusterHeads", "Número de líderes (Cluster-Heads)", nClusterHeads);
-    cmd.AddValue("nFollowers", "Número de seguidores", nFollowers);
+    std::string positionsFile = "boids_positions.csv";
+    std::string summaryFile = "boids_summary.csv";
+    uint32_t threads = 1; // Hilos para el paso de la bandada
+    int64_t stream = 1;   // Primer stream de los generadores aleatorios
+    bool asyncTrace = true; // Escribir la traza de posiciones en un hilo aparte
+    std::string traceFormat = "csv"; // csv o binary (ver boids-trace-format.h)
+    std::string assignment = "auto";  // Asignación fuego-líder: auto, hungarian, auction, greedy
+    std::string eventsFile = "";      // Traza de eventos (liderazgo, fuegos, clusters); vacío = no
+    bool mobilityOnly = false;        // Sin Wi-Fi, IP ni pcap: solo movilidad y fuegos
+    uint32_t seed = 1;                // Semilla global (RngSeedManager::SetSeed)
+    uint64_t run = 1;                 // Réplica independiente (RngSeedManager::SetRun)
+    double simTime = 100.0;           // Segundos simulados
+    double checkpointAt = -1.0;       // Instante del checkpoint (negativo = no guardar)
+    std::string checkpointFile = "boids_checkpoint.bin";
+    std::string restoreFrom = "";     // Checkpoint desde el que continuar; vacío = desde cero
+    std::string fireProcess = "thomas"; // Proceso de los fuegos: poisson, thomas, matern, inhibition
+    std::string fireTimeline = "";      // Línea temporal de fuegos a repetir; vacío = generarla
+    std::string saveFireTimeline = "";  // Dónde guardar la línea temporal usada; vacío = no
+    std::string telemetry = "";         // Segmento de memoria compartida en vivo; vacío = no
+    uint32_t telemetrySlots = 64;       // Tramas que guarda el anillo
+    uint32_t telemetryInterval = 1;     // Ticks entre tramas
+    std::string metricsFile = "";       // Cuantiles y tasas; vacío = no
+    std::string metricsSeriesFile = ""; // Una fila por muestra; vacío = no
+    double metricsPeriod = 1.0;         // Segundos entre muestras
+};
+
+SimulationConfig
+ParseCommandLine(int argc, char* argv[])
+{
+    SimulationConfig config;
+    CommandLine cmd; // Procesa argumentos de línea de comandos
+    cmd.AddValue("nClusterHeads", "Número de líderes (Cluster-Heads)", config.nClusterHeads);
+    cmd.AddValue("nFollowers", "Número de seguidores", config.nFollowers);
+    cmd.AddValue("positionsFile", "Archivo CSV para posiciones", config.positionsFile);
+    cmd.AddValue("summaryFile", "Archivo CSV para métricas", config.summaryFile);
+    cmd.AddValue("threads",
+                 "Hilos para el paso de la bandada (resultado idéntico con cualquier valor)",
+                 config.threads);
+    cmd.AddValue("stream",
+                 "Primer stream de los generadores aleatorios (misma semilla y stream, "
+                 "misma ejecución)",
+                 config.stream);
+    cmd.AddValue("asyncTrace",
+                 "Escribir boids_positions.csv desde un hilo en segundo plano",
+                 config.asyncTrace);
+    cmd.AddValue("traceFormat",
+                 "Formato de la traza de posiciones: csv o binary (indexado por instante)",
+                 config.traceFormat);
+    cmd.AddValue("assignment",
+                 "Asignación de fuegos a líderes: auto, hungarian, auction o greedy",
+                 config.assignment);
+    cmd.AddValue("eventsFile",
+                 "Archivo de eventos de liderazgo, fuegos, clusters y resumen por tick "
+                 "(vacío para no escribirlo)",
+                 config.eventsFile);
+    cmd.AddValue("mobilityOnly",
+                 "Solo movilidad: nodos sin Wi-Fi, pila IP ni pcap (mismas salidas CSV)",
+                 config.mobilityOnly);
+    cmd.AddValue("seed", "Semilla global de los generadores aleatorios", config.seed);
+    cmd.AddValue("run", "Número de réplica (subflujos independientes con la misma semilla)",
+                 config.run);
+    cmd.AddValue("simTime", "Segundos simulados", config.simTime);
+    cmd.AddValue("checkpointAt",
+                 "Instante (s) en que guardar el estado de la bandada (negativo para no guardarlo)",
+                 config.checkpointAt);
+    cmd.AddValue("checkpointFile", "Archivo del checkpoint", config.checkpointFile);
+    cmd.AddValue("restoreFrom",
+                 "Continuar desde un checkpoint (mismos nodos; --run distinto para variantes)",
+                 config.restoreFrom);
+    cmd.AddValue("fireProcess",
+                 "Proceso puntual de los fuegos (poisson, thomas, matern, inhibition)",
+                 config.fireProcess);
+    cmd.AddValue("fireTimeline",
+                 "Repetir los fuegos de este archivo (mismos fuegos en todas las variantes)",
+                 config.fireTimeline);
+    cmd.AddValue("saveFireTimeline",
+                 "Guardar la línea temporal de fuegos de esta ejecución",
+                 config.saveFireTimeline);
+    cmd.AddValue("telemetry",
+                 "Publicar cada tick en este segmento de memoria compartida para verlo en vivo "
+                 "(simulate/boids_telemetry.py; vacío para no hacerlo)",
+                 config.telemetry);
+    cmd.AddValue("telemetrySlots", "Tramas del anillo de telemetría", config.telemetrySlots);
+    cmd.AddValue("telemetryInterval",
+                 "Ticks entre tramas de telemetría",
+                 config.telemetryInterval);
+    cmd.AddValue("metricsFile",
+                 "Resumen de latencia de extinción (p50/p95/p99), fuegos, líderes y rotación "
+                 "de liderazgo (opcional)",
+                 config.metricsFile);
+    cmd.AddValue("metricsSeriesFile",
+                 "Serie de fuegos activos, líderes y tamaño de clusters por muestra "
+                 "(opcional)",
+                 config.metricsSeriesFile);
+    cmd.AddValue("metricsPeriod", "Segundos simulados entre muestras", config.metricsPeriod);
     cmd.Parse(argc, argv); // Procesa los argumentos
-    NS_LOG_UNCOND("Configuración: " << nClusterHeads << " líderes, " << nFollowers
-                                    << " seguidores");
-    return {nClusterHeads, nFollowers};
+    if (!BoidsMobilityModel::GetFireAssigner().SetAlgorithm(config.assignment))
+    {
+        NS_FATAL_ERROR("Algoritmo de asignación desconocido: " << config.assignment);
+    }
+    if (!BoidsMobilityModel::GetFireProcess().SetType(config.fireProcess))
+    {
+        NS_FATAL_ERROR("Proceso de fuegos desconocido: " << config.fireProcess);
+    }
+    if (config.traceFormat == "binary")
+    {
+        config.asyncTrace = true; // La traza binaria solo la escribe BoidsTraceWriter
+    }
+    NS_LOG_UNCOND("Configuración: " << config.nClusterHeads << " líderes, " << config.nFollowers
+                                    << " seguidores, " << config.threads << " hilos");
+
+    Config::SetDefault("ns3::BoidsFlockController::Threads", UintegerValue(config.threads));
+    RngSeedManager::SetSeed(config.seed);
+    RngSeedManager::SetRun(config.run);
+    return config;
 }
 
 /*------------------------------------------------
@@ -81,7 +194,7 @@ CreateNodes(uint32_t nClusterHeads, uint32_t nFollowers)
 }
 
 void
-CreateClusters()
+CreateClusters(bool listMembers)
 {
     // Distribuye los nodos seguidores en clusters basados en los nodos líderes (Cluster-Heads)
     int nMembers = memberNodes.GetN();
@@ -116,7 +229,7 @@ CreateClusters()
         NS_LOG_UNCOND("Cluster " << i << " (Líder: Node " << chNodes.Get(i)->GetId() << ")");
         NS_LOG_UNCOND("  Miembros: " << clusters[i].GetN() << " nodos");
 
-        for (uint32_t j = 0; j < clusters[i].GetN(); ++j)
+        for (uint32_t j = 0; listMembers && j < clusters[i].GetN(); ++j)
         {
             NS_LOG_UNCOND("    - Node " << clusters[i].Get(j)->GetId());
         }
@@ -190,22 +303,49 @@ AssignIpv4()
     ip.Assign(memberIntf);
 }
 
+// El checkpoint fija el liderazgo sin pasar por la traza LeadershipChanged
+void
+ResetLeaderCount(Ptr<BoidsTraceCounters> counters)
+{
+    NodeContainer boidNodes(chNodes, memberNodes);
+    uint32_t nLeaders = 0;
+    for (NodeContainer::Iterator i = boidNodes.Begin(); i != boidNodes.End(); ++i)
+    {
+        Ptr<BoidsMobilityModel> model = (*i)->GetObject<BoidsMobilityModel>();
+        if (model && model->IsLeader())
+        {
+            nLeaders++;
+        }
+    }
+    counters->ResetLeaders(nLeaders);
+}
+
 int
 main(int argc, char* argv[])
 {
-    std::string outFileName = "boids_positions.csv";
-    std::string summaryFileName = "boids_summary.csv";
-
-    CommandLine cmd;
-    cmd.AddValue("positionsFile", "Archivo CSV para posiciones", outFileName);
-    cmd.AddValue("summaryFile", "Archivo CSV para métricas", summaryFileName);
-    // ...otros argumentos...
-    cmd.Parse(argc, argv);
+    /*------------------------------------------------
+       1. Configuración de parámetros
+   ------------------------------------------------*/
+    SimulationConfig config = ParseCommandLine(argc, argv);
 
-    std::ofstream outFile(outFileName);
-    BoidsMobilityModel::SetOutputFile(&outFile);
+    std::ofstream outFile;
+    BoidsTraceWriter traceWriter;
+    bool opened;
+    if (config.asyncTrace)
+    {
+        opened = traceWriter.Open(config.positionsFile,
+                                  config.traceFormat == "binary" ? BoidsTraceWriter::BINARY
+                                                                 : BoidsTraceWriter::CSV);
+        BoidsMobilityModel::SetTraceWriter(&traceWriter);
+    }
+    else
+    {
+        outFile.open(config.positionsFile);
+        opened = outFile.is_open();
+        BoidsMobilityModel::SetOutputFile(&outFile);
+    }
 
-    if (!outFile.is_open())
+    if (!opened)
     {
         NS_LOG_UNCOND("No se pudo abrir el archivo de salida!");
         return 1;
@@ -213,11 +353,10 @@ main(int argc, char* argv[])
 
     // outFile.open("boids_positions.csv");
     // outFile << "Time,NodeId,X,Y,IsLeader\n";
-    outFile << "Time,NodeId,X,Y,IsLeader,IsFire\n";
-    /*------------------------------------------------
-       1. Configuración de parámetros
-   ------------------------------------------------*/
-    auto [nCH, nMem] = ParseCommandLine(argc, argv);
+    if (!config.asyncTrace)
+    {
+        outFile << "Time,NodeId,X,Y,IsLeader,IsFire,FireId\n";
+    }
 
     /*------------------------------------------------
         2. Creación de nodos y Clusters
@@ -225,21 +364,24 @@ main(int argc, char* argv[])
     // Crear nodos
     // NodeContainer nodes;
     // nodes.Create(20);
-    CreateNodes(nCH, nMem);
-    CreateClusters();
+    CreateNodes(config.nClusterHeads, config.nFollowers);
+    CreateClusters(!config.mobilityOnly);
 
     /*------------------------------------------------
         3. Configuración de Wi-Fi para los nodos
     ------------------------------------------------*/
-    SetupWifi();
-    // Configuración de la capa física para capturar paquetes en formato pcap
-    // Esto permite registrar los paquetes transmitidos y recibidos en un archivo pcap para su
-    // posterior análisis
-    InstallInternet();
-    AssignIpv4();
+    // En modo solo movilidad los nodos no llevan dispositivos ni pila de red
+    if (!config.mobilityOnly)
+    {
+        SetupWifi();
+        // Configuración de la capa física para capturar paquetes en formato pcap
+        // Esto permite registrar los paquetes transmitidos y recibidos en un archivo pcap para
+        // su posterior análisis
+        InstallInternet();
+        AssignIpv4();
+    }
 
-    BoidsMobilityModel::s_clusters = &clusters;
-    BoidsMobilityModel::s_chNodes = &chNodes;
+    BoidsMobilityModel::SetClusters(chNodes, clusters);
 
     // Configurar movilidad
     MobilityHelper mobility;
@@ -256,9 +398,47 @@ main(int argc, char* argv[])
     mobility.Install(chNodes);
     mobility.Install(memberNodes);
 
+    // Streams fijos para boids, fuegos y colocación inicial
+    BoidsHelper boidsHelper;
+    int64_t stream = config.stream;
+    stream += boidsHelper.AssignStreams(chNodes, stream);
+    stream += boidsHelper.AssignStreams(memberNodes, stream);
+
+    // Contadores de eventos y, opcionalmente, traza de eventos en texto
+    Ptr<BoidsTraceCounters> counters = boidsHelper.EnableCounters(chNodes);
+    boidsHelper.EnableCounters(memberNodes);
+    // Métricas en flujo: memoria fija, sin guardar trayectorias. Solo se conectan si
+    // se pide alguna salida: con FlockStats conectado cada tick calcula las
+    // estadísticas de la bandada
+    Ptr<BoidsStreamingMetrics> metrics;
+    if (!config.metricsFile.empty() || !config.metricsSeriesFile.empty())
+    {
+        metrics = boidsHelper.EnableMetrics(chNodes);
+        boidsHelper.EnableMetrics(memberNodes);
+        metrics->SetSamplePeriod(Seconds(config.metricsPeriod));
+        if (!config.metricsSeriesFile.empty() && !metrics->OpenSeries(config.metricsSeriesFile))
+        {
+            NS_FATAL_ERROR("No se pudo abrir la serie de métricas " << config.metricsSeriesFile);
+        }
+    }
+    if (!config.eventsFile.empty())
+    {
+        AsciiTraceHelper ascii;
+        Ptr<OutputStreamWrapper> events = ascii.CreateFileStream(config.eventsFile);
+        boidsHelper.EnableAsciiTrace(events, chNodes);
+        boidsHelper.EnableAsciiTrace(events, memberNodes);
+    }
+
     Ptr<UniformRandomVariable> clusterRng = CreateObject<UniformRandomVariable>();
     clusterRng->SetAttribute("Min", DoubleValue(200.0));
     clusterRng->SetAttribute("Max", DoubleValue(800.0));
+    clusterRng->SetStream(stream++);
+
+    // Posición de los seguidores alrededor del líder
+    Ptr<NormalRandomVariable> offsetRng = CreateObject<NormalRandomVariable>();
+    offsetRng->SetAttribute("Mean", DoubleValue(0.0));
+    offsetRng->SetAttribute("Variance", DoubleValue(400.0)); // Más dispersión
+    offsetRng->SetStream(stream++);
 
     // Distribución de clusters
     for (uint32_t i = 0; i < clusters.size(); ++i)
@@ -277,10 +457,6 @@ main(int argc, char* argv[])
         leaderMobility->SetPosition(Vector(centerX, centerY, 0));
 
         // Posicionar los seguidores alrededor del líder
-        Ptr<NormalRandomVariable> offsetRng = CreateObject<NormalRandomVariable>();
-        offsetRng->SetAttribute("Mean", DoubleValue(0.0));
-        offsetRng->SetAttribute("Variance", DoubleValue(400.0)); // Más dispersión
-
         for (uint32_t j = 0; j < clusters[i].GetN(); ++j)
         {
             Ptr<Node> followerNode = clusters[i].Get(j);
@@ -300,11 +476,67 @@ main(int argc, char* argv[])
     InitializeNodes(chNodes, true, 6.5f /*, outFile*/);
     InitializeNodes(memberNodes, false, 6.0f /*, outFile*/);
 
-    BoidsMobilityModel::AddRandomFire();      // Primer fuego
-    BoidsMobilityModel::CheckFireProximity(); // Iniciar verificaciones
+    // Todos los fuegos de la ejecución de una vez, antes de empezar
+    if (!config.fireTimeline.empty())
+    {
+        if (!fireTimeline.Load(config.fireTimeline))
+        {
+            NS_FATAL_ERROR("No se pudo leer la línea temporal de fuegos " << config.fireTimeline);
+        }
+    }
+    else
+    {
+        BoidsMobilityModel::GenerateFireTimeline(Seconds(config.simTime), fireTimeline);
+    }
+    if (!config.saveFireTimeline.empty() && !fireTimeline.Save(config.saveFireTimeline))
+    {
+        NS_FATAL_ERROR("No se pudo escribir la línea temporal de fuegos " << config.saveFireTimeline);
+    }
+    BoidsMobilityModel::SetFireTimeline(&fireTimeline);
+    NS_LOG_UNCOND("Fuegos: " << fireTimeline.GetSize() << " ("
+                             << BoidsPointProcess::GetTypeName(static_cast<BoidsPointProcess::Type>(
+                                    fireTimeline.GetParams().type))
+                             << ")");
+
+    if (config.restoreFrom.empty())
+    {
+        BoidsMobilityModel::AddRandomFire();      // Primer fuego
+        BoidsMobilityModel::CheckFireProximity(); // Iniciar verificaciones
+        Simulator::ScheduleNow(&ns3::BoidsMobilityModel::AssignFiresToLeaders);
+    }
+    else
+    {
+        // Los fuegos y sus verificaciones vienen del checkpoint
+        if (!BoidsCheckpoint::Restore(config.restoreFrom))
+        {
+            NS_FATAL_ERROR("No se pudo restaurar el checkpoint " << config.restoreFrom);
+        }
+        NS_LOG_UNCOND("Continuando desde " << config.restoreFrom << " en "
+                                           << BoidsCheckpoint::GetRestoredTime().GetSeconds()
+                                           << " s");
+        // El estado se carga en el instante guardado; este evento va detrás
+        Simulator::Schedule(BoidsCheckpoint::GetRestoredTime(), &ResetLeaderCount, counters);
+    }
+    if (config.checkpointAt >= 0)
+    {
+        BoidsCheckpoint::Schedule(Seconds(config.checkpointAt), config.checkpointFile);
+    }
+    BoidsTelemetryRing telemetry;
+    if (!config.telemetry.empty())
+    {
+        if (!telemetry.Open(config.telemetry,
+                            chNodes.GetN() + memberNodes.GetN(),
+                            1024,
+                            config.telemetrySlots,
+                            config.telemetryInterval))
+        {
+            NS_FATAL_ERROR("No se pudo crear el segmento de telemetría " << config.telemetry);
+        }
+        NS_LOG_UNCOND("Telemetría en vivo: python3 simulate/boids_telemetry.py "
+                      << config.telemetry);
+    }
     // Ejecutar simulación
-    Simulator::ScheduleNow(&ns3::BoidsMobilityModel::AssignFiresToLeaders);
-    Simulator::Stop(Seconds(100));
+    Simulator::Stop(Seconds(config.simTime));
     Simulator::Run();
 
     // Métricas de efectividad global
@@ -317,14 +549,62 @@ main(int argc, char* argv[])
     NS_LOG_UNCOND("=== MÉTRICAS DE EXTINCIÓN DE FUEGOS ===");
     NS_LOG_UNCOND("Número total de fuegos extinguidos: " << totalExtinguished);
     NS_LOG_UNCOND("Tiempo promedio de extinción: " << avgExtinction << " s");
+    if (metrics)
+    {
+        const BoidsLatencySketch& latency = metrics->GetLatency();
+        NS_LOG_UNCOND("Latencia de extinción: p50 " << latency.GetQuantile(0.50) << " s, p95 "
+                                                    << latency.GetQuantile(0.95) << " s, p99 "
+                                                    << latency.GetQuantile(0.99) << " s");
+    }
     NS_LOG_UNCOND("========================================");
+    NS_LOG_UNCOND("Asignación de fuegos: " << BoidsMobilityModel::GetFireAssigner().GetSolveCount()
+                                           << " resoluciones, "
+                                           << BoidsMobilityModel::GetFireAssigner().GetReuseCount()
+                                           << " reutilizadas");
+    NS_LOG_UNCOND("Liderazgo: " << counters->promotions << " promociones, " << counters->demotions
+                                << " renuncias, máximo " << counters->GetMaxLeaders()
+                                << " líderes; cambios de cluster: " << counters->clusterChanges);
+
+    // Distribución final de clusters (exportada desde la tabla de pertenencia)
+    BoidsMobilityModel::GetClusterTable().Export(clusters);
+    for (uint32_t i = 0; i < clusters.size(); ++i)
+    {
+        NS_LOG_UNCOND("Cluster " << i << " final: " << clusters[i].GetN() << " miembros");
+    }
 
-    // Opcional: Guardar en archivo resumen
-    std::ofstream summary("boids_summary.csv");
-    summary << "TotalExtinguished,AvgExtinctionTime\n";
-    summary << totalExtinguished << "," << avgExtinction << "\n";
+    // Resumen de la ejecución (una fila; sweep.py los combina)
+    std::ofstream summary(config.summaryFile);
+    summary << "TotalExtinguished,AvgExtinctionTime,Seed,Run,SimTime,Promotions,Demotions,"
+               "MaxLeaders,ClusterChanges\n";
+    summary << totalExtinguished << "," << avgExtinction << "," << config.seed << ","
+            << config.run << "," << config.simTime << "," << counters->promotions << ","
+            << counters->demotions << "," << counters->GetMaxLeaders() << ","
+            << counters->clusterChanges << "\n";
     summary.close();
+    if (metrics)
+    {
+        metrics->CloseSeries();
+        if (!config.metricsFile.empty() && !metrics->WriteSummary(config.metricsFile))
+        {
+            NS_LOG_UNCOND("No se pudo escribir " << config.metricsFile);
+        }
+    }
 
+    if (telemetry.IsOpen())
+    {
+        telemetry.Close();
+        NS_LOG_UNCOND("Telemetría: " << telemetry.GetFramesPublished() << " tramas");
+    }
+
+    if (config.asyncTrace)
+    {
+        traceWriter.Close();
+        BoidsMobilityModel::SetTraceWriter(nullptr);
+        NS_LOG_UNCOND("Traza: " << traceWriter.GetRecordsWritten() << " registros en "
+                                << traceWriter.GetBuffersWritten() << " buffers, "
+                                << traceWriter.GetStalls() << " esperas ("
+                                << traceWriter.GetStallSeconds() << " s)");
+    }
     outFile.close();
     Simulator::Destroy();
 
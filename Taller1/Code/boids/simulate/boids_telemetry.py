@@ -0,0 +1,135 @@
+"""Lectura en vivo del anillo de telemetría de boids.cc (--telemetry=<nombre>).
+
+La simulación publica una trama por tick en un segmento de memoria compartida
+POSIX (ver boids-telemetry-format.h) sin esperar nunca a los lectores. Este
+lector mapea el segmento en solo lectura (en Linux, /dev/shm/<nombre>), copia la
+trama que pide y la descarta si el simulador la sobrescribió mientras tanto: un
+lector lento pierde tramas, pero no frena la simulación. Puede conectarse y
+desconectarse en cualquier momento.
+
+Uso como monitor: python3 boids_telemetry.py boids
+"""
+
+import os
+import sys
+import time
+
+import numpy as np
+
+MAGIC = b"BOIDSTM1"
+VERSION = 1
+
+HEADER_DTYPE = np.dtype([("magic", "S8"), ("version", "<u4"), ("n_slots", "<u4"),
+                         ("slot_size", "<u8"), ("max_boids", "<u4"), ("max_fires", "<u4"),
+                         ("published", "<u8"), ("closed", "<u8"), ("reserved", "<u8", (2,))])
+SLOT_DTYPE = np.dtype([("sequence", "<u8"), ("tick", "<u8"), ("time_ns", "<i8"),
+                       ("n_boids", "<u4"), ("n_fires", "<u4"), ("n_leaders", "<u4"),
+                       ("truncated", "<u4"), ("reserved", "<u8")])
+# Mismos nombres de campo que las trazas de boids_trace.py
+BOID_DTYPE = np.dtype([("NodeId", "<u4"), ("IsLeader", "u1"), ("reserved", "u1", (3,)),
+                       ("X", "<f4"), ("Y", "<f4")])
+FIRE_DTYPE = np.dtype([("FireId", "<u4"), ("reserved", "<u4"), ("X", "<f4"), ("Y", "<f4")])
+
+
+class TelemetryReader:
+    """Lector del anillo de telemetría de una simulación en curso."""
+
+    def __init__(self, name):
+        # shm_open("/boids") crea /dev/shm/boids
+        path = os.path.join("/dev/shm", name.lstrip("/"))
+        self._data = np.memmap(path, dtype=np.uint8, mode="r")
+        header = self._data[:HEADER_DTYPE.itemsize].view(HEADER_DTYPE)
+        if header["magic"][0] != MAGIC or header["version"][0] != VERSION:
+            raise ValueError(f"{path} no es un anillo de telemetría de boids")
+        self._header = header
+        self.n_slots = int(header["n_slots"][0])
+        self.slot_size = int(header["slot_size"][0])
+        self.max_boids = int(header["max_boids"][0])
+        self.max_fires = int(header["max_fires"][0])
+        self.dropped = 0  # Tramas que follow() no llegó a leer
+        self._next = None
+
+    @property
+    def published(self):
+        """Tramas publicadas hasta ahora (la última es published - 1)."""
+        return int(self._header["published"][0])
+
+    @property
+    def closed(self):
+        """True cuando la simulación ha terminado."""
+        return bool(self._header["closed"][0])
+
+    def read(self, k):
+        """Copia de la trama k, o None si ya se sobrescribió o aún no existe."""
+        begin = HEADER_DTYPE.itemsize + (k % self.n_slots) * self.slot_size
+        slot = self._data[begin:begin + SLOT_DTYPE.itemsize].view(SLOT_DTYPE)
+        complete = 2 * k + 2
+        if int(slot["sequence"][0]) != complete:
+            return None
+        meta = slot[0].copy()
+        boids_begin = begin + SLOT_DTYPE.itemsize
+        fires_begin = boids_begin + self.max_boids * BOID_DTYPE.itemsize
+        boids = self._data[boids_begin:boids_begin + int(meta["n_boids"]) * BOID_DTYPE.itemsize]
+        fires = self._data[fires_begin:fires_begin + int(meta["n_fires"]) * FIRE_DTYPE.itemsize]
+        boids = boids.view(BOID_DTYPE).copy()
+        fires = fires.view(FIRE_DTYPE).copy()
+        # Si el escritor entró en la ranura durante la copia, la copia no vale
+        if int(slot["sequence"][0]) != complete:
+            return None
+        return {"tick": int(meta["tick"]), "time": int(meta["time_ns"]) * 1e-9,
+                "n_leaders": int(meta["n_leaders"]), "truncated": int(meta["truncated"]),
+                "boids": boids, "fires": fires}
+
+    def latest(self):
+        """Última trama completa, o None si todavía no hay ninguna."""
+        for _ in range(3):
+            published = self.published
+            if published == 0:
+                return None
+            frame = self.read(published - 1)
+            if frame is not None:
+                return frame
+        return None
+
+    def follow(self, poll=0.05):
+        """Recorre las tramas en orden desde la más reciente al conectarse.
+
+        Las que el simulador sobrescribe antes de leerlas se saltan y se cuentan
+        en dropped. Termina cuando la simulación cierra el anillo.
+        """
+        if self._next is None:
+            self._next = max(0, self.published - 1)
+        while True:
+            published = self.published
+            if self._next >= published:
+                if self.closed:
+                    return
+                time.sleep(poll)
+                continue
+            # Las más antiguas que el anillo ya no guarda se dan por perdidas
+            oldest = max(0, published - self.n_slots + 1)
+            if self._next < oldest:
+                self.dropped += oldest - self._next
+                self._next = oldest
+            frame = self.read(self._next)
+            self._next += 1
+            if frame is None:
+                self.dropped += 1
+                continue
+            yield frame
+
+
+def main():
+    reader = TelemetryReader(sys.argv[1] if len(sys.argv) > 1 else "boids")
+    print(f"{reader.n_slots} ranuras, hasta {reader.max_boids} boids y {reader.max_fires} fuegos")
+    for frame in reader.follow():
+        boids = frame["boids"]
+        cx, cy = (boids["X"].mean(), boids["Y"].mean()) if len(boids) else (np.nan, np.nan)
+        print(f"t={frame['time']:8.2f}s tick {frame['tick']:7d}  boids {len(boids):6d}  "
+              f"líderes {frame['n_leaders']:4d}  fuegos {len(frame['fires']):4d}  "
+              f"centro ({cx:6.1f}, {cy:6.1f})  perdidas {reader.dropped}")
+    print("Simulación terminada")
+
+
+if __name__ == "__main__":
+    main()
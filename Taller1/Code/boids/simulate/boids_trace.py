@@ -0,0 +1,133 @@
+"""Lectura de las trazas de posiciones de boids.cc.
+
+La traza binaria (--traceFormat=binary) se abre con numpy.memmap: solo se leen
+la cabecera y el índice, y cada instante es una vista sin copia de su bloque.
+Para las trazas CSV se agrupan las filas por instante una sola vez.
+
+Los fuegos no se repiten en cada instante: la traza solo guarda su aparición
+(IsFire = 1) y su extinción (IsFire = 2) con un id de fuego, y active_fires
+reconstruye los fuegos activos en cualquier instante.
+"""
+
+import numpy as np
+
+MAGIC = b"BOIDSTR1"
+INDEX_MAGIC = b"BOIDSIDX"
+VERSION = 2
+
+FIRE_CREATED = 1
+FIRE_EXTINGUISHED = 2
+
+HEADER_DTYPE = np.dtype([("magic", "S8"), ("version", "<u4"), ("record_size", "<u4"),
+                         ("reserved", "<u8", (2,))])
+# En los eventos de fuego NodeId guarda el id del fuego
+RECORD_DTYPE = np.dtype([("NodeId", "<i4"), ("IsLeader", "u1"), ("IsFire", "u1"),
+                         ("reserved", "<u2"), ("X", "<f8"), ("Y", "<f8")])
+INDEX_DTYPE = np.dtype([("time", "<f8"), ("offset", "<u8"), ("count", "<u8")])
+TRAILER_DTYPE = np.dtype([("index_offset", "<u8"), ("n_frames", "<u8"), ("magic", "S8")])
+
+
+class _FireTimeline:
+    """Intervalos [aparición, extinción) de cada fuego."""
+
+    def __init__(self, times, fire_ids, kinds, xs, ys):
+        created = kinds == FIRE_CREATED
+        self.fire_id = fire_ids[created]
+        self.x = xs[created]
+        self.y = ys[created]
+        self.start = times[created]
+        self.end = np.full(len(self.fire_id), np.inf)
+        position = {fid: i for i, fid in enumerate(self.fire_id)}
+        extinguished = kinds == FIRE_EXTINGUISHED
+        for fid, t in zip(fire_ids[extinguished], times[extinguished]):
+            if fid in position:
+                self.end[position[fid]] = t
+
+    def active(self, time):
+        mask = (self.start <= time) & (self.end > time)
+        return {"FireId": self.fire_id[mask], "X": self.x[mask], "Y": self.y[mask]}
+
+
+class BinaryTrace:
+    """Traza binaria indexada por instante."""
+
+    def __init__(self, path):
+        self._data = np.memmap(path, dtype=np.uint8, mode="r")
+        header = self._data[:HEADER_DTYPE.itemsize].view(HEADER_DTYPE)[0]
+        if header["magic"] != MAGIC or header["version"] != VERSION:
+            raise ValueError(f"{path} no es una traza binaria de boids")
+        if header["record_size"] != RECORD_DTYPE.itemsize:
+            raise ValueError(f"{path}: tamaño de registro inesperado")
+        trailer = self._data[-TRAILER_DTYPE.itemsize:].view(TRAILER_DTYPE)[0]
+        if trailer["magic"] != INDEX_MAGIC:
+            raise ValueError(f"{path}: falta el índice (¿la simulación no terminó?)")
+        start = int(trailer["index_offset"])
+        end = start + int(trailer["n_frames"]) * INDEX_DTYPE.itemsize
+        self.index = self._data[start:end].view(INDEX_DTYPE)
+        self.times = self.index["time"]
+        # Todos los registros, sin copia (útil para estadísticas globales)
+        self.records = self._data[HEADER_DTYPE.itemsize:start].view(RECORD_DTYPE)
+        self._fires = None
+
+    def __len__(self):
+        return len(self.index)
+
+    def active_fires(self, time):
+        """Fuegos activos en el instante time (X, Y y FireId)."""
+        if self._fires is None:
+            is_fire = self.records["IsFire"] != 0
+            record_times = np.repeat(self.times, self.index["count"].astype(np.int64))
+            events = self.records[is_fire]
+            self._fires = _FireTimeline(record_times[is_fire], events["NodeId"],
+                                        events["IsFire"], events["X"], events["Y"])
+        return self._fires.active(time)
+
+    def frame(self, i):
+        """Registros del instante i-ésimo (vista del memmap)."""
+        entry = self.index[i]
+        begin = int(entry["offset"])
+        end = begin + int(entry["count"]) * RECORD_DTYPE.itemsize
+        return self._data[begin:end].view(RECORD_DTYPE)
+
+    def frame_at(self, time):
+        """Registros del primer instante >= time."""
+        return self.frame(int(np.searchsorted(self.times, time)))
+
+
+class CsvTrace:
+    """Traza CSV con la misma interfaz que BinaryTrace."""
+
+    def __init__(self, path):
+        import pandas as pd
+
+        df = pd.read_csv(path)
+        self.times = np.sort(df["Time"].unique())
+        self.records = df
+        # Un único agrupamiento en lugar de filtrar el DataFrame en cada instante
+        self._groups = df.groupby("Time").indices
+        self._df = df
+        events = df[df["IsFire"] != 0]
+        fire_ids = events["FireId"].to_numpy() if "FireId" in events else np.arange(len(events))
+        self._fires = _FireTimeline(events["Time"].to_numpy(), fire_ids,
+                                    events["IsFire"].to_numpy(), events["X"].to_numpy(),
+                                    events["Y"].to_numpy())
+
+    def __len__(self):
+        return len(self.times)
+
+    def active_fires(self, time):
+        """Fuegos activos en el instante time (X, Y y FireId)."""
+        return self._fires.active(time)
+
+    def frame(self, i):
+        return self._df.iloc[self._groups[self.times[i]]]
+
+    def frame_at(self, time):
+        return self.frame(int(np.searchsorted(self.times, time)))
+
+
+def open_trace(path):
+    """Abre una traza binaria o CSV según su contenido."""
+    with open(path, "rb") as f:
+        is_binary = f.read(len(MAGIC)) == MAGIC
+    return BinaryTrace(path) if is_binary else CsvTrace(path)
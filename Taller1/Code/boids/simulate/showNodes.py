@@ -1,19 +1,32 @@
-import pandas as pd
+import itertools
+import sys
+
 import matplotlib.pyplot as plt
 from matplotlib.animation import FuncAnimation
 import numpy as np
 from matplotlib.widgets import CheckButtons
 
-# Leer datos
-df = pd.read_csv("boids_positions.csv")
+from boids_telemetry import TelemetryReader
+from boids_trace import open_trace
+
+# Leer datos (CSV o traza binaria de --traceFormat=binary), o con --live <segmento>
+# seguir una simulación en curso (boids.cc --telemetry=<segmento>)
+live = len(sys.argv) > 2 and sys.argv[1] == "--live"
+if live:
+    telemetry = TelemetryReader(sys.argv[2])
+    x_min, x_max, y_min, y_max = -10, 1010, -10, 1010
+else:
+    trace = open_trace(sys.argv[1] if len(sys.argv) > 1 else "boids_positions.csv")
+    x_min, x_max = trace.records["X"].min() - 10, trace.records["X"].max() + 10
+    y_min, y_max = trace.records["Y"].min() - 10, trace.records["Y"].max() + 10
 
 # Configurar figura
 fig, ax = plt.subplots(figsize=(12, 8))
 plt.subplots_adjust(left=0.1, right=0.9, top=0.9, bottom=0.2)  # Espacio para controles
 
 # Establecer límites iniciales
-ax.set_xlim(df["X"].min() - 10, df["X"].max() + 10)
-ax.set_ylim(df["Y"].min() - 10, df["Y"].max() + 10)
+ax.set_xlim(x_min, x_max)
+ax.set_ylim(y_min, y_max)
 ax.set_title("Simulación Boids con Líderes y Fuegos")
 
 # Variables para controlar la visualización
@@ -36,24 +49,33 @@ check.on_clicked(toggle_visibility)
 
 # Animación
 def update(frame):
+    if live:
+        # Siempre la última trama publicada; si aún no hay ninguna se deja la figura
+        latest = telemetry.latest()
+        if latest is None:
+            return
+        boids, fires, time = latest["boids"], latest["fires"], latest["time"]
+    else:
+        # Solo se lee el bloque del instante, no todo el archivo
+        current_data = trace.frame(frame)
+        time = trace.times[frame]
+
+        # Los fuegos se guardan como eventos; se reconstruyen los activos en este instante
+        boids = current_data[current_data["IsFire"] == 0]
+        fires = trace.active_fires(time)
     ax.clear()
-    current_data = df[df["Time"] == frame]
-    
-    # Separar boids y fuegos
-    boids = current_data[current_data["IsFire"] == 0]
-    fires = current_data[current_data["IsFire"] == 1]
     
     # Dibujar boids (líderes y seguidores)
     ax.scatter(
         boids["X"],
         boids["Y"],
-        c=boids["IsLeader"].map({1: "red", 0: "blue"}),
+        c=np.where(boids["IsLeader"] == 1, "red", "blue"),
         s=50,
         alpha=0.7,
     )
     
     # Dibujar fuegos si está activado
-    if show_fires and not fires.empty:
+    if show_fires and len(fires["X"]) > 0:
         ax.scatter(
             fires["X"],
             fires["Y"],
@@ -67,24 +89,25 @@ def update(frame):
     # Dibujar áreas de influencia si está activado
     if show_leader_zones:
         leaders = boids[boids["IsLeader"] == 1]
-        for _, leader in leaders.iterrows():
-            circle = plt.Circle((leader["X"], leader["Y"]), 
+        for lx, ly in zip(leaders["X"], leaders["Y"]):
+            circle = plt.Circle((lx, ly), 
                              100, 
                              color="red", 
                              alpha=0.1)
             ax.add_patch(circle)
     
-    ax.set_title(f"Time: {frame:.2f}s")
-    ax.set_xlim(df["X"].min() - 10, df["X"].max() + 10)
-    ax.set_ylim(df["Y"].min() - 10, df["Y"].max() + 10)
+    ax.set_title(f"Time: {time:.2f}s")
+    ax.set_xlim(x_min, x_max)
+    ax.set_ylim(y_min, y_max)
     
     # Mostrar leyenda
     handles, labels = ax.get_legend_handles_labels()
     if handles:  # Solo mostrar leyenda si hay elementos
         ax.legend(handles, labels, loc='upper right')
 
-# Crear animación
-frames = sorted(df["Time"].unique())
-ani = FuncAnimation(fig, update, frames=frames, interval=100)  # Limitar a 100 frames para prueba
+# Crear animación (en vivo, sin fin ni caché de tramas)
+frames = itertools.count() if live else range(len(trace))
+ani = FuncAnimation(fig, update, frames=frames, interval=100,
+                    cache_frame_data=not live)  # Limitar a 100 frames para prueba
 
 plt.show()
\ No newline at end of file
@@ -0,0 +1,203 @@
+"""Barrido de configuraciones y réplicas de boids.cc en paralelo.
+
+Cada combinación de la rejilla de parámetros se ejecuta con varias réplicas
+(--run, subflujos independientes de RngSeedManager con la misma semilla). Como el
+Simulator de ns-3 es único por proceso, cada ejecución es un proceso aparte con su
+propio directorio de trabajo y sus propios archivos de salida; se lanzan tantos a
+la vez como núcleos haya.
+
+Al terminar se combinan los boids_summary.csv (y los boids_metrics.csv, con los
+cuantiles de latencia de extinción) de todas las ejecuciones en
+runs.csv (una fila por ejecución) y summary.csv (media, desviación estándar e
+intervalo de confianza por configuración).
+
+Ejemplo:
+    python sweep.py --program ../../build/scratch/ns3-dev-boids-default \\
+        --grid nFollowers=100,1000 --grid assignment=auction,greedy \\
+        --runs 50 --args="--mobilityOnly=1 --simTime=60" --out sweep_out
+"""
+
+import argparse
+import itertools
+import math
+import os
+import shlex
+import subprocess
+import sys
+import time
+from concurrent.futures import ThreadPoolExecutor, as_completed
+
+import pandas as pd
+
+# Cuantiles t de Student (dos colas) para 90, 95 y 99 %, por grados de libertad
+_T_TABLE = {
+    0.90: [6.314, 2.920, 2.353, 2.132, 2.015, 1.943, 1.895, 1.860, 1.833, 1.812,
+           1.796, 1.782, 1.771, 1.761, 1.753, 1.746, 1.740, 1.734, 1.729, 1.725,
+           1.721, 1.717, 1.714, 1.711, 1.708, 1.706, 1.703, 1.701, 1.699, 1.697],
+    0.95: [12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+           2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+           2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042],
+    0.99: [63.657, 9.925, 5.841, 4.604, 4.032, 3.707, 3.499, 3.355, 3.250, 3.169,
+           3.106, 3.055, 3.012, 2.977, 2.947, 2.921, 2.898, 2.878, 2.861, 2.845,
+           2.831, 2.819, 2.807, 2.797, 2.787, 2.779, 2.771, 2.763, 2.756, 2.750],
+}
+_Z = {0.90: 1.645, 0.95: 1.960, 0.99: 2.576}
+
+# Columnas del resumen que no son métricas
+_ID_COLUMNS = {"Seed", "Run", "SimTime"}
+
+
+def t_quantile(confidence, dof):
+    """Cuantil t para el intervalo de confianza (scipy si está disponible)."""
+    try:
+        from scipy import stats
+        return float(stats.t.ppf(0.5 + confidence / 2, dof))
+    except ImportError:
+        if confidence not in _T_TABLE:
+            raise ValueError("Sin scipy solo se admiten confianzas de 0.90, 0.95 y 0.99")
+        table = _T_TABLE[confidence]
+        return table[dof - 1] if dof <= len(table) else _Z[confidence]
+
+
+def parse_grid(items):
+    """["a=1,2", "b=x"] -> [{"a": "1", "b": "x"}, {"a": "2", "b": "x"}]"""
+    keys, values = [], []
+    for item in items:
+        key, _, value = item.partition("=")
+        if not key or not value:
+            raise SystemExit(f"--grid debe tener la forma nombre=v1,v2,...: {item}")
+        keys.append(key)
+        values.append(value.split(","))
+    return [dict(zip(keys, combo)) for combo in itertools.product(*values)]
+
+
+def parse_runs(text):
+    """"50" -> 1..50; "11-20" -> 11..20"""
+    if "-" in text:
+        first, last = text.split("-", 1)
+        return list(range(int(first), int(last) + 1))
+    return list(range(1, int(text) + 1))
+
+
+def config_name(config):
+    return "_".join(f"{k}-{v}" for k, v in config.items()) or "default"
+
+
+def run_one(program, base_args, config, seed, run, out_dir, keep_traces):
+    """Ejecuta boids.cc en su propio directorio y devuelve (config, run, resumen o error)."""
+    run_dir = os.path.join(out_dir, config_name(config), f"run{run}")
+    os.makedirs(run_dir, exist_ok=True)
+    positions = os.path.join(run_dir, "boids_positions.csv")
+    summary = os.path.join(run_dir, "boids_summary.csv")
+    metrics = os.path.join(run_dir, "boids_metrics.csv")
+    args = [program] + base_args + [f"--{k}={v}" for k, v in config.items()]
+    args += [f"--seed={seed}", f"--run={run}",
+             f"--positionsFile={os.path.abspath(positions)}",
+             f"--summaryFile={os.path.abspath(summary)}",
+             f"--metricsFile={os.path.abspath(metrics)}"]
+
+    start = time.monotonic()
+    with open(os.path.join(run_dir, "run.log"), "w") as log:
+        log.write(" ".join(shlex.quote(a) for a in args) + "\n")
+        log.flush()
+        # Los pcap y demás archivos con ruta fija caen en el directorio de la ejecución
+        result = subprocess.run(args, cwd=run_dir, stdout=log, stderr=subprocess.STDOUT)
+    elapsed = time.monotonic() - start
+
+    if not keep_traces and os.path.exists(positions):
+        os.remove(positions)
+    if result.returncode != 0 or not os.path.exists(summary):
+        return config, run, None, f"código {result.returncode}, ver {run_dir}/run.log"
+    row = pd.read_csv(summary).to_dict("records")[0]
+    if os.path.exists(metrics):
+        # Las columnas que ya están en el resumen (MaxLeaders) se quedan como allí
+        for key, value in pd.read_csv(metrics).to_dict("records")[0].items():
+            row.setdefault(key, value)
+    row["WallSeconds"] = elapsed
+    return config, run, row, None
+
+
+def aggregate(runs, config_keys, confidence):
+    """Media, desviación estándar e intervalo de confianza por configuración."""
+    metrics = [c for c in runs.columns
+               if c not in config_keys and c not in _ID_COLUMNS
+               and pd.api.types.is_numeric_dtype(runs[c])]
+    rows = []
+    groups = runs.groupby(config_keys, sort=False) if config_keys else [((), runs)]
+    for key, group in groups:
+        key = key if isinstance(key, tuple) else (key,)
+        row = dict(zip(config_keys, key))
+        n = len(group)
+        row["N"] = n
+        for metric in metrics:
+            mean = group[metric].mean()
+            std = group[metric].std(ddof=1) if n > 1 else float("nan")
+            half = t_quantile(confidence, n - 1) * std / math.sqrt(n) if n > 1 else float("nan")
+            row[f"{metric}Mean"] = mean
+            row[f"{metric}Std"] = std
+            row[f"{metric}CiLow"] = mean - half
+            row[f"{metric}CiHigh"] = mean + half
+        rows.append(row)
+    return pd.DataFrame(rows)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--program", required=True, help="ejecutable de boids.cc ya compilado")
+    parser.add_argument("--grid", action="append", default=[],
+                        help="parámetro de boids.cc y sus valores: nombre=v1,v2 (repetible)")
+    parser.add_argument("--runs", default="10", help="réplicas: N (1..N) o A-B")
+    parser.add_argument("--seed", type=int, default=1, help="semilla común")
+    parser.add_argument("--args", default="",
+                        help='argumentos fijos para todas las ejecuciones (--args="...")')
+    parser.add_argument("--jobs", type=int, default=os.cpu_count(), help="procesos a la vez")
+    parser.add_argument("--out", default="sweep_out", help="directorio de salida")
+    parser.add_argument("--confidence", type=float, default=0.95)
+    parser.add_argument("--keep-traces", action="store_true",
+                        help="conservar boids_positions.csv de cada ejecución")
+    options = parser.parse_args()
+
+    program = os.path.abspath(options.program)
+    base_args = shlex.split(options.args)
+    configs = parse_grid(options.grid)
+    runs = parse_runs(options.runs)
+    config_keys = list(configs[0].keys())
+    os.makedirs(options.out, exist_ok=True)
+
+    jobs = [(config, run) for config in configs for run in runs]
+    print(f"{len(jobs)} ejecuciones ({len(configs)} configuraciones x {len(runs)} réplicas) "
+          f"en {options.jobs} procesos", flush=True)
+
+    rows, failures = [], []
+    start = time.monotonic()
+    # Hilos que solo esperan a los subprocesos: el trabajo lo hacen los procesos de ns-3
+    with ThreadPoolExecutor(max_workers=options.jobs) as pool:
+        futures = [pool.submit(run_one, program, base_args, config, options.seed, run,
+                               options.out, options.keep_traces)
+                   for config, run in jobs]
+        for done, future in enumerate(as_completed(futures), 1):
+            config, run, row, error = future.result()
+            if error:
+                failures.append((config_name(config), run, error))
+            else:
+                rows.append({**config, **row})
+            print(f"\r{done}/{len(jobs)} ({time.monotonic() - start:.0f} s)", end="", flush=True)
+    print()
+
+    for name, run, error in failures:
+        print(f"Falló {name} run {run}: {error}", file=sys.stderr)
+    if not rows:
+        raise SystemExit("Ninguna ejecución terminó correctamente")
+
+    runs_table = pd.DataFrame(rows).sort_values(config_keys + ["Run"])
+    runs_table.to_csv(os.path.join(options.out, "runs.csv"), index=False)
+    summary = aggregate(runs_table, config_keys, options.confidence)
+    summary.to_csv(os.path.join(options.out, "summary.csv"), index=False)
+    print(f"{len(rows)} ejecuciones combinadas en {options.out}/runs.csv y {options.out}/summary.csv")
+    if failures:
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()